@@ -1,6 +1,6 @@
 QT += core gui widgets printsupport
 
-CONFIG += console
+CONFIG += console thread
 CONFIG -= app_bundle
 QMAKE_CXXFLAGS += -std=c++17
 
@@ -11,12 +11,50 @@ SOURCES += \
     src/Algorithms.cpp \
     src/GraphCanvas.cpp \
     src/MainWindow.cpp \
-    src/ChinesePostman.cpp
+    src/ChinesePostman.cpp \
+    src/MinWeightMatching.cpp \
+    src/ParallelExecutor.cpp \
+    src/LocationIO.cpp \
+    src/SolverStats.cpp \
+    src/DistanceTable.cpp \
+    src/ContractionHierarchy.cpp \
+    src/GoalDirectedSearch.cpp \
+    src/DenseGraph.cpp \
+    src/Components.cpp \
+    src/ChainContraction.cpp \
+    src/GraphPartitioner.cpp \
+    src/DistrictPostman.cpp \
+    src/MultiRoutePostman.cpp \
+    src/ShiftSplitter.cpp \
+    src/MinCostFlow.cpp \
+    src/MixedPostman.cpp \
+    src/RuralPostman.cpp
 
 HEADERS += \
     src/Algorithms.h \
     src/AnimationWindow.h \
     src/Graph.h \
+    src/AugmentedGraph.h \
     src/GraphCanvas.h \
     src/MainWindow.h \
-    src/ChinesePostman.h
+    src/ChinesePostman.h \
+    src/QtGraphAdapters.h \
+    src/MinWeightMatching.h \
+    src/ParallelExecutor.h \
+    src/LocationIO.h \
+    src/SolverStats.h \
+    src/ShortestPaths.h \
+    src/DistanceTable.h \
+    src/ContractionHierarchy.h \
+    src/GoalDirectedSearch.h \
+    src/DenseGraph.h \
+    src/Components.h \
+    src/ChainContraction.h \
+    src/GraphPartitioner.h \
+    src/DistrictPostman.h \
+    src/MultiRoutePostman.h \
+    src/ShiftSplitter.h \
+    src/MinCostFlow.h \
+    src/MixedPostman.h \
+    src/RuralPostman.h \
+    src/SolverContext.h
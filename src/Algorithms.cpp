@@ -1,35 +1,28 @@
 #include "Algorithms.h"
 #include "ChinesePostman.h"
+#include "MixedPostman.h"
 #include <queue>
 #include <limits>
 #include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
-#include <functional>
 
 using namespace std;
 
-// Initialize static storage
-namespace Algorithms::detail {
-    std::optional<EulerResult> lastEulerResult;
-    std::optional<EulerResult> lastPostmanResult;
-}
-
 namespace {
-struct EdgeUse { int id; bool used{false}; };
-
-bool isEulerianOrSemi(const Graph &g, bool &isCycle, int &startVertex) {
-    if (!g.isConnectedUndirected()) return false;
+bool isEulerianOrSemi(const CsrTopology &csr, const vector<int> &degree,
+                      bool &isCycle, int &startVertex, EulerScratch &scratch) {
+    if (!csr.isConnected(scratch.visited, scratch.bfsQueue)) return false;
     int oddCount = 0;
     startVertex = -1; // Khởi tạo với giá trị không hợp lệ
     
     // Tìm đỉnh bậc lẻ đầu tiên
-    for (const auto &v : g.getVertices()) {
-        int d = g.degree(v.id);
+    for (int v = 0; v < csr.vertexCount(); ++v) {
+        int d = degree[v];
         if (d % 2 == 1) {
             oddCount++;
             if (startVertex == -1) { // Chỉ gán đỉnh bậc lẻ đầu tiên
-                startVertex = v.id;
+                startVertex = v;
             }
         }
     }
@@ -37,9 +30,9 @@ bool isEulerianOrSemi(const Graph &g, bool &isCycle, int &startVertex) {
     if (oddCount == 0) { 
         // Eulerian cycle: có thể bắt đầu từ bất kỳ đỉnh nào có bậc > 0
         isCycle = true; 
-        for (const auto &v : g.getVertices()) {
-            if (g.degree(v.id) > 0) {
-                startVertex = v.id;
+        for (int v = 0; v < csr.vertexCount(); ++v) {
+            if (degree[v] > 0) {
+                startVertex = v;
                 break;
             }
         }
@@ -52,111 +45,244 @@ bool isEulerianOrSemi(const Graph &g, bool &isCycle, int &startVertex) {
     }
     return false;
 }
-}
 
-optional<EulerResult> Algorithms::findEulerTourHierholzer(const Graph &graph) {
-    bool isCycle = false; int start = -1;
-    if (!isEulerianOrSemi(graph, isCycle, start)) {
-        detail::lastEulerResult = nullopt;
-        return nullopt;
-    }
-    
-    // Kiểm tra start vertex hợp lệ
-    if (start == -1) {
-        detail::lastEulerResult = nullopt;
-        return nullopt;
-    }
+// Iterative Hierholzer over a CSR snapshot: explicit (vertex, arriving
+// edge) stack and a per-vertex cursor to the next incidence slot with
+// copies left, so every slot is looked at once → O(E + copies), no
+// recursion. scratch.copies[eid] is how many times edge eid must be
+// traversed (1 for a plain graph, the multiplicity for an augmented one).
+bool hierholzer(const CsrTopology &csr, EulerScratch &scratch, int start,
+                int traversals, vector<int> &path) {
+    auto &copies = scratch.copies;
+    auto &cursor = scratch.cursor;
+    auto &vertexStack = scratch.vertexStack;
+    auto &edgeStack = scratch.edgeStack;
+    cursor.assign(csr.offsets.begin(), csr.offsets.end() - 1);
+    vertexStack.clear();
+    edgeStack.clear();
+    vertexStack.reserve(traversals + 1);
+    edgeStack.reserve(traversals + 1);
+    path.clear();
+    path.reserve(traversals);
 
-    // Build adjacency list and edge usage tracking
-    unordered_map<int, vector<int>> adj = graph.adjacency();
-    vector<bool> edgeUsed(graph.getEdges().size(), false);
-    vector<int> path; // Final path as edge IDs
-    
-    // DFS function to find Euler path/cycle
-    function<void(int)> dfs = [&](int u) {
-        auto it = adj.find(u);
-        if (it == adj.end()) return;
-        
-        // Create a copy of edges to iterate through
-        vector<int> edges = it->second;
-        for (int eid : edges) {
-            if (!edgeUsed[eid]) {
-                edgeUsed[eid] = true;
-                const Edge &e = graph.getEdges()[eid];
-                int v = (e.u == u) ? e.v : e.u;
-                dfs(v);
-                path.push_back(eid);
-            }
+    vertexStack.push_back(start);
+    edgeStack.push_back(-1);
+    while (!vertexStack.empty()) {
+        int u = vertexStack.back();
+        int &c = cursor[u];
+        while (c < csr.end(u) && copies[csr.edgeIds[c]] == 0) ++c;
+        if (c == csr.end(u)) {
+            // u is exhausted: emit the edge we arrived by
+            if (edgeStack.back() != -1) path.push_back(edgeStack.back());
+            vertexStack.pop_back();
+            edgeStack.pop_back();
+        } else {
+            // Stay on this slot while the edge still has copies left
+            int eid = csr.edgeIds[c];
+            copies[eid]--;
+            vertexStack.push_back(csr.neighbors[c]);
+            edgeStack.push_back(eid);
         }
-    };
-    
-    // Start DFS from the starting vertex
-    dfs(start);
-    
+    }
+
     // Reverse to get correct order
     reverse(path.begin(), path.end());
-    
-    // Verify all edges are used exactly once
-    for (int i = 0; i < (int)graph.getEdges().size(); ++i) {
-        if (!edgeUsed[i]) {
-            return nullopt; // Some edges weren't used
-        }
+
+    // Each copy is taken at most once by construction; all must be used
+    return static_cast<int>(path.size()) == traversals;
+}
+
+// Every edge directed: the arcs are the edges themselves
+optional<EulerResult> directedEulerTour(SolverContext &ctx, const Graph &graph) {
+    const auto &edges = graph.getEdges();
+    vector<int> from(edges.size()), to(edges.size()), ids(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        from[i] = edges[i].u;
+        to[i] = edges[i].v;
+        ids[i] = static_cast<int>(i);
     }
-    
-    // Additional verification: check that each edge appears exactly once in path
-    vector<int> edgeCount(graph.getEdges().size(), 0);
-    for (int eid : path) {
-        edgeCount[eid]++;
-        if (edgeCount[eid] > 1) {
-            return nullopt; // Edge used more than once
+    EulerResult res;
+    if (!Algorithms::findEulerTourDirected(ctx, static_cast<int>(graph.getVertices().size()), from, to, ids,
+                                           res.edgeOrder, res.isCycle))
+        return nullopt;
+    return res;
+}
+}
+
+optional<EulerResult> Algorithms::findEulerTourHierholzer(SolverContext &ctx, const Graph &graph) {
+    return findEulerTourHierholzer(ctx, graph, graph.csr());
+}
+
+optional<EulerResult> Algorithms::findEulerTourHierholzer(SolverContext &ctx, const Graph &graph,
+                                                           const CsrTopology &csr) {
+    ctx.lastEuler = nullopt;
+    if (graph.hasDirectedEdges()) {
+        const auto &edges = graph.getEdges();
+        const bool allDirected = all_of(edges.begin(), edges.end(), [](const Edge &e) { return e.directed; });
+        optional<EulerResult> res;
+        if (allDirected) {
+            res = directedEulerTour(ctx, graph);
+        } else {
+            res.emplace();
+            res->isCycle = true;
+            if (!MixedPostman::eulerCircuit(ctx, graph, res->edgeOrder)) res.reset();
         }
+        ctx.lastEuler = res;
+        return res;
     }
+    vector<int> &degree = ctx.euler.degree;
+    degree.resize(csr.vertexCount());
+    for (int v = 0; v < csr.vertexCount(); ++v) degree[v] = csr.degree(v);
+
+    bool isCycle = false; int start = -1;
+    if (!isEulerianOrSemi(csr, degree, isCycle, start, ctx.euler)) return nullopt;
     
+    // Kiểm tra start vertex hợp lệ
+    if (start == -1) return nullopt;
+
+    const int edgeCount = static_cast<int>(graph.getEdges().size());
+    ctx.euler.copies.assign(edgeCount, 1);
+    vector<int> path; // Final path as edge IDs
+    if (!hierholzer(csr, ctx.euler, start, edgeCount, path)) {
+        return nullopt; // Some edges weren't used
+    }
+
     EulerResult res;
     res.edgeOrder = std::move(path);
     res.isCycle = isCycle;
     
-    detail::lastEulerResult = res;
-    return detail::lastEulerResult;
+    ctx.lastEuler = res;
+    return ctx.lastEuler;
 }
 
-vector<int> Algorithms::shortestPathVertices(const Graph &graph, int source, int target) {
-    const int n = (int)graph.getVertices().size();
-    vector<double> dist(n, numeric_limits<double>::infinity());
-    vector<int> parent(n, -1);
-    using QN = pair<double,int>;
-    priority_queue<QN, vector<QN>, greater<QN>> pq;
-    dist[source] = 0.0; pq.push({0.0, source});
-    unordered_map<int, vector<int>> v2e = graph.adjacency();
-
-    while (!pq.empty()) {
-        auto [d, u] = pq.top(); pq.pop();
-        if (d != dist[u]) continue;
-        if (u == target) break;
-        auto it = v2e.find(u);
-        if (it == v2e.end()) continue;
-        for (int eid : it->second) {
-            const Edge &e = graph.getEdges()[eid];
-            int w = (e.u == u ? e.v : e.u);
-            double nd = d + e.weight;
-            if (nd < dist[w]) { dist[w] = nd; parent[w] = u; pq.push({nd, w}); }
+optional<EulerResult> Algorithms::findEulerTourHierholzer(SolverContext &ctx, const AugmentedGraph &graph,
+                                                           const CsrTopology &baseCsr) {
+    EulerResult res;
+    if (!findEulerTourHierholzer(ctx, graph, baseCsr, res.edgeOrder, res.isCycle))
+        return nullopt;
+    return res;
+}
+
+bool Algorithms::findEulerTourHierholzer(SolverContext &ctx, const AugmentedGraph &graph,
+                                         const CsrTopology &baseCsr,
+                                         vector<int> &edgeOrder, bool &isCycle) {
+    const auto &edges = graph.base().getEdges();
+    vector<int> &degree = ctx.euler.degree;
+    degree.resize(baseCsr.vertexCount());
+    for (int v = 0; v < baseCsr.vertexCount(); ++v) degree[v] = baseCsr.degree(v);
+    for (int eid : graph.duplicatedEdges()) {
+        degree[edges[eid].u] += graph.extraCopies(eid);
+        degree[edges[eid].v] += graph.extraCopies(eid);
+    }
+
+    int start = -1;
+    isCycle = false;
+    edgeOrder.clear();
+    if (!isEulerianOrSemi(baseCsr, degree, isCycle, start, ctx.euler) || start == -1)
+        return false;
+
+    auto &copies = ctx.euler.copies;
+    copies.assign(edges.size(), 1);
+    for (int eid : graph.duplicatedEdges()) copies[eid] += graph.extraCopies(eid);
+    return hierholzer(baseCsr, ctx.euler, start, graph.traversalCount(), edgeOrder);
+}
+
+bool Algorithms::findEulerTourDirected(SolverContext &ctx, int vertexCount, const vector<int> &arcFrom,
+                                       const vector<int> &arcTo, const vector<int> &arcEdge,
+                                       vector<int> &edgeOrder, bool &isCycle) {
+    EulerScratch &scratch = ctx.euler;
+    const int arcs = static_cast<int>(arcFrom.size());
+    edgeOrder.clear();
+    isCycle = false;
+    if (arcs == 0) return false;
+
+    // --- B1. out − in của mỗi đỉnh, CSR các cung theo đỉnh đầu ---
+    vector<int> &surplus = scratch.degree;
+    vector<int> &offsets = scratch.arcOffsets;
+    surplus.assign(vertexCount, 0);
+    offsets.assign(vertexCount + 1, 0);
+    for (int a = 0; a < arcs; ++a) {
+        ++surplus[arcFrom[a]];
+        --surplus[arcTo[a]];
+        ++offsets[arcFrom[a] + 1];
+    }
+    int start = arcFrom[0], starts = 0, ends = 0;
+    for (int v = 0; v < vertexCount; ++v) {
+        if (surplus[v] == 1) { start = v; ++starts; }
+        else if (surplus[v] == -1) ++ends;
+        else if (surplus[v] != 0) return false;
+    }
+    if (starts > 1 || ends != starts) return false;
+    isCycle = starts == 0;
+    for (int v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    vector<int> &slots = scratch.arcSlots;
+    vector<int> &cursor = scratch.cursor;
+    slots.resize(arcs);
+    cursor.assign(offsets.begin(), offsets.end() - 1);
+    for (int a = 0; a < arcs; ++a) slots[cursor[arcFrom[a]]++] = a;
+
+    // --- B2. Hierholzer lặp: mỗi cung được xét đúng một lần ---
+    cursor.assign(offsets.begin(), offsets.end() - 1);
+    auto &vertexStack = scratch.vertexStack;
+    auto &edgeStack = scratch.edgeStack;
+    vertexStack.assign(1, start);
+    edgeStack.assign(1, -1);
+    edgeOrder.reserve(arcs);
+    while (!vertexStack.empty()) {
+        const int u = vertexStack.back();
+        int &c = cursor[u];
+        if (c == offsets[u + 1]) {
+            if (edgeStack.back() != -1) edgeOrder.push_back(edgeStack.back());
+            vertexStack.pop_back();
+            edgeStack.pop_back();
+        } else {
+            const int a = slots[c++];
+            vertexStack.push_back(arcTo[a]);
+            edgeStack.push_back(arcEdge[a]);
         }
     }
-    vector<int> path;
-    if (parent[target] == -1 && source != target) return path;
-    for (int v = target; v != -1; v = parent[v]) path.push_back(v);
-    reverse(path.begin(), path.end());
-    return path;
+    reverse(edgeOrder.begin(), edgeOrder.end());
+
+    // Arcs out of reach of the start were never walked
+    if (static_cast<int>(edgeOrder.size()) != arcs) {
+        edgeOrder.clear();
+        return false;
+    }
+    return true;
 }
 
-optional<EulerResult> Algorithms::approximateChinesePostman(const Graph &graph) {
+vector<int> Algorithms::shortestPathVertices(const Graph &graph, int source, int target) {
+    // One-off query; callers with many queries keep a GoalDirectedSearch
+    GoalDirectedSearch search(graph);
+    return search.pathVertices(source, target, SearchMode::AStar);
+}
+
+vector<int> Algorithms::shortestPathVertices(const Graph &graph, const LandmarkTable &landmarks,
+                                             int source, int target) {
+    GoalDirectedSearch search(graph, &landmarks);
+    return search.pathVertices(source, target, SearchMode::Landmarks);
+}
+
+vector<int> Algorithms::shortestPathVertices(const Graph &graph, const ContractionHierarchy &hierarchy,
+                                             int source, int target) {
+    vector<int> vertices;
+    HierarchyScratch scratch;
+    vector<int> edgeIds;
+    if (!hierarchy.path(source, target, scratch, edgeIds)) return vertices;
+    const auto &edges = graph.getEdges();
+    vertices.push_back(source);
+    for (int eid : edgeIds) {
+        int v = vertices.back();
+        vertices.push_back(edges[eid].u == v ? edges[eid].v : edges[eid].u);
+    }
+    return vertices;
+}
+
+optional<EulerResult> Algorithms::approximateChinesePostman(SolverContext &ctx, const Graph &graph) {
     // Sử dụng thuật toán Chinese Postman tối ưu
-    ChinesePostmanResult cppResult = ChinesePostmanOptimal::solve(graph);
+    ChinesePostmanResult cppResult = ChinesePostmanOptimal::solve(ctx, graph);
     
-    if (cppResult.edgeOrder.empty()) {
-        detail::lastPostmanResult = nullopt;
-        return nullopt;
-    }
+    if (cppResult.edgeOrder.empty()) return nullopt;
     
     // Chuyển đổi kết quả Chinese Postman thành EulerResult
     EulerResult result;
@@ -166,17 +292,46 @@ optional<EulerResult> Algorithms::approximateChinesePostman(const Graph &graph)
     // Tạo vertex order từ edge order
     result.vertexOrder = getVertexSequence(graph, result.edgeOrder);
     
-    detail::lastPostmanResult = result;
+    ctx.lastPostman = result;
     return result;
 }
 
+int Algorithms::walkStart(const vector<Edge>& edges, const vector<int>& edgeOrder) {
+    if (edgeOrder.empty()) return -1;
+    const int edgeCount = static_cast<int>(edges.size());
+    if (edgeOrder[0] < 0 || edgeOrder[0] >= edgeCount) return -1;
+    const Edge &e0 = edges[edgeOrder[0]];
+    int open = -1;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        // A one-way street is entered at u only; a loop has one end
+        if (attempt == 1 && (e0.directed || e0.u == e0.v)) break;
+        const int start = attempt == 0 ? e0.u : e0.v;
+        int curr = start;
+        bool ok = true;
+        for (int eid : edgeOrder) {
+            if (eid < 0 || eid >= edgeCount) { ok = false; break; }
+            const Edge &e = edges[eid];
+            if (e.u == curr) curr = e.v;
+            else if (e.v == curr && !e.directed) curr = e.u;
+            else { ok = false; break; }
+        }
+        if (!ok) continue;
+        if (curr == start) return start;
+        if (open < 0) open = start;
+    }
+    return open;
+}
+
 vector<int> Algorithms::getVertexSequence(const Graph& graph, const vector<int>& edgeOrder) {
     vector<int> vertexOrder;
     if (edgeOrder.empty()) return vertexOrder;
     
-    // Tìm đỉnh bắt đầu từ cạnh đầu tiên
-    const Edge &e0 = graph.getEdges()[edgeOrder[0]];
-    int curr = e0.u;
+    // Tìm đỉnh bắt đầu: đầu mút của cạnh đầu tiên từ đó cả dãy cạnh là một đường đi
+    int curr = walkStart(graph.getEdges(), edgeOrder);
+    if (curr < 0) {
+        if (edgeOrder[0] < 0 || edgeOrder[0] >= static_cast<int>(graph.getEdges().size())) return vertexOrder;
+        curr = graph.getEdges()[edgeOrder[0]].u;
+    }
     vertexOrder.push_back(curr);
     
     // Duyệt qua các cạnh để tạo thứ tự đỉnh
@@ -192,15 +347,22 @@ vector<int> Algorithms::getVertexSequence(const Graph& graph, const vector<int>&
     return vertexOrder;
 }
 
-optional<EulerResult> Algorithms::getEulerSummary() {
-    return detail::lastEulerResult;
+optional<EulerResult> Algorithms::getEulerSummary(const SolverContext &ctx) {
+    return ctx.lastEuler;
+}
+
+optional<EulerResult> Algorithms::getPostmanSummary(const SolverContext &ctx) {
+    return ctx.lastPostman;
+}
+
+void Algorithms::clearResults(SolverContext &ctx) {
+    ctx.clearResults();
 }
 
-optional<EulerResult> Algorithms::getPostmanSummary() {
-    return detail::lastPostmanResult;
+const vector<int>& Algorithms::getHighlightedEdges(const SolverContext &ctx) {
+    return ctx.highlightedEdges;
 }
 
-void Algorithms::clearResults() {
-    detail::lastEulerResult = nullopt;
-    detail::lastPostmanResult = nullopt;
+void Algorithms::clearHighlights(SolverContext &ctx) {
+    ctx.highlightedEdges.clear();
 }
@@ -1,42 +1,72 @@
 #pragma once
 
 #include "Graph.h"
+#include "AugmentedGraph.h"
+#include "GoalDirectedSearch.h"
+#include "SolverContext.h"
 #include <vector>
 #include <optional>
 
-struct EulerResult {
-    std::vector<int> edgeOrder;
-    bool isCycle{false};
-    std::vector<int> vertexOrder;  // Thm ?? l?u th? t? ??nh
-};
-
 namespace Algorithms {
 
-namespace detail {
-    extern std::optional<EulerResult> lastEulerResult;
-    extern std::optional<EulerResult> lastPostmanResult;
-    extern std::vector<int> highlightedEdges;  // L?u cc c?nh ???c t mu
-}
+// Returns nullopt if no Euler path/cycle exists; the result is also
+// kept in ctx.lastEuler. Directed edges are driven u → v only: with
+// every edge directed this is findEulerTourDirected, with a mix of
+// both only circuits are found (MixedPostman::eulerCircuit).
+std::optional<EulerResult> findEulerTourHierholzer(SolverContext &ctx, const Graph &graph);
+// Same, reusing a CSR snapshot the caller already built for `graph`
+std::optional<EulerResult> findEulerTourHierholzer(SolverContext &ctx, const Graph &graph, const CsrTopology &csr);
+// Tour over base graph + duplicates; every traversal is a base edge id,
+// so an edge with multiplicity k appears k times in edgeOrder. This is
+// the postman's last step and leaves ctx.lastEuler untouched.
+std::optional<EulerResult> findEulerTourHierholzer(SolverContext &ctx, const AugmentedGraph &graph,
+                                                   const CsrTopology &baseCsr);
+// Same, writing into caller-owned storage (capacity reused); false if
+// there is no tour
+bool findEulerTourHierholzer(SolverContext &ctx, const AugmentedGraph &graph, const CsrTopology &baseCsr,
+                             std::vector<int> &edgeOrder, bool &isCycle);
 
-// Returns nullopt if no Euler path/cycle exists
-std::optional<EulerResult> findEulerTourHierholzer(const Graph &graph);
+// Directed tour over arcs: arc i goes arcFrom[i] → arcTo[i] and is a
+// traversal of edge arcEdge[i]. A circuit when every vertex has as many
+// arcs in as out, a path when one vertex has one more out and one has
+// one more in; false otherwise or when the arcs are not connected.
+// Leaves ctx.lastEuler untouched.
+bool findEulerTourDirected(SolverContext &ctx, int vertexCount, const std::vector<int> &arcFrom,
+                           const std::vector<int> &arcTo, const std::vector<int> &arcEdge,
+                           std::vector<int> &edgeOrder, bool &isCycle);
 
-// For Chinese Postman
-std::optional<EulerResult> approximateChinesePostman(const Graph &graph);
+// For Chinese Postman (result kept in ctx.lastPostman)
+std::optional<EulerResult> approximateChinesePostman(SolverContext &ctx, const Graph &graph);
 
-// Utility shortest path
+// Utility shortest path (vertices source..target, empty if unreachable),
+// an A* search guided by the vertex positions. For batches of queries
+// use DistanceTableEngine (DistanceTable.h) or GoalDirectedSearch.
 std::vector<int> shortestPathVertices(const Graph &graph, int source, int target);
+// Same, ALT search with the location's landmark table (plain A* when
+// the table does not match the graph)
+std::vector<int> shortestPathVertices(const Graph &graph, const LandmarkTable &landmarks,
+                                      int source, int target);
+// Same through a hierarchy built from `graph` (checked once by the
+// caller with hierarchy.matches(graph), not on every query)
+std::vector<int> shortestPathVertices(const Graph &graph, const ContractionHierarchy &hierarchy,
+                                      int source, int target);
 
 // Summary access
-std::optional<EulerResult> getEulerSummary();
-std::optional<EulerResult> getPostmanSummary();
-void clearResults();
+std::optional<EulerResult> getEulerSummary(const SolverContext &ctx);
+std::optional<EulerResult> getPostmanSummary(const SolverContext &ctx);
+void clearResults(SolverContext &ctx);
 
 // Highlight management
-const std::vector<int>& getHighlightedEdges();
-void clearHighlights();
+const std::vector<int>& getHighlightedEdges(const SolverContext &ctx);
+void clearHighlights(SolverContext &ctx);
 
 // Vertex sequence helpers
+// Start of a walk given as edge ids: the end of the first edge from
+// which every later edge continues the walk (one-way streets u → v
+// only), a closed walk preferred; -1 if neither end gives a walk.
+// Both ends are tried since the first edges alone can be ambiguous
+// (parallel streets, the same street twice).
+int walkStart(const std::vector<Edge>& edges, const std::vector<int>& edgeOrder);
 std::vector<int> getVertexSequence(const Graph& graph, const std::vector<int>& edgeOrder);
 }
 
@@ -5,6 +5,7 @@
 #include <QPainter>
 #include <set>
 #include "Graph.h"
+#include "QtGraphAdapters.h"
 #include <unordered_map>
 #include <algorithm> // Để dùng std::min, std::max
 
@@ -18,31 +19,26 @@ public:
                              QWidget *parent = nullptr)
         : QDialog(parent),
         graph(g),
-        route(route),
+        routes{route},
         isPostman(isPostman),
         duplicateEdgeIds(dupIds)
     {
-        // --- Cấu hình cửa sổ ---
         setWindowTitle(isPostman ? "Chinese Postman Animation" : "Euler Path Animation");
-        resize(800, 600);
-        frame = QImage(size(), QImage::Format_ARGB32_Premultiplied);
-
-        // --- Sửa lỗi ID cho bài toán Postman ---
-        if (isPostman) {
-            int originalEdgeCount = static_cast<int>(graph.getEdges().size());
-            for (size_t i = 0; i < duplicateEdgeIds.size(); ++i) {
-                int augmentedId = originalEdgeCount + static_cast<int>(i);
-                int originalId = duplicateEdgeIds[i];
-                augmentedToOriginalIdMap[augmentedId] = originalId;
-            }
-        }
+        start();
+    }
 
-        // --- Kết nối timer ---
-        connect(&timer, &QTimer::timeout, this, &AnimationWindow::nextStep);
-        timer.start(550);
-        
-        // Vẽ trạng thái ban đầu
-        drawFrame();
+    // Several patrol routes driven side by side, one colour each
+    AnimationWindow(const Graph &g,
+                    const std::vector<std::vector<int>> &routes,
+                    QWidget *parent = nullptr)
+        : QDialog(parent),
+        graph(g),
+        routes(routes),
+        isPostman(true),
+        multiRoute(true)
+    {
+        setWindowTitle(QString("Patrol Routes Animation (%1 units)").arg(routes.size()));
+        start();
     }
 
 protected:
@@ -63,7 +59,7 @@ private slots:
         drawFrame();
         update();
 
-        if (currentStep >= static_cast<int>(route.size())) {
+        if (currentStep >= longestRoute()) {
             timer.stop();
             return;
         }
@@ -84,10 +80,10 @@ private slots:
         // ===================================================================
         
         // --- B1: Tìm khung bao (bounding box) của đồ thị ---
-        qreal minX = verts[0].position.x(), maxX = minX, minY = verts[0].position.y(), maxY = minY;
+        qreal minX = verts[0].position.x, maxX = minX, minY = verts[0].position.y, maxY = minY;
         for (const auto &v : verts) {
-            minX = std::min(minX, v.position.x()); maxX = std::max(maxX, v.position.x());
-            minY = std::min(minY, v.position.y()); maxY = std::max(maxY, v.position.y());
+            minX = std::min(minX, v.position.x); maxX = std::max(maxX, v.position.x);
+            minY = std::min(minY, v.position.y); maxY = std::max(maxY, v.position.y);
         }
         QRectF graphBounds(minX, minY, maxX - minX, maxY - minY);
 
@@ -110,52 +106,58 @@ private slots:
         // Từ giờ, tất cả các lệnh vẽ sẽ được thực hiện trong hệ tọa độ đã được biến đổi.
         // Điều này tiện lợi hơn nhiều so với việc cộng `offset` vào từng tọa độ.
 
-        // --- Định nghĩa các loại bút vẽ (với độ dày được điều chỉnh theo tỷ lệ) ---
         qreal baseWidth = 2.0 / scaleFactor;
         QPen greyPen(QColor(200, 200, 200), baseWidth);
-        QPen bluePen(QColor(0, 120, 255), baseWidth * 2);
-        QPen redPen(QColor(255, 0, 0), baseWidth * 2);
-        redPen.setStyle(Qt::DashDotLine);
-        QPen thickBluePen(QColor(0, 120, 255), baseWidth * 3.5);
-        QPen thickRedPen(QColor(255, 0, 0), baseWidth * 3.5);
-        thickRedPen.setStyle(Qt::DashDotLine);
 
         // --- Vẽ tất cả các cạnh làm nền ---
         painter.setPen(greyPen);
         for (const auto &e : edges) {
-            painter.drawLine(verts[e.u].position, verts[e.v].position);
+            painter.drawLine(toQPointF(verts[e.u].position), toQPointF(verts[e.v].position));
         }
 
-        // --- Logic vẽ đè màu theo thứ tự (giữ nguyên) ---
-        std::unordered_map<int, int> edgeUsageCount;
-        for (int i = 0; i < currentStep; ++i) {
-            int augmentedId = route[i];
-            int originalId = augmentedToOriginalIdMap.count(augmentedId) ? augmentedToOriginalIdMap.at(augmentedId) : augmentedId;
-            if (originalId >= 0 && static_cast<size_t>(originalId) < edges.size()) {
-                edgeUsageCount[originalId]++;
+        // --- Vẽ đè màu theo thứ tự, từng tuyến ---
+        // One route: blue, repeats red. Several: one colour per route,
+        // repeats dashed in the same colour.
+        for (size_t r = 0; r < routes.size(); ++r) {
+            const std::vector<int> &route = routes[r];
+            const QColor color = multiRoute ? routeColor(static_cast<int>(r)) : QColor(0, 120, 255);
+            const QColor repeatColor = multiRoute ? color : QColor(255, 0, 0);
+            QPen bluePen(color, baseWidth * 2);
+            QPen redPen(repeatColor, baseWidth * 2);
+            redPen.setStyle(Qt::DashDotLine);
+            QPen thickBluePen(color, baseWidth * 3.5);
+            QPen thickRedPen(repeatColor, baseWidth * 3.5);
+            thickRedPen.setStyle(Qt::DashDotLine);
+
+            std::unordered_map<int, int> edgeUsageCount;
+            const int shown = std::min(currentStep, static_cast<int>(route.size()));
+            for (int i = 0; i < shown; ++i) {
+                int originalId = route[i];  // route đã dùng ID cạnh gốc
+                if (originalId >= 0 && static_cast<size_t>(originalId) < edges.size()) {
+                    edgeUsageCount[originalId]++;
+                }
             }
-        }
-        
-        for (const auto& pair : edgeUsageCount) {
-            int eid = pair.first;
-            int count = pair.second;
-            const auto& e = edges[eid];
-            painter.setPen(bluePen);
-            painter.drawLine(verts[e.u].position, verts[e.v].position);
-            if (count > 1) {
-                painter.setPen(redPen);
-                painter.drawLine(verts[e.u].position, verts[e.v].position);
+
+            for (const auto& pair : edgeUsageCount) {
+                int eid = pair.first;
+                int count = pair.second;
+                const auto& e = edges[eid];
+                painter.setPen(bluePen);
+                painter.drawLine(toQPointF(verts[e.u].position), toQPointF(verts[e.v].position));
+                if (count > 1) {
+                    painter.setPen(redPen);
+                    painter.drawLine(toQPointF(verts[e.u].position), toQPointF(verts[e.v].position));
+                }
             }
-        }
-        
-        // --- Vẽ tô đậm cạnh hiện tại (giữ nguyên) ---
-        if (currentStep < static_cast<int>(route.size())) {
-            int augmentedId = route[currentStep];
-            int originalId = augmentedToOriginalIdMap.count(augmentedId) ? augmentedToOriginalIdMap.at(augmentedId) : augmentedId;
-            if (originalId >= 0 && static_cast<size_t>(originalId) < edges.size()) {
-                const auto& e = edges[originalId];
-                painter.setPen(edgeUsageCount.count(originalId) ? thickRedPen : thickBluePen);
-                painter.drawLine(verts[e.u].position, verts[e.v].position);
+
+            // --- Vẽ tô đậm cạnh hiện tại ---
+            if (currentStep < static_cast<int>(route.size())) {
+                int originalId = route[currentStep];
+                if (originalId >= 0 && static_cast<size_t>(originalId) < edges.size()) {
+                    const auto& e = edges[originalId];
+                    painter.setPen(edgeUsageCount.count(originalId) ? thickRedPen : thickBluePen);
+                    painter.drawLine(toQPointF(verts[e.u].position), toQPointF(verts[e.v].position));
+                }
             }
         }
 
@@ -168,8 +170,8 @@ private slots:
         painter.setFont(f);
         
         for (const auto &v : verts) {
-            painter.drawEllipse(v.position, vertexRadius, vertexRadius);
-            painter.drawText(v.position + QPointF(-5 / scaleFactor, -15 / scaleFactor), v.name);
+            painter.drawEllipse(toQPointF(v.position), vertexRadius, vertexRadius);
+            painter.drawText(toQPointF(v.position) + QPointF(-5 / scaleFactor, -15 / scaleFactor), toQString(v.name));
         }
         
         painter.restore(); // Khôi phục lại trạng thái painter
@@ -177,11 +179,30 @@ private slots:
 
 private:
     Graph graph;
-    std::vector<int> route;
+    std::vector<std::vector<int>> routes;
     bool isPostman;
+    bool multiRoute{false};
     std::vector<int> duplicateEdgeIds; 
     QImage frame;
     QTimer timer;
     int currentStep{0};
-    std::unordered_map<int, int> augmentedToOriginalIdMap;
+
+    void start() {
+        // --- Cấu hình cửa sổ ---
+        resize(800, 600);
+        frame = QImage(size(), QImage::Format_ARGB32_Premultiplied);
+
+        // --- Kết nối timer ---
+        connect(&timer, &QTimer::timeout, this, &AnimationWindow::nextStep);
+        timer.start(550);
+
+        // Vẽ trạng thái ban đầu
+        drawFrame();
+    }
+
+    int longestRoute() const {
+        size_t longest = 0;
+        for (const auto &route : routes) longest = std::max(longest, route.size());
+        return static_cast<int>(longest);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+#include "Graph.h"
+#include <vector>
+
+// -----------------------------
+// AUGMENTED GRAPH OVERLAY
+// -----------------------------
+// "Base graph + extra traversals" without copying the base: each edge
+// keeps a multiplicity (1 + number of duplicates). Adding a duplicate is
+// O(1) and reset() only clears the edges that were duplicated, so an
+// overlay kept in a SolverContext is reused without reallocating. The
+// Euler engine walks the base CSR and consumes multiplicities, so every
+// tour is expressed in the base graph's edge ids.
+class AugmentedGraph {
+private:
+    const Graph *g{nullptr};
+    std::vector<int> extra;    // edge id -> duplicate count
+    std::vector<int> touched;  // edge ids with extra > 0, first-duplicated order
+    int duplicateTotal{0};
+
+public:
+    AugmentedGraph() = default;
+    explicit AugmentedGraph(const Graph &base) { reset(base); }
+
+    // Points the overlay at `base` and drops every duplicate
+    void reset(const Graph &base) {
+        g = &base;
+        const size_t edgeCount = base.getEdges().size();
+        if (extra.size() == edgeCount) {
+            for (int eid : touched) extra[eid] = 0;
+        } else {
+            extra.assign(edgeCount, 0);
+        }
+        touched.clear();
+        duplicateTotal = 0;
+    }
+
+    const Graph& base() const { return *g; }
+
+    void duplicate(int edgeId, int copies = 1) {
+        if (extra[edgeId] == 0) touched.push_back(edgeId);
+        extra[edgeId] += copies;
+        duplicateTotal += copies;
+    }
+
+    int extraCopies(int edgeId) const {
+        return edgeId >= 0 && edgeId < static_cast<int>(extra.size()) ? extra[edgeId] : 0;
+    }
+
+    int multiplicity(int edgeId) const { return 1 + extraCopies(edgeId); }
+
+    // Ids of the edges with at least one duplicate
+    const std::vector<int>& duplicatedEdges() const { return touched; }
+    int duplicateCount() const { return duplicateTotal; }
+    int traversalCount() const {
+        return static_cast<int>(g->getEdges().size()) + duplicateTotal;
+    }
+};
@@ -0,0 +1,418 @@
+#include "ChinesePostman.h"
+#include "Components.h"
+#include "ContractionHierarchy.h"
+#include "DistrictPostman.h"
+#include "GoalDirectedSearch.h"
+#include "Graph.h"
+#include "LocationIO.h"
+#include "MultiRoutePostman.h"
+#include "ParallelExecutor.h"
+#include "ShiftSplitter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* ============================================================
+   TrafficPatrolBatch — headless route generation
+   ------------------------------------------------------------
+   Usage: TrafficPatrolBatch [-j N] [-o DIR] [--summary FILE]
+                             [--trace DIR] [--hierarchy] [--landmarks]
+                             [--chains] [--districts K]
+                             [--units K] [--shift-length L]
+                             [--depot V]
+                             <location dir | pattern>...
+
+   Every location folder (coords.txt + matrix.txt) is loaded and
+   solved independently on a worker pool; background images are
+   never decoded. One route file is written per location and a
+   CSV timing summary is printed (or written to --summary), with
+   the per-phase solver stats; --trace also writes one Chrome
+   trace per location. With --hierarchy the odd-vertex distances
+   come from the location's hierarchy.ch, which is built and
+   saved first when it is missing or stale. --landmarks does the
+   same for landmarks.alt, the ALT distance table used by point-
+   to-point queries (GoalDirectedSearch). --chains solves with
+   degree-2 chains contracted (ChainContraction). --districts
+   splits each connected location into K districts (0 = one per
+   20000 streets) solved by DistrictPostman, and reports the
+   optimality gap against its lower bound. --units splits the
+   streets of each connected location between K patrol units
+   leaving from station vertex V (MultiRoutePostman): one route
+   per unit, the longest as short as possible. --shift-length
+   then cuts every route into shifts of cost at most L that leave
+   from and return to V (ShiftSplitter); the shifts replace the
+   route in the route file. Locations with one-way streets fail
+   with --districts, --units and --shift-length. A location made of
+   several disjoint sectors gets one route per sector (solved
+   concurrently when the location has the pool to itself, i.e.
+   is the only one given), all written to the same route file. A
+   location with a required.txt only covers the streets listed
+   there (RuralPostman), in every mode, and counts as connected
+   when those streets are: --districts then solves it as one
+   district, and --units and --shift-length split the rural tour
+   (a station cut off from them gets no route). Sectors without a
+   required street get no route, and one with both one-way and
+   optional streets fails (the one-way postman has no optional
+   streets).
+   ============================================================ */
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct BatchOptions {
+    unsigned threads{0};
+    fs::path outputDir;
+    fs::path summaryFile;
+    fs::path traceDir;
+    bool hierarchy{false};
+    bool landmarks{false};
+    bool chains{false};
+    int districts{-1};   // -1 = exact solve
+    int units{0};        // 0 = one route per sector
+    int depot{0};
+    double shiftLength{0.0};   // 0 = routes are not cut into shifts
+    std::vector<std::string> inputs;
+    // Per solve: 1 while locations run concurrently, the whole pool
+    // (threads) for a single location
+    unsigned solveThreads{1};
+};
+
+struct LocationJob {
+    fs::path dir;
+    int vertices{0};
+    int edges{0};
+    int components{0};
+    int districts{0};
+    int units{0};
+    double gap{0.0};           // District / MultiRoutePostman cost / lower bound - 1
+    double longest{0.0};       // longest patrol route (--units)
+    int shifts{0};
+    int duplicates{0};
+    double cost{0.0};
+    double loadMs{0.0};
+    double hierarchyMs{0.0};   // load, or build + save, of hierarchy.ch
+    double landmarksMs{0.0};   // same for landmarks.alt
+    double solveMs{0.0};
+    SolverStats stats;
+    std::string status;
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void printUsage() {
+    std::cerr << "Usage: TrafficPatrolBatch [-j N] [-o DIR] [--summary FILE] [--trace DIR] [--hierarchy]\n"
+                 "                          [--landmarks] [--chains] [--districts K] [--units K]\n"
+                 "                          [--shift-length L] [--depot V]\n"
+                 "                          <location>...\n"
+                 "  <location>      location folder, or a pattern such as locations/*\n"
+                 "  -j N            worker threads (default: all cores)\n"
+                 "  -o DIR          write <location>.route.txt into DIR\n"
+                 "                  (default: route.txt inside each location)\n"
+                 "  --summary FILE  write the CSV summary to FILE instead of stdout\n"
+                 "  --trace DIR     write <location>.trace.json (Chrome trace) into DIR\n"
+                 "  --hierarchy     use <location>/hierarchy.ch, building it when missing or stale\n"
+                 "  --landmarks     build <location>/landmarks.alt when missing or stale\n"
+                 "  --chains        contract degree-2 chains before solving\n"
+                 "  --districts K   solve by K districts (0 = one per 20000 streets)\n"
+                 "  --units K       split the streets between K patrol units (min-max routes)\n"
+                 "  --shift-length L  cut every route into station-to-station shifts of cost <= L\n"
+                 "  --depot V       station vertex of the units and shifts (default 0)\n";
+}
+
+bool parseArgs(int argc, char *argv[], BatchOptions &opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "-j" || arg == "-o" || arg == "--summary" || arg == "--trace" || arg == "--districts"
+             || arg == "--units" || arg == "--depot" || arg == "--shift-length")
+            && i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        if (arg == "-h" || arg == "--help") return false;
+        else if (arg == "-j") opt.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "-o") opt.outputDir = argv[++i];
+        else if (arg == "--summary") opt.summaryFile = argv[++i];
+        else if (arg == "--trace") opt.traceDir = argv[++i];
+        else if (arg == "--hierarchy") opt.hierarchy = true;
+        else if (arg == "--landmarks") opt.landmarks = true;
+        else if (arg == "--chains") opt.chains = true;
+        else if (arg == "--districts") opt.districts = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--units") opt.units = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--depot") opt.depot = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--shift-length") opt.shiftLength = std::max(0.0, std::atof(argv[++i]));
+        else opt.inputs.push_back(arg);
+    }
+    return !opt.inputs.empty();
+}
+
+// '*' and '?' wildcards, used for the last path component only
+bool wildcardMatch(const char *pattern, const char *text) {
+    if (*pattern == '\0') return *text == '\0';
+    if (*pattern == '*')
+        return wildcardMatch(pattern + 1, text) || (*text && wildcardMatch(pattern, text + 1));
+    if (*text && (*pattern == '?' || *pattern == *text))
+        return wildcardMatch(pattern + 1, text + 1);
+    return false;
+}
+
+// A walk as a route; its repeat traversals are the duplicates
+ChinesePostmanResult asRoute(const Graph &g, std::vector<int> &&edgeOrder) {
+    ChinesePostmanResult route;
+    std::vector<char> seen(g.getEdges().size(), 0);
+    for (int eid : edgeOrder)
+        if (seen[eid]++) route.duplicateEdgeIds.push_back(eid);
+    route.edgeOrder = std::move(edgeOrder);
+    route.isCycle = true;
+    return route;
+}
+
+// All streets to cover lie in one component: with optional streets
+// only the required ones count (RuralPostman.h)
+bool oneSector(const Graph &g) {
+    if (g.isConnectedUndirected()) return true;
+    if (!g.hasOptionalEdges()) return false;
+    const GraphComponents comps = GraphComponents::of(g);
+    const auto &edges = g.getEdges();
+    int sector = -1;
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        if (!edges[i].required) continue;
+        const int c = comps.componentOf[edges[i].u];
+        if (sector >= 0 && c != sector) return false;
+        sector = c;
+    }
+    return true;
+}
+
+std::vector<fs::path> expandInputs(const std::vector<std::string> &inputs) {
+    std::vector<fs::path> dirs;
+    std::error_code ec;
+    for (const auto &input : inputs) {
+        fs::path p(input);
+        std::string leaf = p.filename().string();
+        if (leaf.find_first_of("*?") == std::string::npos) {
+            dirs.push_back(p);
+            continue;
+        }
+        fs::path parent = p.has_parent_path() ? p.parent_path() : fs::path(".");
+        std::vector<fs::path> matches;
+        for (const auto &entry : fs::directory_iterator(parent, ec))
+            if (entry.is_directory(ec) && wildcardMatch(leaf.c_str(), entry.path().filename().string().c_str()))
+                matches.push_back(entry.path());
+        std::sort(matches.begin(), matches.end());
+        if (matches.empty()) std::cerr << "No location matches " << input << "\n";
+        dirs.insert(dirs.end(), matches.begin(), matches.end());
+    }
+    return dirs;
+}
+
+void solveLocation(LocationJob &job, const BatchOptions &opt, SolverContext &ctx) {
+    auto start = Clock::now();
+    Graph g;
+    auto report = LocationIO::loadLocation(job.dir, g);
+    job.loadMs = msSince(start);
+    job.vertices = static_cast<int>(g.getVertices().size());
+    job.edges = static_cast<int>(g.getEdges().size());
+
+    if (!report.directoryFound) { job.status = "missing directory"; return; }
+    if (!report.coordsFound) { job.status = "missing coords.txt"; return; }
+    if (!report.matrixFound) { job.status = "missing matrix.txt"; return; }
+    if (job.edges == 0) { job.status = "no edges"; return; }
+
+    // Locations already run concurrently, so each solve stays single-threaded
+    // (components included) unless it is the only one
+    ChinesePostmanOptions options;
+    options.threads = opt.solveThreads;
+    options.contractChains = opt.chains;
+    ContractionHierarchy hierarchy;
+    if (opt.hierarchy) {
+        start = Clock::now();
+        const fs::path file = job.dir / ContractionHierarchy::kFileName;
+        if (!ContractionHierarchy::load(file, hierarchy) || !hierarchy.matches(g)) {
+            hierarchy = ContractionHierarchy::build(g);
+            hierarchy.save(file);
+        }
+        job.hierarchyMs = msSince(start);
+        options.hierarchy = &hierarchy;
+    }
+    if (opt.landmarks) {
+        start = Clock::now();
+        const fs::path file = job.dir / LandmarkTable::kFileName;
+        LandmarkTable landmarks;
+        if (!LandmarkTable::load(file, landmarks) || !landmarks.matches(g))
+            LandmarkTable::build(g).save(file);
+        job.landmarksMs = msSince(start);
+    }
+    // District, unit and shift deadheading treat every street as two-way
+    if (g.hasDirectedEdges() && (opt.units > 0 || opt.districts >= 0 || opt.shiftLength > 0.0)) {
+        job.status = "one-way streets need the plain solve";
+        return;
+    }
+    start = Clock::now();
+    std::vector<ChinesePostmanResult> routes;
+    const bool whole = oneSector(g);
+    if (opt.units > 0 && whole) {
+        MultiRouteOptions routeOptions;
+        routeOptions.routes = opt.units;
+        routeOptions.depot = opt.depot;
+        routeOptions.threads = opt.solveThreads;
+        routeOptions.contractChains = opt.chains;
+        auto result = MultiRoutePostman::solve(ctx, g, routeOptions);
+        job.components = 1;
+        job.units = opt.units;
+        job.gap = result.gap;
+        job.longest = result.maxCost;
+        job.stats = result.stats;
+        if (result.maxCost <= 0.0) { job.status = "no route"; return; }
+        // Units left without work are not written
+        for (PatrolRoute &unit : result.routes)
+            if (!unit.edgeOrder.empty()) routes.push_back(asRoute(g, std::move(unit.edgeOrder)));
+    } else if (opt.districts >= 0 && whole) {
+        DistrictOptions districtOptions;
+        districtOptions.districts = opt.districts;
+        districtOptions.threads = opt.solveThreads;
+        districtOptions.contractChains = opt.chains;
+        auto result = DistrictPostman::solve(ctx, g, districtOptions);
+        job.components = 1;
+        job.districts = result.partition.parts;
+        job.gap = result.gap;
+        routes.push_back(std::move(result.route));
+        job.stats = routes[0].stats;
+    } else {
+        auto result = ComponentSolver::postman(ctx, g, options);
+        job.components = result.components.count();
+        routes = std::move(result.routes);
+        job.stats = result.stats;
+        if (routes.empty() && g.hasOptionalEdges()) { job.status = "no required streets"; return; }
+    }
+    if (opt.shiftLength > 0.0) {
+        ShiftOptions shiftOptions;
+        shiftOptions.maxShiftCost = opt.shiftLength;
+        shiftOptions.depot = opt.depot;
+        std::vector<ChinesePostmanResult> shifts;
+        for (const auto &route : routes) {
+            if (route.edgeOrder.empty()) { job.status = "no route"; return; }
+            ShiftPlan plan = ShiftSplitter::split(ctx, g, route.edgeOrder, shiftOptions);
+            if (!plan.feasible) { job.status = "shift length too short or depot unreachable"; return; }
+            for (Shift &shift : plan.shifts) shifts.push_back(asRoute(g, std::move(shift.edgeOrder)));
+        }
+        job.shifts = static_cast<int>(shifts.size());
+        routes = std::move(shifts);
+    }
+    job.solveMs = msSince(start);
+    if (!opt.traceDir.empty())
+        job.stats.writeChromeTrace((opt.traceDir / (job.dir.filename().string() + ".trace.json")).string());
+    std::vector<std::vector<int>> edgeOrders, duplicates;
+    for (const auto &route : routes) {
+        if (route.edgeOrder.empty()) {
+            job.status = g.hasDirectedEdges() && g.hasOptionalEdges() ? "one-way streets with optional streets"
+                                                                      : "no route";
+            return;
+        }
+        edgeOrders.push_back(route.edgeOrder);
+        duplicates.push_back(route.duplicateEdgeIds);
+        job.duplicates += static_cast<int>(route.duplicateEdgeIds.size());
+        for (int eid : route.edgeOrder) job.cost += g.getEdges()[eid].weight;
+    }
+
+    fs::path routeFile = opt.outputDir.empty()
+        ? job.dir / "route.txt"
+        : opt.outputDir / (job.dir.filename().string() + ".route.txt");
+    const bool written = edgeOrders.size() == 1
+        ? LocationIO::writeRoute(routeFile, g, edgeOrders[0], duplicates[0])
+        : LocationIO::writeRoutes(routeFile, g, edgeOrders, duplicates);
+    job.status = written ? "ok" : "write failed";
+}
+
+std::string csvField(const std::string &s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string quoted = "\"";
+    for (char c : s) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+void writeSummary(std::ostream &out, const std::vector<LocationJob> &jobs) {
+    out << "location,vertices,edges,components,districts,units,gap,longest,shifts,duplicates,cost,load_ms,hierarchy_ms,landmarks_ms,solve_ms,"
+           "odd_vertices,chain_vertices,matching_cost,heap_pushes,edges_relaxed,peak_bytes,phases_ms,status\n";
+    char times[96];
+    for (const auto &job : jobs) {
+        std::snprintf(times, sizeof(times), "%.3f,%.3f,%.3f,%.3f", job.loadMs, job.hierarchyMs,
+                      job.landmarksMs, job.solveMs);
+        std::int64_t pushes = 0, relaxed = 0;
+        std::string phases;
+        for (const auto &p : job.stats.phases) {
+            pushes += p.heapPushes;
+            relaxed += p.edgesRelaxed;
+            char item[96];
+            std::snprintf(item, sizeof(item), "%s%s=%.3f", phases.empty() ? "" : ";", p.name.c_str(), p.wallMs);
+            phases += item;
+        }
+        out << csvField(job.dir.string()) << ',' << job.vertices << ',' << job.edges << ','
+            << job.components << ',' << job.districts << ',' << job.units << ',' << job.gap << ','
+            << job.longest << ',' << job.shifts << ','
+            << job.duplicates << ',' << job.cost << ',' << times << ','
+            << job.stats.oddVertices << ',' << job.stats.chainVertices << ',' << job.stats.matchingCost << ','
+            << pushes << ',' << relaxed << ',' << job.stats.peakBytes() << ',' << phases << ','
+            << csvField(job.status) << "\n";
+    }
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    BatchOptions opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+
+    std::error_code ec;
+    if (!opt.outputDir.empty()) fs::create_directories(opt.outputDir, ec);
+    if (!opt.traceDir.empty()) fs::create_directories(opt.traceDir, ec);
+
+    std::vector<LocationJob> jobs;
+    for (auto &dir : expandInputs(opt.inputs)) {
+        LocationJob job;
+        job.dir = dir;
+        jobs.push_back(std::move(job));
+    }
+    if (jobs.empty()) return 1;
+    if (jobs.size() == 1) opt.solveThreads = opt.threads;
+
+    auto start = Clock::now();
+    // One context per worker: scratch is reused across that worker's
+    // locations and no state is shared between concurrent solves
+    ParallelExecutor executor(opt.threads);
+    std::vector<SolverContext> contexts(executor.workerCount());
+    executor.parallelFor(static_cast<int>(jobs.size()), [&](int i, unsigned worker) {
+        solveLocation(jobs[i], opt, contexts[worker]);
+    });
+    double totalMs = msSince(start);
+
+    int failures = 0;
+    for (const auto &job : jobs)
+        if (job.status != "ok") ++failures;
+
+    if (opt.summaryFile.empty()) {
+        writeSummary(std::cout, jobs);
+    } else {
+        std::ofstream out(opt.summaryFile);
+        writeSummary(out, jobs);
+    }
+    std::cerr << jobs.size() << " locations, " << failures << " failed, "
+              << executor.workerCount() << " threads, " << totalMs << " ms total\n";
+    return failures == 0 ? 0 : 1;
+}
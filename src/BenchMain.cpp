@@ -0,0 +1,614 @@
+#include "Algorithms.h"
+#include "AugmentedGraph.h"
+#include "ChinesePostman.h"
+#include "ContractionHierarchy.h"
+#include "DistanceTable.h"
+#include "DistrictPostman.h"
+#include "GoalDirectedSearch.h"
+#include "Graph.h"
+#include "LocationIO.h"
+#include "MixedPostman.h"
+#include "MultiRoutePostman.h"
+#include "ParallelExecutor.h"
+#include "RuralPostman.h"
+#include "ShiftSplitter.h"
+#include "SyntheticNetworks.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* ============================================================
+   TrafficPatrolBench — reproducible solver benchmark
+   ------------------------------------------------------------
+   Usage: TrafficPatrolBench [--families grid,radial,powerlaw]
+                             [--sizes 100,1000,...] [--seed N]
+                             [--closure RATE] [--repeat N]
+                             [--threads N] [--max-work N]
+                             [--load-limit V] [--weights KIND]
+                             [--hierarchy-limit E] [--dense KIND]
+                             [--districts K] [--units K]
+                             [--one-way RATE] [--required RATE]
+                             [-o FILE]
+
+   For every (family, size) a synthetic network is generated and
+   each phase is timed separately: generation, loading through a
+   location folder, connectivity, a 64 × 64 station distance
+   table, 64 point-to-point queries with plain Dijkstra, A* and
+   ALT (16 landmarks, built once per case), every step of the
+   postman solve (--dense picks its Floyd–Warshall mode), its
+   tour cut into shifts of a quarter of its cost (ShiftSplitter,
+   every shift checked to be a closed walk from the station) and
+   a stand-alone Hierholzer run on the doubled network. Each
+   phase reports the median of --repeat runs. Output is JSON.
+   --weights real adds 0.5 to every street so the solver takes
+   its floating-point shortest-path path instead of the integer
+   (radix heap) one. Networks of up to --hierarchy-limit edges
+   also get a contraction hierarchy: its build, the same 64 × 64
+   table through it (checked against the plain table) and a
+   postman solve that takes its odd-vertex distances from it.
+   The postman is also solved with degree-2 chains contracted
+   (checked to cost the same as the plain solve) and, with
+   --districts, by K districts (DistrictPostman), reporting the
+   gap to the exact cost and to the district lower bound. With
+   --units the streets are also split between K patrol units
+   leaving from the first street (MultiRoutePostman), checked to be
+   closed walks from there, reporting the longest route's gap to
+   the min-max lower bound. --one-way makes a share of
+   the streets one-way; the postman is then MixedPostman, reporting
+   its gap to the flow lower bound (districts and units, which do
+   not follow one-way streets, are skipped). --required marks only
+   a random share of the streets required; the postman is then
+   RuralPostman, reporting its deadheading over the required length
+   (districts solve the city as one, and units split the rural
+   tour). --one-way and --required together skip the postman: the
+   one-way solver has no optional streets.
+   ============================================================ */
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct BenchOptions {
+    std::vector<std::string> families{"grid", "radial", "powerlaw"};
+    std::vector<int> sizes{100, 1000, 10000, 100000, 1000000};
+    SyntheticNetworks::Params params;
+    int repeat{3};
+    unsigned threads{0};
+    // Skip the postman solve when oddVertices * V exceeds this: the
+    // per-source predecessor trees would not fit in memory.
+    double maxWork{5e7};
+    // Round-trip through coords.txt/matrix.txt only up to this many
+    // vertices (matrix.txt is V x V).
+    int loadLimit{2000};
+    bool realWeights{false};
+    // Build a ContractionHierarchy up to this many edges (0 = never)
+    int hierarchyLimit{0};
+    DenseMode dense{DenseMode::Auto};
+    // DistrictPostman solve with this many districts (0 = skipped)
+    int districts{0};
+    // MultiRoutePostman solve with this many units (0 = skipped)
+    int units{0};
+    std::string outputFile;
+};
+
+struct CaseResult {
+    std::string family;
+    int targetEdges{0};
+    int vertices{0};
+    int edges{0};
+    int oddVertices{0};
+    int duplicates{0};
+    double cost{0.0};
+    std::string status{"ok"};
+    std::map<std::string, std::vector<double>> samples;  // phase -> ms per run
+    SolverStats stats;                                   // counters of the last solve
+    int shortcuts{-1};                                   // hierarchy shortcuts, -1 = not built
+    int chainVertices{0};                                // removed by chain contraction
+    double districtGap{-1.0};                            // district cost / exact − 1, -1 = not run
+    double districtBoundGap{-1.0};                       // district cost / its lower bound − 1
+    double unitsBoundGap{-1.0};                          // longest patrol route / min-max bound − 1
+    double mixedBoundGap{-1.0};                          // one-way postman / flow lower bound − 1
+    double ruralDeadhead{-1.0};                          // rural postman / required length − 1
+    double settledPerQuery[3]{0.0, 0.0, 0.0};            // point-to-point, by SearchMode
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+template <typename T, typename Parse>
+std::vector<T> splitList(const std::string &s, Parse parse) {
+    std::vector<T> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty()) out.push_back(parse(item));
+    return out;
+}
+
+void printUsage() {
+    std::cerr << "Usage: TrafficPatrolBench [options]\n"
+                 "  --families LIST  grid,radial,powerlaw (default: all)\n"
+                 "  --sizes LIST     target edge counts (default: 100,...,1000000)\n"
+                 "  --seed N         generator seed (default: 1)\n"
+                 "  --closure RATE   share of closable streets removed (default: 0.02)\n"
+                 "  --repeat N       runs per case, the median is reported (default: 3)\n"
+                 "  --threads N      solver threads (default: all cores)\n"
+                 "  --max-work N     skip solves with odd*V above N (default: 5e7)\n"
+                 "  --load-limit V   time location-folder loading up to V vertices (default: 2000)\n"
+                 "  --weights KIND   integer (generator weights) or real (+0.5 each)\n"
+                 "  --hierarchy-limit E  build a contraction hierarchy up to E edges (default: 0)\n"
+                 "  --dense KIND     postman dense mode: auto, never or always (default: auto)\n"
+                 "  --districts K    also solve by K districts (default: 0 = skip)\n"
+                 "  --units K        also split between K patrol units (default: 0 = skip)\n"
+                 "  --one-way RATE   share of streets off a spanning tree made one-way (default: 0)\n"
+                 "  --required RATE  share of streets that must be covered (default: 1)\n"
+                 "  -o FILE          write JSON to FILE instead of stdout\n";
+}
+
+bool parseArgs(int argc, char *argv[], BenchOptions &opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") return false;
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--families")
+            opt.families = splitList<std::string>(value, [](const std::string &s) { return s; });
+        else if (arg == "--sizes")
+            opt.sizes = splitList<int>(value, [](const std::string &s) { return static_cast<int>(std::atof(s.c_str())); });
+        else if (arg == "--seed") opt.params.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--closure") opt.params.closureRate = std::atof(value.c_str());
+        else if (arg == "--repeat") opt.repeat = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--threads") opt.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+        else if (arg == "--max-work") opt.maxWork = std::atof(value.c_str());
+        else if (arg == "--load-limit") opt.loadLimit = std::atoi(value.c_str());
+        else if (arg == "--weights") {
+            if (value != "integer" && value != "real") {
+                std::cerr << "--weights must be integer or real\n";
+                return false;
+            }
+            opt.realWeights = value == "real";
+        }
+        else if (arg == "--hierarchy-limit") opt.hierarchyLimit = std::atoi(value.c_str());
+        else if (arg == "--dense") {
+            if (value == "auto") opt.dense = DenseMode::Auto;
+            else if (value == "never") opt.dense = DenseMode::Never;
+            else if (value == "always") opt.dense = DenseMode::Always;
+            else {
+                std::cerr << "--dense must be auto, never or always\n";
+                return false;
+            }
+        }
+        else if (arg == "--districts") opt.districts = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--units") opt.units = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--one-way") opt.params.oneWayRate = std::atof(value.c_str());
+        else if (arg == "--required") opt.params.requiredRate = std::atof(value.c_str());
+        else if (arg == "-o") opt.outputFile = value;
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes the network as a location folder (unit weights, as the GUI
+// stores it) so loading can be timed the same way the tools load.
+void writeLocation(const Graph &g, const fs::path &dir) {
+    fs::create_directories(dir);
+    std::ofstream coords(dir / "coords.txt");
+    for (const auto &v : g.getVertices())
+        coords << v.position.x << ' ' << v.position.y << "\n";
+
+    const int n = static_cast<int>(g.getVertices().size());
+    std::vector<std::string> rows(n, std::string(2 * n, ' '));
+    for (auto &row : rows)
+        for (int j = 0; j < n; ++j) row[2 * j] = '0';
+    for (const auto &e : g.getEdges()) {
+        rows[e.u][2 * e.v] = '1';
+        rows[e.v][2 * e.u] = '1';
+    }
+    std::ofstream matrix(dir / "matrix.txt");
+    for (auto &row : rows) {
+        row.back() = '\n';
+        matrix << row;
+    }
+    LocationIO::writeRequired(dir, g);
+}
+
+// Every required street driven; every traversal after the first of a
+// street listed as a duplicate
+bool isValidTour(const Graph &g, const ChinesePostmanResult &r) {
+    const auto &edges = g.getEdges();
+    std::vector<int> seen(edges.size(), 0);
+    for (int eid : r.edgeOrder) seen[eid]++;
+    std::size_t driven = 0;
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        if (edges[i].required && seen[i] == 0) return false;
+        driven += seen[i] > 0;
+    }
+    return !r.edgeOrder.empty() && r.edgeOrder.size() == driven + r.duplicateEdgeIds.size();
+}
+
+// A closed walk leaving from and returning to depot (one-way streets
+// u → v only)
+bool isClosedWalkFrom(const Graph &g, const std::vector<int> &edgeOrder, int depot) {
+    int v = depot;
+    for (int eid : edgeOrder) {
+        const Edge &e = g.getEdges()[eid];
+        if (e.u == v) v = e.v;
+        else if (e.v == v && !e.directed) v = e.u;
+        else return false;
+    }
+    return v == depot;
+}
+
+void runCase(const BenchOptions &opt, CaseResult &cr) {
+    SyntheticNetworks::Params params = opt.params;
+    params.targetEdges = cr.targetEdges;
+    const fs::path scratch = fs::temp_directory_path() / "traffic-patrol-bench";
+    SolverContext ctx;
+    ContractionHierarchy hierarchy;
+    LandmarkTable landmarks;
+
+    for (int run = 0; run < opt.repeat; ++run) {
+        auto start = Clock::now();
+        Graph g;
+        SyntheticNetworks::generate(cr.family, params, g);
+        if (opt.realWeights)
+            for (auto &e : g.getEdges()) e.weight += 0.5;
+        cr.samples["generate"].push_back(msSince(start));
+        cr.vertices = static_cast<int>(g.getVertices().size());
+        cr.edges = static_cast<int>(g.getEdges().size());
+
+        if (cr.vertices <= opt.loadLimit) {
+            if (run == 0) writeLocation(g, scratch);
+            Graph loaded;
+            start = Clock::now();
+            LocationIO::loadLocation(scratch, loaded);
+            cr.samples["load"].push_back(msSince(start));
+        }
+
+        start = Clock::now();
+        bool connected = g.isConnectedUndirected();
+        cr.samples["connectivity"].push_back(msSince(start));
+        if (!connected) { cr.status = "disconnected"; return; }
+
+        // Dispatch-style query: 64 stations × 64 hot spots, spread
+        // evenly over the vertex ids
+        start = Clock::now();
+        DistanceTableEngine engine(g, opt.threads);
+        cr.samples["distance_engine"].push_back(msSince(start));
+        std::vector<int> stations, hotSpots;
+        for (int k = 0; k < 64; ++k) {
+            stations.push_back(static_cast<int>(static_cast<long long>(k) * cr.vertices / 64));
+            hotSpots.push_back(static_cast<int>((static_cast<long long>(k) * cr.vertices + cr.vertices / 2) / 64));
+        }
+        DistanceTable table;
+        start = Clock::now();
+        engine.table(stations, hotSpots, table);
+        cr.samples["distance_table"].push_back(msSince(start));
+
+        // Point-to-point: station k to the opposite hot spot, once per
+        // search mode; the landmark table is built on the first run
+        if (landmarks.empty()) {
+            start = Clock::now();
+            landmarks = LandmarkTable::build(g);
+            cr.samples["landmarks_build"].push_back(msSince(start));
+        }
+        GoalDirectedSearch search(g, &landmarks);
+        const char *modeNames[3] = {"p2p_dijkstra", "p2p_astar", "p2p_alt"};
+        for (int m = 0; m < 3; ++m) {
+            std::int64_t settled = 0;
+            start = Clock::now();
+            for (int k = 0; k < 64; ++k) {
+                const double d = search.distance(stations[k], hotSpots[63 - k], static_cast<SearchMode>(m));
+                settled += search.lastQuery().settled;
+                if (std::abs(d - table.distance(k, 63 - k)) > 1e-6 * (1.0 + d)) {
+                    cr.status = std::string(modeNames[m]) + " failed";
+                    return;
+                }
+            }
+            cr.samples[modeNames[m]].push_back(msSince(start));
+            cr.settledPerQuery[m] = settled / 64.0;
+        }
+
+        // The hierarchy is built once per case (it is a preprocessing
+        // step) and reused by the later runs
+        if (cr.edges <= opt.hierarchyLimit) {
+            if (hierarchy.empty()) {
+                start = Clock::now();
+                hierarchy = ContractionHierarchy::build(g);
+                cr.samples["hierarchy_build"].push_back(msSince(start));
+                cr.shortcuts = hierarchy.shortcutCount();
+            }
+            ParallelExecutor executor(opt.threads);
+            std::vector<double> viaHierarchy;
+            start = Clock::now();
+            hierarchy.table(stations, hotSpots, viaHierarchy, executor, ctx.hierarchy);
+            cr.samples["hierarchy_table"].push_back(msSince(start));
+            for (size_t k = 0; k < viaHierarchy.size(); ++k)
+                if (std::abs(viaHierarchy[k] - table.distances[k]) > 1e-6 * (1.0 + table.distances[k])) {
+                    cr.status = "hierarchy failed";
+                    return;
+                }
+        }
+
+        start = Clock::now();
+        const CsrAdjacency csr = g.csr();
+        cr.oddVertices = 0;
+        for (int v = 0; v < csr.vertexCount(); ++v)
+            cr.oddVertices += csr.degree(v) % 2;
+        cr.samples["degrees"].push_back(msSince(start));
+
+        // Stand-alone Euler engine: every street walked twice is Eulerian
+        AugmentedGraph doubled(g);
+        for (int eid = 0; eid < cr.edges; ++eid) doubled.duplicate(eid);
+        start = Clock::now();
+        auto euler = Algorithms::findEulerTourHierholzer(ctx, doubled, csr);
+        cr.samples["hierholzer"].push_back(msSince(start));
+        if (!euler || static_cast<int>(euler->edgeOrder.size()) != 2 * cr.edges) {
+            cr.status = "hierholzer failed";
+            return;
+        }
+
+        if (g.hasDirectedEdges() && g.hasOptionalEdges()) {
+            cr.status = "postman skipped (one-way and optional streets together)";
+            continue;
+        }
+        if (static_cast<double>(cr.oddVertices) * cr.vertices > opt.maxWork) {
+            cr.status = "postman skipped (odd*V above --max-work)";
+            continue;
+        }
+        ChinesePostmanOptions options;
+        options.threads = opt.threads;
+        options.dense = opt.dense;
+        start = Clock::now();
+        ChinesePostmanResult result;
+        if (g.hasDirectedEdges()) {
+            MixedPostmanResult mixed = MixedPostman::solve(ctx, g, options);
+            cr.mixedBoundGap = mixed.gap;
+            result = std::move(mixed.route);
+        } else if (g.hasOptionalEdges()) {
+            RuralPostmanResult rural = RuralPostman::solve(ctx, g, options);
+            cr.ruralDeadhead = rural.gap;
+            result = std::move(rural.route);
+        } else {
+            result = ChinesePostmanOptimal::solve(ctx, g, options);
+        }
+        cr.samples["postman"].push_back(msSince(start));
+        for (const auto &phase : result.stats.phases)
+            cr.samples["postman." + phase.name].push_back(phase.wallMs);
+        cr.stats = result.stats;
+        if (!isValidTour(g, result)) {
+            cr.status = "postman failed";
+            return;
+        }
+        cr.duplicates = static_cast<int>(result.duplicateEdgeIds.size());
+        cr.cost = 0;
+        for (int eid : result.edgeOrder) cr.cost += g.getEdges()[eid].weight;
+
+        // The tour cut into shifts of a quarter of its cost: consecutive
+        // pieces, each a closed walk from the station. Infeasible only
+        // when one street is out of reach (ShiftSplitter does not follow
+        // one-way streets)
+        if (!g.hasDirectedEdges()) {
+            ShiftOptions shiftOptions;
+            shiftOptions.depot = g.getEdges()[0].u;
+            shiftOptions.maxShiftCost = cr.cost / 4.0;
+            start = Clock::now();
+            ShiftPlan plan = ShiftSplitter::split(ctx, g, result.edgeOrder, shiftOptions);
+            cr.samples["shifts"].push_back(msSince(start));
+            bool valid = plan.feasible || plan.blockingPosition >= 0;
+            int next = 0;
+            for (const Shift &shift : plan.shifts) {
+                valid = valid && shift.begin == next && isClosedWalkFrom(g, shift.edgeOrder, shiftOptions.depot);
+                next = shift.end;
+            }
+            if (!valid || (plan.feasible && next != static_cast<int>(result.edgeOrder.size()))) {
+                cr.status = "shifts failed";
+                return;
+            }
+        }
+
+        // Same solve with the degree-2 chains collapsed: same cost
+        options.contractChains = true;
+        start = Clock::now();
+        auto viaChains = ChinesePostmanOptimal::solve(ctx, g, options);
+        cr.samples["postman_chains"].push_back(msSince(start));
+        options.contractChains = false;
+        cr.chainVertices = viaChains.stats.chainVertices;
+        double chainsCost = 0;
+        for (int eid : viaChains.edgeOrder) chainsCost += g.getEdges()[eid].weight;
+        if (!isValidTour(g, viaChains) || std::abs(chainsCost - cr.cost) > 1e-6 * (1.0 + cr.cost)) {
+            cr.status = "postman (chains) failed";
+            return;
+        }
+
+        // District and unit deadheading treat every street as two-way
+        if (opt.districts > 0 && !g.hasDirectedEdges()) {
+            DistrictOptions districtOptions;
+            districtOptions.districts = opt.districts;
+            districtOptions.threads = opt.threads;
+            districtOptions.dense = opt.dense;
+            start = Clock::now();
+            auto byDistrict = DistrictPostman::solve(ctx, g, districtOptions);
+            cr.samples["postman_districts"].push_back(msSince(start));
+            if (!isValidTour(g, byDistrict.route)) {
+                cr.status = "postman (districts) failed";
+                return;
+            }
+            cr.districtGap = cr.cost > 0 ? byDistrict.cost / cr.cost - 1.0 : 0.0;
+            cr.districtBoundGap = byDistrict.gap;
+        }
+
+        if (opt.units > 0 && !g.hasDirectedEdges()) {
+            MultiRouteOptions routeOptions;
+            routeOptions.routes = opt.units;
+            routeOptions.depot = g.getEdges()[0].u;
+            routeOptions.threads = opt.threads;
+            start = Clock::now();
+            auto byUnit = MultiRoutePostman::solve(ctx, g, routeOptions);
+            cr.samples["postman_units"].push_back(msSince(start));
+            std::vector<char> covered(cr.edges, 0);
+            bool walks = true;
+            for (const PatrolRoute &route : byUnit.routes) {
+                for (int eid : route.edgeOrder) covered[eid] = 1;
+                walks = walks && isClosedWalkFrom(g, route.edgeOrder, routeOptions.depot);
+            }
+            for (const Edge &e : g.getEdges())
+                if (!e.required) covered[e.id] = 1;
+            if (byUnit.maxCost <= 0.0 || !walks || std::count(covered.begin(), covered.end(), 0) > 0) {
+                cr.status = "postman (units) failed";
+                return;
+            }
+            cr.unitsBoundGap = byUnit.gap;
+        }
+
+        if (!hierarchy.empty()) {
+            options.hierarchy = &hierarchy;
+            start = Clock::now();
+            auto viaHierarchy = ChinesePostmanOptimal::solve(ctx, g, options);
+            cr.samples["postman_hierarchy"].push_back(msSince(start));
+            if (!isValidTour(g, viaHierarchy)
+                || std::abs(viaHierarchy.stats.matchingCost - result.stats.matchingCost)
+                       > 1e-6 * (1.0 + result.stats.matchingCost)) {
+                cr.status = "postman (hierarchy) failed";
+                return;
+            }
+        }
+    }
+    std::error_code ec;
+    fs::remove_all(scratch, ec);
+}
+
+std::string jsonString(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+void writeJson(std::ostream &out, const BenchOptions &opt, const std::vector<CaseResult> &cases) {
+    char num[64];
+    auto fmt = [&num](double v) {
+        std::snprintf(num, sizeof(num), "%.4f", v);
+        return std::string(num);
+    };
+
+    out << "{\n  \"benchmark\": \"TrafficPatrolBench\",\n  \"schema\": 1,\n";
+#ifdef NDEBUG
+    out << "  \"build\": \"release\",\n";
+#else
+    out << "  \"build\": \"debug\",\n";
+#endif
+    out << "  \"seed\": " << opt.params.seed << ",\n";
+    out << "  \"closureRate\": " << opt.params.closureRate << ",\n";
+    out << "  \"oneWayRate\": " << opt.params.oneWayRate << ",\n";
+    out << "  \"requiredRate\": " << opt.params.requiredRate << ",\n";
+    out << "  \"repeat\": " << opt.repeat << ",\n";
+    out << "  \"threads\": " << opt.threads << ",\n";
+    out << "  \"weights\": " << (opt.realWeights ? "\"real\"" : "\"integer\"") << ",\n";
+    out << "  \"cases\": [";
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const CaseResult &c = cases[i];
+        out << (i ? "," : "") << "\n    {\"family\": " << jsonString(c.family)
+            << ", \"targetEdges\": " << c.targetEdges
+            << ", \"vertices\": " << c.vertices
+            << ", \"edges\": " << c.edges
+            << ", \"oddVertices\": " << c.oddVertices
+            << ", \"duplicates\": " << c.duplicates
+            << ", \"cost\": " << fmt(c.cost)
+            << ", \"status\": " << jsonString(c.status)
+            << ",\n     \"phasesMs\": {";
+        bool first = true;
+        for (const auto &[name, runs] : c.samples) {
+            out << (first ? "" : ", ") << jsonString(name) << ": " << fmt(median(runs));
+            first = false;
+        }
+        out << "},\n     \"counters\": {";
+        first = true;
+        for (const auto &p : c.stats.phases) {
+            out << (first ? "" : ", ") << jsonString("postman." + p.name)
+                << ": {\"heapPushes\": " << p.heapPushes << ", \"heapPops\": " << p.heapPops
+                << ", \"edgesRelaxed\": " << p.edgesRelaxed << ", \"peakBytes\": " << p.peakBytes << "}";
+            first = false;
+        }
+        out << "}, \"matchingCost\": " << fmt(c.stats.matchingCost)
+            << ", \"integerWeights\": " << (c.stats.integerWeights ? "true" : "false")
+            << ", \"dense\": " << (c.stats.dense ? "true" : "false")
+            << ", \"shortcuts\": " << c.shortcuts
+            << ", \"chainVertices\": " << c.chainVertices
+            << ", \"districtGap\": " << fmt(c.districtGap)
+            << ", \"districtBoundGap\": " << fmt(c.districtBoundGap)
+            << ", \"unitsBoundGap\": " << fmt(c.unitsBoundGap)
+            << ", \"mixedBoundGap\": " << fmt(c.mixedBoundGap)
+            << ", \"ruralDeadhead\": " << fmt(c.ruralDeadhead)
+            << ", \"connectorEdges\": " << c.stats.connectorEdges
+            << ",\n     \"settledPerQuery\": {\"dijkstra\": " << fmt(c.settledPerQuery[0])
+            << ", \"astar\": " << fmt(c.settledPerQuery[1])
+            << ", \"alt\": " << fmt(c.settledPerQuery[2]) << "}}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<CaseResult> cases;
+    for (const auto &family : opt.families) {
+        Graph probe;
+        if (!SyntheticNetworks::generate(family, SyntheticNetworks::Params{3, 0.0, 1}, probe)) {
+            std::cerr << "Unknown family " << family << "\n";
+            return 2;
+        }
+        for (int size : opt.sizes) {
+            CaseResult cr;
+            cr.family = family;
+            cr.targetEdges = size;
+            std::cerr << family << " " << size << " edges...\n";
+            runCase(opt, cr);
+            cases.push_back(std::move(cr));
+        }
+    }
+
+    int failures = 0;
+    for (const auto &c : cases)
+        if (c.status.find("failed") != std::string::npos || c.status == "disconnected") ++failures;
+
+    if (opt.outputFile.empty()) {
+        writeJson(std::cout, opt, cases);
+    } else {
+        std::ofstream out(opt.outputFile);
+        writeJson(out, opt, cases);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include "ChainContraction.h"
+#include "Algorithms.h"
+
+ChainContraction ChainContraction::build(const Graph &g) {
+    ChainContraction chains;
+    chains.assign(g);
+    return chains;
+}
+
+int ChainContraction::walk(const CsrAdjacency &csr, int slot, double &weight) {
+    int eid = csr.edgeIds[slot];
+    int cur = csr.neighbors[slot];
+    weight = csr.weights[slot];
+    usedEdge[eid] = 1;
+    chainEdges.push_back(eid);
+    while (interior[cur]) {
+        // An interior vertex has exactly two distinct, non-loop edges
+        const int s = csr.edgeIds[csr.begin(cur)] == eid ? csr.begin(cur) + 1 : csr.begin(cur);
+        eid = csr.edgeIds[s];
+        weight += csr.weights[s];
+        usedEdge[eid] = 1;
+        chainEdges.push_back(eid);
+        cur = csr.neighbors[s];
+    }
+    return cur;
+}
+
+void ChainContraction::assign(const Graph &g) {
+    const auto &edges = g.getEdges();
+    const auto &verts = g.getVertices();
+    const int n = static_cast<int>(verts.size());
+    const CsrAdjacency csr = g.csr();
+    reduced.clear();
+    keptVertices.clear();
+    chainOffsets.assign(1, 0);
+    chainEdges.clear();
+    removed = 0;
+
+    // --- B1. Đỉnh trong chuỗi: bậc 2, không khuyên, không cạnh một chiều ---
+    interior.assign(n, 0);
+    for (int v = 0; v < n; ++v) {
+        if (csr.degree(v) != 2) continue;
+        const int a = csr.begin(v), b = a + 1;
+        interior[v] = csr.neighbors[a] != v && csr.neighbors[b] != v
+            && !edges[csr.edgeIds[a]].directed && !edges[csr.edgeIds[b]].directed;
+    }
+
+    // --- B2. Chuỗi khép kín (cả thành phần toàn đỉnh bậc 2): giữ đỉnh nhỏ nhất ---
+    // Walking from every kept vertex marks every edge of an open chain;
+    // whatever is left belongs to closed ones.
+    usedEdge.assign(edges.size(), 0);
+    double weight = 0.0;
+    for (int v = 0; v < n; ++v) {
+        if (interior[v]) continue;
+        for (int s = csr.begin(v); s < csr.end(v); ++s)
+            if (!usedEdge[csr.edgeIds[s]]) walk(csr, s, weight);
+    }
+    for (int v = 0; v < n; ++v)
+        if (interior[v] && !usedEdge[csr.edgeIds[csr.begin(v)]]) {
+            interior[v] = 0;
+            walk(csr, csr.begin(v), weight);
+        }
+
+    // --- B3. Đánh số lại các đỉnh được giữ ---
+    newId.assign(n, -1);
+    for (int v = 0; v < n; ++v) {
+        if (interior[v]) { ++removed; continue; }
+        newId[v] = static_cast<int>(keptVertices.size());
+        keptVertices.push_back(v);
+        reduced.addVertex(verts[v].position, verts[v].name);
+    }
+
+    // --- B4. Mỗi chuỗi thành một siêu cạnh ---
+    chainEdges.clear();
+    usedEdge.assign(edges.size(), 0);
+    for (int v : keptVertices) {
+        for (int s = csr.begin(v); s < csr.end(v); ++s) {
+            if (usedEdge[csr.edgeIds[s]]) continue;
+            const Edge &first = edges[csr.edgeIds[s]];
+            const int end = walk(csr, s, weight);
+            chainOffsets.push_back(static_cast<int>(chainEdges.size()));
+            if (first.directed) {
+                reduced.addEdge(newId[first.u], newId[first.v], weight, true);
+            } else {
+                reduced.addEdge(newId[v], newId[end], weight);
+            }
+        }
+    }
+}
+
+void ChainContraction::expandTour(const std::vector<int> &edgeOrder, std::vector<int> &out) const {
+    out.clear();
+    if (edgeOrder.empty()) return;
+    const auto &superEdges = reduced.getEdges();
+
+    // Start: the end of the first edge from which the order is a walk
+    int cur = Algorithms::walkStart(superEdges, edgeOrder);
+    if (cur < 0) cur = superEdges[edgeOrder[0]].u;
+    for (int eid : edgeOrder) {
+        const Edge &e = superEdges[eid];
+        if (e.u == cur) {
+            out.insert(out.end(), chainBegin(eid), chainEnd(eid));
+            cur = e.v;
+        } else {
+            for (const int *p = chainEnd(eid); p != chainBegin(eid);) out.push_back(*--p);
+            cur = e.u;
+        }
+    }
+}
+
+void ChainContraction::expandEdges(const std::vector<int> &edgeIds, std::vector<int> &out) const {
+    out.clear();
+    for (int eid : edgeIds) out.insert(out.end(), chainBegin(eid), chainEnd(eid));
+}
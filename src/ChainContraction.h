@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include "Graph.h"
+
+/* ============================================================
+   ChainContraction — degree-2 chains as single super-edges
+   ------------------------------------------------------------
+   Surveyed streets are split at every shape point and mid-block
+   node, so most vertices of a road graph have degree 2 and only
+   pass the route along. A maximal chain u – x1 – ... – xk – w of
+   such vertices becomes one super-edge u – w whose weight is the
+   sum of the chain. The reduced graph has the same odd vertices
+   and the same shortest distances between the vertices it keeps
+   (a shortest path that enters a chain leaves through its other
+   end), so a postman tour of it is optimal for the original once
+   every super-edge is expanded back into its edges, walked in the
+   direction the tour crosses it.
+
+   A vertex is kept when its degree is not 2, it has a self-loop,
+   or it touches a directed edge. A component that is one closed
+   chain keeps its smallest vertex and becomes a self-loop. Kept
+   vertices and edges between them stay in ascending id order.
+   Buffers are reused by assign(), so a context can keep one.
+   ============================================================ */
+class ChainContraction {
+public:
+    ChainContraction() = default;
+
+    static ChainContraction build(const Graph &g);
+    void assign(const Graph &g);
+
+    const Graph& contracted() const { return reduced; }
+    int removedVertexCount() const { return removed; }
+    // Original id of a vertex of contracted()
+    int originalVertex(int v) const { return keptVertices[v]; }
+    // Original edges of super-edge e, in order from its u to its v
+    const int* chainBegin(int e) const { return chainEdges.data() + chainOffsets[e]; }
+    const int* chainEnd(int e) const { return chainEdges.data() + chainOffsets[e + 1]; }
+
+    // Tour over contracted() (edge ids, consecutive) → tour over the
+    // original graph; out may not alias edgeOrder
+    void expandTour(const std::vector<int> &edgeOrder, std::vector<int> &out) const;
+    // Every super-edge id → all the original edges of its chain
+    void expandEdges(const std::vector<int> &edgeIds, std::vector<int> &out) const;
+
+private:
+    Graph reduced;
+    int removed{0};
+    std::vector<int> keptVertices;   // contracted vertex → original
+    std::vector<int> chainOffsets;   // super-edge e owns chainEdges[offsets[e], offsets[e + 1])
+    std::vector<int> chainEdges;
+    // Scratch of assign()
+    std::vector<int> newId;
+    std::vector<char> interior;
+    std::vector<char> usedEdge;
+
+    // Follows the chain that leaves through CSR slot `slot` up to the
+    // next kept vertex, appending its edges; returns that vertex
+    int walk(const CsrAdjacency &csr, int slot, double &weight);
+};
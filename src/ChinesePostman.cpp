@@ -1,128 +1,382 @@
 ﻿#include "ChinesePostman.h"
 #include "Algorithms.h"
+#include "DenseGraph.h"
+#include "MinWeightMatching.h"
+#include "MixedPostman.h"
+#include "ParallelExecutor.h"
+#include "RuralPostman.h"
+#include "ShortestPaths.h"
 #include <unordered_map>
 #include <set>
 #include <queue>
 #include <limits>
-#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+namespace {
+// Closes the running phase at each mark() and opens the next one
+class PhaseClock {
+public:
+    explicit PhaseClock(SolverStats &out) : stats(out), origin(Clock::now()), last(origin) {}
+    PhaseStats& mark(const char *name) {
+        auto now = Clock::now();
+        PhaseStats p;
+        p.name = name;
+        p.startMs = ms(origin, last);
+        p.wallMs = ms(last, now);
+        stats.phases.push_back(p);
+        stats.totalMs = ms(origin, now);
+        last = now;
+        return stats.phases.back();
+    }
+private:
+    using Clock = std::chrono::steady_clock;
+    static double ms(Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+    SolverStats &stats;
+    Clock::time_point origin, last;
+};
+
+template <typename T>
+std::size_t bytesOf(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
+}
+
+namespace {
+void solveSteps(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                ChinesePostmanResult &result);
+
+void publish(SolverContext &ctx, const ChinesePostmanResult &result) {
+    ctx.stats = result.stats;
+    if (result.edgeOrder.empty()) {
+        ctx.lastPostman.reset();
+    } else {
+        if (!ctx.lastPostman) ctx.lastPostman.emplace();
+        ctx.lastPostman->edgeOrder.assign(result.edgeOrder.begin(), result.edgeOrder.end());
+        ctx.lastPostman->isCycle = result.isCycle;
+        ctx.lastPostman->vertexOrder.clear();
+    }
+}
+
+// Solves g with its degree-2 chains collapsed and expands the route
+// back to g's edge ids; false (nothing done) when no vertex has
+// degree 2
+bool solveContracted(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                     ChinesePostmanResult &result) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    PostmanWorkspace &ws = ctx.postman;
+    const auto start = Clock::now();
+    if (options.progress) options.progress("chains", 0, 1);
+    ws.chains.assign(g);
+    if (ws.chains.removedVertexCount() == 0) return false;
+    const auto contracted = Clock::now();
+
+    ChinesePostmanOptions inner = options;
+    inner.contractChains = false;
+    inner.hierarchy = nullptr;
+    solveSteps(ctx, ws.chains.contracted(), inner, result);
+
+    const auto solved = Clock::now();
+    ws.chains.expandTour(result.edgeOrder, ws.expanded);
+    result.edgeOrder.swap(ws.expanded);
+    ws.chains.expandEdges(result.duplicateEdgeIds, ws.expanded);
+    result.duplicateEdgeIds.swap(ws.expanded);
+    const auto done = Clock::now();
+
+    // Phases of the reduced solve shift behind the contraction
+    SolverStats &stats = result.stats;
+    const double contractMs = ms(start, contracted);
+    for (PhaseStats &p : stats.phases) p.startMs += contractMs;
+    PhaseStats chains;
+    chains.name = "chains";
+    chains.wallMs = contractMs;
+    stats.phases.insert(stats.phases.begin(), chains);
+    PhaseStats expand;
+    expand.name = "expand";
+    expand.startMs = ms(start, solved);
+    expand.wallMs = ms(solved, done);
+    expand.peakBytes = (result.edgeOrder.capacity() + ws.expanded.capacity()) * sizeof(int);
+    stats.phases.push_back(expand);
+    stats.totalMs = ms(start, done);
+    stats.chainVertices = ws.chains.removedVertexCount();
+    return true;
+}
+}
 
 /* ============================================================
    Hàm solve() — Chinese Postman Problem cho đồ thị vô hướng
+   (đồ thị có cạnh một chiều: MixedPostman; có cạnh không bắt
+   buộc: RuralPostman)
    ============================================================ */
-ChinesePostmanResult ChinesePostmanOptimal::solve(const Graph &g) {
+ChinesePostmanResult ChinesePostmanOptimal::solve(const Graph &g, const ChinesePostmanOptions &options) {
+    SolverContext ctx;
+    return solve(ctx, g, options);
+}
+
+ChinesePostmanResult ChinesePostmanOptimal::solve(SolverContext &ctx, const Graph &g,
+                                                  const ChinesePostmanOptions &options) {
     ChinesePostmanResult result;
+    solveInto(ctx, g, options, result);
+    return result;
+}
+
+void ChinesePostmanOptimal::solveInto(SolverContext &ctx, const Graph &g,
+                                      const ChinesePostmanOptions &options,
+                                      ChinesePostmanResult &result) {
+    result.edgeOrder.clear();
+    result.duplicateEdgeIds.clear();
+    result.vertexOrder.clear();
+    result.isCycle = false;
+    result.cancelled = false;
+    result.stats.phases.clear();
+    result.stats.oddVertices = 0;
+    result.stats.matchingCost = 0.0;
+    result.stats.totalMs = 0.0;
+    result.stats.threads = 1;
+    result.stats.integerWeights = false;
+    result.stats.hierarchy = false;
+    result.stats.dense = false;
+    result.stats.chainVertices = 0;
+    result.stats.requiredParts = 0;
+    result.stats.connectorEdges = 0;
+
+    // One-way streets: in/out degrees are balanced by a min-cost flow
+    // instead of matching odd vertices (an empty route when some street
+    // is optional too)
+    if (g.hasDirectedEdges()) {
+        MixedPostman::solveInto(ctx, g, options, result);
+        publish(ctx, result);
+        return;
+    }
+    // Optional streets: only the required ones must be covered
+    if (g.hasOptionalEdges()) {
+        RuralPostman::solveInto(ctx, g, options, result);
+        publish(ctx, result);
+        return;
+    }
+    if (options.contractChains && !(options.hierarchy && options.hierarchy->matches(g))) {
+        if (solveContracted(ctx, g, options, result)) {
+            publish(ctx, result);
+            return;
+        }
+    }
+    solveSteps(ctx, g, options, result);
+    publish(ctx, result);
+}
+
+namespace {
+void solveSteps(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                ChinesePostmanResult &result) {
+    PostmanWorkspace &ws = ctx.postman;
     const auto &verts = g.getVertices();
     const auto &edges = g.getEdges();
-    if (verts.empty() || edges.empty()) return result;
-
-    // --- B1. Tính bậc các đỉnh ---
-    std::vector<int> degree(verts.size(), 0);
-    for (const auto &e : edges) {
-        if (e.u >= 0 && e.v >= 0 &&
-            e.u < (int)verts.size() && e.v < (int)verts.size()) {
-            degree[e.u]++;
-            degree[e.v]++;
-        }
+    if (verts.empty() || edges.empty()) return;
+
+    PhaseClock clock(result.stats);
+    auto report = [&options](const char *phase, int done, int total) {
+        if (options.progress) options.progress(phase, done, total);
+    };
+    auto cancelled = [&options, &result]() {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed))
+            result.cancelled = true;
+        return result.cancelled;
+    };
+
+    // --- B1. Tính bậc các đỉnh (CSR snapshot, dùng chung cho B3) ---
+    // Whole-number weights get an integer CSR, so B3 runs on the radix
+    // heap; the Euler steps only need the topology, shared by both.
+    report("csr", 0, 1);
+    const bool integerWeights = ShortestPaths::hasIntegerWeights(edges);
+    result.stats.integerWeights = integerWeights;
+    std::size_t csrBytes = 0;
+    if (integerWeights) {
+        ws.integerCsr.assign(edges, static_cast<int>(verts.size()));
+        csrBytes = bytesOf(ws.integerCsr.weights);
+    } else {
+        ws.csr.assign(edges, static_cast<int>(verts.size()));
+        csrBytes = bytesOf(ws.csr.weights);
     }
+    const CsrTopology &csr = integerWeights ? static_cast<const CsrTopology &>(ws.integerCsr) : ws.csr;
+    csrBytes += bytesOf(csr.offsets) + bytesOf(csr.neighbors) + bytesOf(csr.edgeIds);
+    clock.mark("csr").peakBytes = csrBytes;
 
     // --- B2. Tìm các đỉnh bậc lẻ ---
-    std::vector<int> oddVertices;
-    for (size_t i = 0; i < degree.size(); ++i)
-        if (degree[i] % 2 != 0)
-            oddVertices.push_back((int)i);
+    if (cancelled()) return;
+    std::vector<int> &oddVertices = ws.oddVertices;
+    oddVertices.clear();
+    for (int i = 0; i < csr.vertexCount(); ++i)
+        if (csr.degree(i) % 2 != 0)
+            oddVertices.push_back(i);
+    result.stats.oddVertices = static_cast<int>(oddVertices.size());
+    clock.mark("odd_vertices").peakBytes = csrBytes + bytesOf(oddVertices);
+
+    AugmentedGraph &augmented = ws.augmented;
+    augmented.reset(g);
 
     // Nếu không có đỉnh bậc lẻ → Eulerian circuit
     if (oddVertices.empty()) {
-        auto euler = Algorithms::findEulerTourHierholzer(g);
-        if (euler) result.edgeOrder = euler->edgeOrder;
-        return result;
+        report("euler", 0, 1);
+        if (!Algorithms::findEulerTourHierholzer(ctx, augmented, csr, result.edgeOrder, result.isCycle))
+            result.edgeOrder.clear();
+        clock.mark("euler").peakBytes = csrBytes + bytesOf(result.edgeOrder);
+        return;
     }
 
     // --- B3. Tính khoảng cách ngắn nhất giữa các đỉnh lẻ ---
-    int n = oddVertices.size();
-    std::vector<std::vector<double>> dist(n, std::vector<double>(n, 1e9));
-    std::vector<std::vector<std::vector<int>>> path(n, std::vector<std::vector<int>>(n));
-
-    for (int i = 0; i < n; ++i) {
-        int start = oddVertices[i];
-        // Dijkstra
-        std::vector<double> d(verts.size(), 1e9);
-        std::vector<int> parent(verts.size(), -1);
-        d[start] = 0;
-        using P = std::pair<double, int>;
-        std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
-        pq.push({0, start});
-        while (!pq.empty()) {
-            auto [du, u] = pq.top(); pq.pop();
-            if (du != d[u]) continue;
-            for (const auto &e : edges) {
-                int v = (e.u == u ? e.v : (e.v == u ? e.u : -1));
-                if (v == -1) continue;
-                double w = e.weight;
-                if (d[v] > d[u] + w) {
-                    d[v] = d[u] + w;
-                    parent[v] = u;
-                    pq.push({d[v], v});
-                }
+    const int n = static_cast<int>(oddVertices.size());
+    std::vector<double> &dist = ws.distances;     // n × n, row-major
+    dist.assign(static_cast<std::size_t>(n) * n, 1e9);
+    // Only one predecessor-edge tree per source is kept (n·V ints); the
+    // few paths the matching actually picks are expanded in B5. Rows
+    // past n stay allocated for the next, possibly larger, solve.
+    std::vector<std::vector<int>> &parentEdge = ws.parentEdge;
+
+    // A hierarchy built from this very graph answers the whole matrix
+    // with one bucket table (upward searches only) and keeps no trees;
+    // B5 then unpacks the matched paths from it. Small dense graphs get
+    // Floyd–Warshall on all vertices instead, with the paths recovered
+    // from the all-pairs distances. Otherwise one independent Dijkstra
+    // per odd vertex, spread over a work-stealing executor. Source i
+    // only writes row i, so the output is deterministic.
+    const ContractionHierarchy *hierarchy =
+        options.hierarchy && options.hierarchy->matches(g) ? options.hierarchy : nullptr;
+    const int vertexCount = csr.vertexCount();
+    const bool dense = !hierarchy && vertexCount <= DenseGraph::kMaxVertices
+        && (options.dense == DenseMode::Always
+            || (options.dense == DenseMode::Auto
+                && DenseGraph::shouldUse(vertexCount, static_cast<int>(edges.size()), n)));
+    result.stats.hierarchy = hierarchy != nullptr;
+    result.stats.dense = dense;
+    ParallelExecutor executor(options.threads);
+    result.stats.threads = executor.workerCount();
+    std::atomic<int> sourcesDone{0};
+    PhaseStats counters;  // summed over the workers
+    report("shortest_paths", 0, n);
+    auto runSources = [&](const auto &weightedCsr, auto &buffers) {
+        using W = typename std::decay_t<decltype(weightedCsr)>::Weight;
+        if (buffers.size() < executor.workerCount()) buffers.resize(executor.workerCount());
+        for (auto &buf : buffers) buf.pushes = buf.pops = buf.relaxed = 0;
+        executor.parallelFor(n, [&](int i, unsigned worker) {
+            if (options.cancel && options.cancel->load(std::memory_order_relaxed)) return;
+            auto &buf = buffers[worker];
+            ShortestPaths::dijkstra(weightedCsr, oddVertices[i], buf);
+            double *row = &dist[static_cast<std::size_t>(i) * n];
+            for (int j = 0; j < n; ++j) {
+                W d = buf.dist[oddVertices[j]];
+                row[j] = d == ShortestPaths::unreachable<W>() ? 1e9 : static_cast<double>(d);
             }
+            parentEdge[i].assign(buf.parentEdge.begin(), buf.parentEdge.end());
+            int done = ++sourcesDone;
+            if (done * 20 / n != (done - 1) * 20 / n) report("shortest_paths", done, n);
+        });
+        for (unsigned w = 0; w < executor.workerCount(); ++w) {
+            counters.heapPushes += buffers[w].pushes;
+            counters.heapPops += buffers[w].pops;
+            counters.edgesRelaxed += buffers[w].relaxed;
+            counters.peakBytes += buffers[w].bytes();
         }
-        for (int j = 0; j < n; ++j) {
-            int end = oddVertices[j];
-            dist[i][j] = d[end];
-            if (d[end] < 1e9) {
-                // reconstruct path
-                int v = end;
-                std::vector<int> rev;
-                while (v != -1) {
-                    rev.push_back(v);
-                    v = parent[v];
-                }
-                std::reverse(rev.begin(), rev.end());
-                path[i][j] = rev;
-            }
+    };
+    std::size_t treeBytes = 0;
+    if (hierarchy) {
+        for (auto &scratch : ctx.hierarchy) {
+            scratch.forward.pushes = scratch.forward.pops = scratch.forward.relaxed = 0;
+            scratch.backward.pushes = scratch.backward.pops = scratch.backward.relaxed = 0;
+        }
+        hierarchy->table(oddVertices, oddVertices, dist, executor, ctx.hierarchy);
+        for (double &d : dist)
+            if (d == std::numeric_limits<double>::infinity()) d = 1e9;
+        for (const auto &scratch : ctx.hierarchy) {
+            counters.heapPushes += scratch.forward.pushes + scratch.backward.pushes;
+            counters.heapPops += scratch.forward.pops + scratch.backward.pops;
+            counters.edgesRelaxed += scratch.forward.relaxed + scratch.backward.relaxed;
+            counters.peakBytes += scratch.forward.bytes() + scratch.backward.bytes()
+                                + bytesOf(scratch.settledList);
         }
+    } else if (dense) {
+        // Word-parallel BFS first: a disconnected graph has no tour, so
+        // the all-pairs pass would be wasted
+        ws.dense.adjacency.assign(csr);
+        if (!DenseGraph::isConnected(csr, ws.dense)) {
+            clock.mark("shortest_paths").peakBytes = csrBytes + DenseGraph::bytes(ws.dense);
+            return;
+        }
+        if (!DenseGraph::allPairs(edges, vertexCount, executor, ws.dense, options.cancel)) {
+            result.cancelled = true;
+            return;
+        }
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) {
+                const double d = ws.dense.distance(oddVertices[i], oddVertices[j]);
+                dist[static_cast<std::size_t>(i) * n + j] = d == std::numeric_limits<double>::infinity() ? 1e9 : d;
+            }
+        counters.peakBytes = DenseGraph::bytes(ws.dense);
+    } else {
+        if (static_cast<int>(parentEdge.size()) < n) parentEdge.resize(n);
+        if (integerWeights) runSources(ws.integerCsr, ctx.integerDijkstra);
+        else runSources(ws.csr, ctx.dijkstra);
+        for (int i = 0; i < n; ++i) treeBytes += bytesOf(parentEdge[i]);
     }
 
-    // --- B4. Tìm ghép đôi tối ưu (min weight matching) ---
-    double bestCost = 1e9;
-    std::vector<int> bestMatch;
-    std::vector<int> perm(n);
-    for (int i = 0; i < n; ++i) perm[i] = i;
-
-    do {
-        double cost = 0;
-        for (int i = 0; i < n; i += 2)
-            cost += dist[perm[i]][perm[i + 1]];
-        if (cost < bestCost) {
-            bestCost = cost;
-            bestMatch = perm;
-        }
-    } while (std::next_permutation(perm.begin(), perm.end()));
-
-    // --- B5. Tạo đồ thị mới có thêm cạnh duplicated ---
-    Graph augmented = g;
-    for (int i = 0; i < n; i += 2) {
-        int uIdx = bestMatch[i];
-        int vIdx = bestMatch[i + 1];
-        const auto &p = path[uIdx][vIdx];
-        for (size_t k = 0; k + 1 < p.size(); ++k) {
-            int u = p[k];
-            int v = p[k + 1];
-            // tìm cạnh gốc giữa u-v
-            for (const auto &e : edges) {
-                if ((e.u == u && e.v == v) || (e.u == v && e.v == u)) {
-                    augmented.addEdge(u, v, e.weight);
-                    result.duplicateEdgeIds.push_back(e.id); // ✅ lưu id cạnh gốc bị duplicate
-                    break;
-                }
+    PhaseStats &sp = clock.mark("shortest_paths");
+    const std::size_t matrixBytes = bytesOf(dist);
+    sp.heapPushes = counters.heapPushes;
+    sp.heapPops = counters.heapPops;
+    sp.edgesRelaxed = counters.edgesRelaxed;
+    sp.peakBytes = csrBytes + matrixBytes + treeBytes + counters.peakBytes;
+    if (cancelled()) return;
+
+    // --- B4. Tìm ghép đôi tối ưu (min weight perfect matching) ---
+    // Weighted blossom on the odd-vertex distance matrix, O(n^3).
+    report("matching", 0, 1);
+    std::vector<int> &mate = ws.mate;
+    bool matched = MinWeightMatching::solve(dist, n, mate, ws.matching, 1e9, options.cancel);
+    if (matched) result.stats.matchingCost = MinWeightMatching::matchingCost(dist, n, mate);
+    clock.mark("matching").peakBytes = csrBytes + matrixBytes + treeBytes + bytesOf(mate);
+    if (cancelled() || !matched) return;  // một số đỉnh lẻ không tới được nhau
+
+    // --- B5. Overlay: đồ thị gốc + số lần duplicate của mỗi cạnh ---
+    report("augment", 0, 1);
+    // Walk the source's predecessor tree from the partner back to the
+    // source (or unpack the hierarchy path between them), emitting each
+    // edge id as one duplicated traversal.
+    for (int uIdx = 0; uIdx < n; ++uIdx) {
+        int vIdx = mate[uIdx];
+        if (vIdx < uIdx) continue;
+        if (hierarchy || dense) {
+            if (hierarchy) {
+                hierarchy->path(oddVertices[uIdx], oddVertices[vIdx], ctx.hierarchy[0], ws.pathEdges);
+            } else {
+                ws.pathEdges.clear();
+                DenseGraph::appendPath(csr, edges, oddVertices[uIdx], oddVertices[vIdx], ws.dense, ws.pathEdges);
             }
+            for (int eid : ws.pathEdges) {
+                augmented.duplicate(eid);
+                result.duplicateEdgeIds.push_back(eid);
+            }
+            continue;
+        }
+        const auto &tree = parentEdge[uIdx];
+        for (int v = oddVertices[vIdx]; v != oddVertices[uIdx];) {
+            int eid = tree[v];
+            const Edge &e = edges[eid];
+            augmented.duplicate(eid);
+            result.duplicateEdgeIds.push_back(eid); // ✅ lưu id cạnh gốc bị duplicate
+            v = (e.u == v) ? e.v : e.u;
         }
     }
+    clock.mark("augment").peakBytes = csrBytes + treeBytes + bytesOf(result.duplicateEdgeIds)
+        + augmented.duplicatedEdges().size() * sizeof(int);
 
     // --- B6. Tìm chu trình Euler trên đồ thị augmented ---
-    auto euler = Algorithms::findEulerTourHierholzer(augmented);
-    if (euler)
-        result.edgeOrder = euler->edgeOrder;
-
-    return result;
+    report("euler", 0, 1);
+    if (!Algorithms::findEulerTourHierholzer(ctx, augmented, csr, result.edgeOrder, result.isCycle))
+        result.edgeOrder.clear();
+    clock.mark("euler").peakBytes = csrBytes + bytesOf(result.edgeOrder);
+}
 }
@@ -1,19 +1,70 @@
 #pragma once
+#include <atomic>
+#include <functional>
 #include <vector>
 #include "Graph.h"
 #include "Algorithms.h"
+#include "SolverContext.h"
+#include "SolverStats.h"
 
 struct ChinesePostmanResult {
+    // Tour as original edge ids; a duplicated edge appears once per traversal
     std::vector<int> edgeOrder;
+    // One entry per extra traversal (ids of the original edges that repeat)
     std::vector<int> duplicateEdgeIds;
     std::vector<int> vertexOrder;
     bool isCycle{false};
+    bool cancelled{false};
+    SolverStats stats;
+};
+
+// Dense mode (DenseGraph.h): Floyd–Warshall instead of one Dijkstra
+// per odd vertex. Auto decides by size and density; Always still
+// needs at most DenseGraph::kMaxVertices vertices.
+enum class DenseMode { Auto, Never, Always };
 
-    // 🔹 Đồ thị có chứa thông tin cạnh duplicate
-    Graph graphWithDuplicates;
+struct ChinesePostmanOptions {
+    // Worker threads for the odd-vertex shortest paths (0 = all cores)
+    unsigned threads{0};
+    // Cooperative cancellation, polled between phases, per Dijkstra
+    // source and per matching stage. A cancelled solve returns an
+    // empty route with cancelled = true.
+    const std::atomic<bool> *cancel{nullptr};
+    // progress(phase, done, total): once when each phase starts and,
+    // during "shortest_paths", every ~5% of the sources. It may run
+    // on executor worker threads.
+    std::function<void(const char *phase, int done, int total)> progress;
+    // Precomputed index for the odd-vertex distances and paths; used
+    // only when it matches the graph being solved, otherwise B3 falls
+    // back to one Dijkstra per odd vertex.
+    const ContractionHierarchy *hierarchy{nullptr};
+    // Ignored while a matching hierarchy is in use
+    DenseMode dense{DenseMode::Auto};
+    // Solve with every maximal chain of degree-2 vertices collapsed
+    // into one edge (ChainContraction.h), then expand the tour back to
+    // the original edges. Same cost, much smaller B3/B4 on surveyed
+    // street maps; skipped when a matching hierarchy is given. The
+    // contraction pass allocates on every solve.
+    bool contractChains{false};
 };
 
 class ChinesePostmanOptimal {
 public:
-    static ChinesePostmanResult solve(const Graph &g);
+    // Scratch buffers come from ctx; the route is also kept in
+    // ctx.lastPostman and the stats in ctx.stats. A graph with directed
+    // edges is solved by MixedPostman (MixedPostman.h), which drives
+    // them u → v only; one with optional streets (every street still
+    // two-way) by RuralPostman (RuralPostman.h), which covers only the
+    // required ones. One-way and optional streets together are not
+    // supported: the route is empty.
+    static ChinesePostmanResult solve(SolverContext &ctx, const Graph &g,
+                                      const ChinesePostmanOptions &options = {});
+    // Same, writing into `result` and reusing its capacity. With a
+    // warm context and threads = 1 this performs no heap allocation
+    // (undirected graphs; with one-way streets only MixedPostman's
+    // flow stage is allocation free, its parity step is not).
+    static void solveInto(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                          ChinesePostmanResult &result);
+    // One-off solve on a private context
+    static ChinesePostmanResult solve(const Graph &g, const ChinesePostmanOptions &options = {});
 };
@@ -0,0 +1,282 @@
+#include "Components.h"
+#include "ParallelExecutor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Local edge / vertex ids of a component solve back to the original graph
+void mapToOriginal(const GraphComponents &comps, int c, std::vector<int> &edgeIds,
+                   std::vector<int> &vertexIds) {
+    for (int &eid : edgeIds) eid = comps.edgeId(c, eid);
+    for (int &v : vertexIds) v = comps.vertexId(c, v);
+}
+
+// Adds a component's phases into the merged stats (same name → summed)
+void mergeStats(SolverStats &into, const SolverStats &from) {
+    for (const PhaseStats &p : from.phases) {
+        auto it = std::find_if(into.phases.begin(), into.phases.end(),
+                               [&p](const PhaseStats &q) { return q.name == p.name; });
+        if (it == into.phases.end()) {
+            into.phases.push_back(p);
+            continue;
+        }
+        it->wallMs += p.wallMs;
+        it->heapPushes += p.heapPushes;
+        it->heapPops += p.heapPops;
+        it->edgesRelaxed += p.edgesRelaxed;
+        it->peakBytes = std::max(it->peakBytes, p.peakBytes);
+    }
+    into.oddVertices += from.oddVertices;
+    into.chainVertices += from.chainVertices;
+    into.requiredParts += from.requiredParts;
+    into.connectorEdges += from.connectorEdges;
+    into.matchingCost += from.matchingCost;
+    into.integerWeights = into.integerWeights || from.integerWeights;
+    into.hierarchy = into.hierarchy || from.hierarchy;
+    into.dense = into.dense || from.dense;
+}
+}
+
+/* ============================================================
+   UnionFind
+   ============================================================ */
+void UnionFind::reset(int n) {
+    parent.resize(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    size.assign(n, 1);
+}
+
+int UnionFind::find(int x) {
+    // Path halving: every other node on the way up skips its parent
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+bool UnionFind::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (size[a] < size[b]) std::swap(a, b);
+    parent[b] = a;
+    size[a] += size[b];
+    return true;
+}
+
+/* ============================================================
+   GraphComponents
+   ============================================================ */
+GraphComponents GraphComponents::of(const Graph &g) {
+    const auto &edges = g.getEdges();
+    const int n = static_cast<int>(g.getVertices().size());
+    GraphComponents comps;
+    comps.componentOf.assign(n, -1);
+    comps.localIndex.assign(n, -1);
+    comps.vertexOffsets.assign(1, 0);
+    comps.edgeOffsets.assign(1, 0);
+
+    // --- B1. Gộp hai đầu mút của mọi cạnh ---
+    UnionFind sets(n);
+    std::vector<char> touched(n, 0);
+    for (const Edge &e : edges) {
+        sets.unite(e.u, e.v);
+        touched[e.u] = touched[e.v] = 1;
+    }
+
+    // --- B2. Đánh số tạm theo gốc, đếm cạnh mỗi thành phần ---
+    std::vector<int> rootComponent(n, -1);
+    std::vector<int> edgeCounts;
+    for (int v = 0; v < n; ++v) {
+        if (!touched[v]) continue;
+        int &c = rootComponent[sets.find(v)];
+        if (c < 0) {
+            c = static_cast<int>(edgeCounts.size());
+            edgeCounts.push_back(0);
+        }
+    }
+    for (const Edge &e : edges) ++edgeCounts[rootComponent[sets.find(e.u)]];
+
+    // --- B3. Thành phần lớn nhất trước (ổn định theo đỉnh nhỏ nhất) ---
+    const int count = static_cast<int>(edgeCounts.size());
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&edgeCounts](int a, int b) { return edgeCounts[a] > edgeCounts[b]; });
+    std::vector<int> rank(count);
+    for (int i = 0; i < count; ++i) rank[order[i]] = i;
+
+    // --- B4. Gom đỉnh và cạnh theo thành phần (counting sort) ---
+    std::vector<int> vertexCounts(count, 0);
+    for (int v = 0; v < n; ++v) {
+        if (!touched[v]) continue;
+        comps.componentOf[v] = rank[rootComponent[sets.find(v)]];
+        ++vertexCounts[comps.componentOf[v]];
+    }
+    comps.vertexOffsets.resize(count + 1);
+    comps.edgeOffsets.resize(count + 1);
+    for (int c = 0; c < count; ++c) {
+        comps.vertexOffsets[c + 1] = comps.vertexOffsets[c] + vertexCounts[c];
+        comps.edgeOffsets[c + 1] = comps.edgeOffsets[c] + edgeCounts[order[c]];
+    }
+    comps.vertexIds.resize(comps.vertexOffsets[count]);
+    comps.edgeIds.resize(comps.edgeOffsets[count]);
+    std::vector<int> fill(comps.vertexOffsets.begin(), comps.vertexOffsets.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        const int c = comps.componentOf[v];
+        if (c < 0) continue;
+        comps.localIndex[v] = fill[c] - comps.vertexOffsets[c];
+        comps.vertexIds[fill[c]++] = v;
+    }
+    fill.assign(comps.edgeOffsets.begin(), comps.edgeOffsets.end() - 1);
+    for (int i = 0; i < static_cast<int>(edges.size()); ++i)
+        comps.edgeIds[fill[comps.componentOf[edges[i].u]]++] = i;
+    return comps;
+}
+
+void GraphComponents::extract(const Graph &g, int c, Graph &out) const {
+    const auto &verts = g.getVertices();
+    const auto &edges = g.getEdges();
+    out.clear();
+    for (int i = 0; i < vertexCount(c); ++i) {
+        const Vertex &v = verts[vertexId(c, i)];
+        out.addVertex(v.position, v.name);
+    }
+    for (int i = 0; i < edgeCount(c); ++i) {
+        const Edge &e = edges[edgeId(c, i)];
+        const int id = out.addEdge(localIndex[e.u], localIndex[e.v], e.weight, e.directed);
+        out.getEdges()[id].required = e.required;
+    }
+}
+
+/* ============================================================
+   ComponentSolver
+   ============================================================ */
+ComponentSolver::PostmanRoutes ComponentSolver::postman(SolverContext &ctx, const Graph &g,
+                                                        const ChinesePostmanOptions &options) {
+    const auto start = Clock::now();
+    PostmanRoutes out;
+    out.components = GraphComponents::of(g);
+    const GraphComponents &comps = out.components;
+    const int count = comps.count();
+    PhaseStats analysis;
+    analysis.name = "components";
+    analysis.wallMs = msSince(start);
+    analysis.peakBytes = (comps.componentOf.size() * 2 + comps.vertexIds.size() + comps.edgeIds.size()
+                          + comps.vertexOffsets.size() + comps.edgeOffsets.size()) * sizeof(int);
+    out.stats.phases.push_back(analysis);
+
+    // With optional streets a component without a required one has
+    // nothing to inspect and gets no route
+    std::vector<char> inspect(count, 1);
+    if (g.hasOptionalEdges()) {
+        const auto &edges = g.getEdges();
+        for (int c = 0; c < count; ++c) {
+            inspect[c] = 0;
+            for (int i = 0; i < comps.edgeCount(c) && !inspect[c]; ++i)
+                inspect[c] = edges[comps.edgeId(c, i)].required;
+        }
+    }
+
+    // --- Một thành phần: giải trực tiếp trên đồ thị gốc ---
+    if (count == 1 && inspect[0]) {
+        out.routes.push_back(ChinesePostmanOptimal::solve(ctx, g, options));
+        out.cancelled = out.routes[0].cancelled;
+        mergeStats(out.stats, out.routes[0].stats);
+        out.stats.threads = out.routes[0].stats.threads;
+        out.stats.totalMs = msSince(start);
+        ctx.stats = out.stats;
+        return out;
+    }
+
+    // --- Nhiều thành phần: mỗi worker giải trọn một thành phần ---
+    ParallelExecutor executor(options.threads);
+    const unsigned workers = std::min<unsigned>(executor.workerCount(), static_cast<unsigned>(std::max(count, 1)));
+    if (ctx.workerContexts.size() + 1 < workers) ctx.workerContexts.resize(workers - 1);
+    std::vector<Graph> subgraphs(workers);
+    out.routes.resize(count);
+    ChinesePostmanOptions single = options;
+    single.threads = 1;
+    single.progress = nullptr;
+    std::atomic<int> solved{0};
+    if (options.progress) options.progress("components", 0, count);
+    executor.parallelFor(count, [&](int c, unsigned worker) {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+            out.routes[c].cancelled = true;
+            return;
+        }
+        if (!inspect[c]) return;
+        SolverContext &local = worker == 0 ? ctx : ctx.workerContexts[worker - 1];
+        Graph &sub = subgraphs[worker];
+        comps.extract(g, c, sub);
+        ChinesePostmanResult &route = out.routes[c];
+        ChinesePostmanOptimal::solveInto(local, sub, single, route);
+        mapToOriginal(comps, c, route.edgeOrder, route.vertexOrder);
+        for (int &eid : route.duplicateEdgeIds) eid = comps.edgeId(c, eid);
+        const int done = ++solved;
+        if (options.progress) options.progress("components", done, count);
+    });
+
+    for (const ChinesePostmanResult &route : out.routes) {
+        out.cancelled = out.cancelled || route.cancelled;
+        mergeStats(out.stats, route.stats);
+    }
+    int kept = 0;
+    for (int c = 0; c < count; ++c)
+        if (inspect[c]) {
+            if (kept != c) out.routes[kept] = std::move(out.routes[c]);
+            ++kept;
+        }
+    out.routes.resize(kept);
+    out.stats.threads = workers;
+    out.stats.totalMs = msSince(start);
+    ctx.stats = out.stats;
+    // ctx.lastPostman keeps the largest component's route
+    if (!out.routes.empty() && !out.routes[0].edgeOrder.empty()) {
+        if (!ctx.lastPostman) ctx.lastPostman.emplace();
+        ctx.lastPostman->edgeOrder = out.routes[0].edgeOrder;
+        ctx.lastPostman->isCycle = out.routes[0].isCycle;
+        ctx.lastPostman->vertexOrder.clear();
+    } else {
+        ctx.lastPostman.reset();
+    }
+    return out;
+}
+
+ComponentSolver::EulerRoutes ComponentSolver::euler(SolverContext &ctx, const Graph &g, unsigned threads) {
+    EulerRoutes out;
+    out.components = GraphComponents::of(g);
+    const GraphComponents &comps = out.components;
+    const int count = comps.count();
+    if (count == 1) {
+        out.routes.push_back(Algorithms::findEulerTourHierholzer(ctx, g));
+        return out;
+    }
+
+    ParallelExecutor executor(threads);
+    const unsigned workers = std::min<unsigned>(executor.workerCount(), static_cast<unsigned>(std::max(count, 1)));
+    if (ctx.workerContexts.size() + 1 < workers) ctx.workerContexts.resize(workers - 1);
+    std::vector<Graph> subgraphs(workers);
+    out.routes.resize(count);
+    executor.parallelFor(count, [&](int c, unsigned worker) {
+        SolverContext &local = worker == 0 ? ctx : ctx.workerContexts[worker - 1];
+        Graph &sub = subgraphs[worker];
+        comps.extract(g, c, sub);
+        auto &route = out.routes[c];
+        route = Algorithms::findEulerTourHierholzer(local, sub);
+        if (route) mapToOriginal(comps, c, route->edgeOrder, route->vertexOrder);
+    });
+    // ctx.lastEuler keeps the largest component's route
+    if (count > 0) ctx.lastEuler = out.routes[0];
+    else ctx.lastEuler.reset();
+    return out;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <optional>
+#include <vector>
+#include "Graph.h"
+#include "ChinesePostman.h"
+#include "SolverContext.h"
+
+/* ============================================================
+   Components — disjoint sectors solved one by one
+   ------------------------------------------------------------
+   Imported maps often hold several pieces that no street joins
+   (islands across a river, districts cut at the map border).
+   Euler and postman tours only exist per piece, so the graph is
+   split into connected components with a union-find over the
+   edge list (path halving + union by size, no recursion, near
+   linear), every component with at least one edge is copied
+   into a compact Graph, and each copy is solved on its own:
+     - one component: the plain solve on the original graph,
+       with every option (threads, hierarchy, dense) intact;
+     - several: components go to a ParallelExecutor, largest
+       first, each one a single-threaded solve on its worker's
+       SolverContext.
+   Every route is reported in the ids of the original graph.
+   Isolated vertices belong to no component.
+   ============================================================ */
+
+// Disjoint-set forest over 0..n-1
+class UnionFind {
+public:
+    explicit UnionFind(int n = 0) { reset(n); }
+
+    void reset(int n);
+    int find(int x);
+    // false when a and b were already in the same set
+    bool unite(int a, int b);
+    int setSize(int x) { return size[find(x)]; }
+
+private:
+    std::vector<int> parent;
+    std::vector<int> size;
+};
+
+struct GraphComponents {
+    // Per vertex: component (-1 when isolated) and index inside it
+    std::vector<int> componentOf;
+    std::vector<int> localIndex;
+    // Component c owns vertexIds[vertexOffsets[c] .. vertexOffsets[c + 1])
+    // and edgeIds[edgeOffsets[c] .. edgeOffsets[c + 1]], both ascending.
+    // Components are numbered by edge count, largest first.
+    std::vector<int> vertexOffsets;
+    std::vector<int> vertexIds;
+    std::vector<int> edgeOffsets;
+    std::vector<int> edgeIds;
+
+    static GraphComponents of(const Graph &g);
+
+    int count() const { return vertexOffsets.empty() ? 0 : static_cast<int>(vertexOffsets.size()) - 1; }
+    int vertexCount(int c) const { return vertexOffsets[c + 1] - vertexOffsets[c]; }
+    int edgeCount(int c) const { return edgeOffsets[c + 1] - edgeOffsets[c]; }
+    // Original id of local vertex / edge i of component c
+    int vertexId(int c, int i) const { return vertexIds[vertexOffsets[c] + i]; }
+    int edgeId(int c, int i) const { return edgeIds[edgeOffsets[c] + i]; }
+
+    // Component c as a graph of its own (vertices and edges renumbered
+    // in ascending original order, names and positions kept)
+    void extract(const Graph &g, int c, Graph &out) const;
+};
+
+namespace ComponentSolver {
+
+struct PostmanRoutes {
+    GraphComponents components;
+    // routes[c] covers component c, in ids of the original graph.
+    // When some streets are optional (RuralPostman.h) components
+    // without a required street are skipped: the routes then follow
+    // the remaining components in order.
+    std::vector<ChinesePostmanResult> routes;
+    bool cancelled{false};
+    // Phases merged by name over the components (times summed, so they
+    // are CPU time when components ran concurrently); totalMs is wall
+    // time including the component analysis
+    SolverStats stats;
+};
+
+struct EulerRoutes {
+    GraphComponents components;
+    // nullopt for a component without an Euler path/cycle
+    std::vector<std::optional<EulerResult>> routes;
+};
+
+// options.threads workers (0 = all cores) over the components; the
+// progress callback reports ("components", solved, total) instead of
+// the per-phase progress when there is more than one
+PostmanRoutes postman(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options = {});
+
+EulerRoutes euler(SolverContext &ctx, const Graph &g, unsigned threads = 0);
+
+}
@@ -0,0 +1,540 @@
+#include "ContractionHierarchy.h"
+#include "ParallelExecutor.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace {
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+constexpr char kMagic[4] = {'T', 'P', 'C', 'H'};
+constexpr std::uint32_t kFormatVersion = 1;
+
+// Neighbours above this degree are not simulated when ranking: the
+// pair count is used as the (pessimistic) shortcut estimate, so hubs
+// simply end up near the top of the hierarchy
+constexpr int kExactDegree = 100;
+// Witness searches while ranking only estimate the shortcut count
+constexpr int kEstimateSettleLimit = 40;
+// A vertex this dense is never contracted: once the least important
+// vertex left is above it, the rest stays as a core that queries
+// search like plain Dijkstra (guards against shortcut blow-up on
+// hub-heavy graphs)
+constexpr int kCoreDegree = 128;
+
+// Link of the shrinking graph during contraction
+struct Link {
+    int to;
+    int arc;
+    double weight;
+};
+
+template <typename T>
+void writeVector(std::ofstream &out, const std::vector<T> &v) {
+    const std::uint64_t n = v.size();
+    out.write(reinterpret_cast<const char *>(&n), sizeof(n));
+    if (n) out.write(reinterpret_cast<const char *>(v.data()), static_cast<std::streamsize>(n * sizeof(T)));
+}
+
+template <typename T>
+bool readVector(std::ifstream &in, std::vector<T> &v, std::uint64_t maxSize) {
+    std::uint64_t n = 0;
+    if (!in.read(reinterpret_cast<char *>(&n), sizeof(n)) || n > maxSize) return false;
+    v.resize(static_cast<std::size_t>(n));
+    return n == 0 || static_cast<bool>(in.read(reinterpret_cast<char *>(v.data()),
+                                               static_cast<std::streamsize>(n * sizeof(T))));
+}
+}
+
+/* ============================================================
+   Build — thứ tự co đỉnh + shortcut
+   ============================================================ */
+ContractionHierarchy ContractionHierarchy::build(const Graph &g, const HierarchyBuildOptions &options) {
+    const int n = static_cast<int>(g.getVertices().size());
+    ContractionHierarchy ch;
+    ch.graphFingerprint = fingerprintOf(g);
+
+    // --- B1. Cạnh nhẹ nhất cho mỗi cặp đỉnh, bỏ self-loop ---
+    std::vector<Arc> &arcs = ch.arcs;
+    {
+        std::vector<Arc> candidates;
+        for (const auto &e : g.getEdges()) {
+            if (e.u == e.v || e.u < 0 || e.v < 0 || e.u >= n || e.v >= n) continue;
+            Arc arc;
+            arc.a = std::min(e.u, e.v);
+            arc.b = std::max(e.u, e.v);
+            arc.weight = e.weight;
+            arc.edgeId = e.id;
+            candidates.push_back(arc);
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Arc &x, const Arc &y) {
+            if (x.a != y.a) return x.a < y.a;
+            if (x.b != y.b) return x.b < y.b;
+            if (x.weight != y.weight) return x.weight < y.weight;
+            return x.edgeId < y.edgeId;
+        });
+        for (const auto &arc : candidates)
+            if (arcs.empty() || arcs.back().a != arc.a || arcs.back().b != arc.b)
+                arcs.push_back(arc);
+    }
+    std::vector<std::vector<Link>> adj(n);
+    for (int i = 0; i < static_cast<int>(arcs.size()); ++i) {
+        adj[arcs[i].a].push_back({arcs[i].b, i, arcs[i].weight});
+        adj[arcs[i].b].push_back({arcs[i].a, i, arcs[i].weight});
+    }
+    std::vector<char> active(arcs.size(), 1);   // false once replaced by a lighter shortcut
+
+    // --- B2. Witness search: đường đi tránh v, không dài hơn maxDist ---
+    // Stops early once every neighbour w that still needs an answer is
+    // settled; those are marked with the current targetVersion.
+    ShortestPaths::StampedSearch<double> witness;
+    std::vector<std::uint32_t> targetStamp(n, 0);
+    std::uint32_t targetVersion = 0;
+    auto witnessSearch = [&](int source, int skip, double maxDist, int targets, int settleLimit) {
+        witness.begin(n);
+        witness.stamp[source] = witness.version;
+        witness.dist[source] = 0.0;
+        witness.queue.push(0.0, source);
+        int settled = 0;
+        while (!witness.queue.empty()) {
+            auto [d, x] = witness.queue.pop();
+            if (d != witness.dist[x]) continue;
+            if (d > maxDist || ++settled > settleLimit) break;
+            if (targetStamp[x] == targetVersion && --targets == 0) break;
+            for (const Link &l : adj[x]) {
+                if (l.to == skip) continue;
+                double nd = d + l.weight;
+                if (nd > maxDist) continue;
+                if (!witness.reached(l.to) || nd < witness.dist[l.to]) {
+                    witness.stamp[l.to] = witness.version;
+                    witness.dist[l.to] = nd;
+                    witness.queue.push(nd, l.to);
+                }
+            }
+        }
+    };
+
+    // emit(i, j, via) for every pair of v's neighbours that needs a shortcut
+    std::vector<double> suffixMax;
+    auto forEachShortcut = [&](int v, int settleLimit, auto &&emit) {
+        const auto &nb = adj[v];
+        const int d = static_cast<int>(nb.size());
+        suffixMax.assign(d + 1, 0.0);
+        for (int j = d - 1; j >= 0; --j) suffixMax[j] = std::max(suffixMax[j + 1], nb[j].weight);
+        for (int i = 0; i + 1 < d; ++i) {
+            if (++targetVersion == 0) {
+                std::fill(targetStamp.begin(), targetStamp.end(), 0);
+                targetVersion = 1;
+            }
+            for (int j = i + 1; j < d; ++j) targetStamp[nb[j].to] = targetVersion;
+            witnessSearch(nb[i].to, v, nb[i].weight + suffixMax[i + 1], d - 1 - i, settleLimit);
+            for (int j = i + 1; j < d; ++j) {
+                double via = nb[i].weight + nb[j].weight;
+                int w = nb[j].to;
+                if (!(witness.reached(w) && witness.dist[w] <= via)) emit(i, j, via);
+            }
+        }
+    };
+
+    // Importance: edge difference, contracted neighbours and level (one
+    // above the highest contracted neighbour) keep the hierarchy even
+    std::vector<int> contractedNeighbors(n, 0);
+    std::vector<int> level(n, 0);
+    auto priority = [&](int v) {
+        const int d = static_cast<int>(adj[v].size());
+        long long added = 0;
+        if (d > kExactDegree) added = static_cast<long long>(d) * (d - 1) / 2;
+        else forEachShortcut(v, kEstimateSettleLimit, [&added](int, int, double) { ++added; });
+        long long p = 2 * (added - d) + contractedNeighbors[v] + level[v];
+        return static_cast<int>(std::min<long long>(p, std::numeric_limits<int>::max()));
+    };
+
+    // --- B3. Co đỉnh theo độ quan trọng (lazy update) ---
+    using Entry = std::pair<int, int>;   // (priority, vertex)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (int v = 0; v < n; ++v) queue.push({priority(v), v});
+
+    std::vector<int> rank(n, n);   // n = core (never contracted)
+    struct Pending { int i, j; double via; };
+    std::vector<Pending> pending;
+    int order = 0;
+    while (!queue.empty()) {
+        int v = queue.top().second;
+        queue.pop();
+        int p = priority(v);
+        if (!queue.empty() && p > queue.top().first) {
+            queue.push({p, v});
+            continue;
+        }
+        if (static_cast<int>(adj[v].size()) > kCoreDegree) break;   // the rest stays as the core
+
+        pending.clear();
+        forEachShortcut(v, options.witnessSettleLimit,
+                        [&pending](int i, int j, double via) { pending.push_back({i, j, via}); });
+        const auto &nb = adj[v];
+        for (const Link &l : nb) {
+            auto &list = adj[l.to];
+            for (std::size_t k = 0; k < list.size(); ++k)
+                if (list[k].to == v) { list[k] = list.back(); list.pop_back(); break; }
+            contractedNeighbors[l.to]++;
+            level[l.to] = std::max(level[l.to], level[v] + 1);
+        }
+        for (const Pending &s : pending) {
+            const Link &lu = nb[s.i];
+            const Link &lw = nb[s.j];
+            auto &listU = adj[lu.to];
+            auto existing = std::find_if(listU.begin(), listU.end(), [&lw](const Link &l) { return l.to == lw.to; });
+            if (existing != listU.end() && existing->weight <= s.via) continue;
+
+            Arc arc;
+            arc.a = lu.to;
+            arc.b = lw.to;
+            arc.weight = s.via;
+            arc.middle = v;
+            arc.childA = lu.arc;   // a–middle
+            arc.childB = lw.arc;   // middle–b
+            const int id = static_cast<int>(arcs.size());
+            arcs.push_back(arc);
+            active.push_back(1);
+            ch.shortcuts++;
+            if (existing != listU.end()) {
+                active[existing->arc] = 0;
+                *existing = {lw.to, id, s.via};
+                for (Link &l : adj[lw.to])
+                    if (l.to == lu.to) { l = {lu.to, id, s.via}; break; }
+            } else {
+                listU.push_back({lw.to, id, s.via});
+                adj[lw.to].push_back({lu.to, id, s.via});
+            }
+        }
+        adj[v].clear();
+        adj[v].shrink_to_fit();
+        rank[v] = order++;
+
+        if (order % 512 == 0) {
+            if (options.progress) options.progress(order, n);
+            if (options.cancel && options.cancel->load(std::memory_order_relaxed))
+                return ContractionHierarchy();
+        }
+    }
+
+    // --- B4. Đồ thị hướng lên (CSR): mỗi cung thuộc đầu mút có rank thấp hơn ---
+    ch.offsets.assign(n + 1, 0);
+    // Slot owners of arc i: the lower-ranked end, or both ends of a core arc
+    auto owners = [&](int i, int &first, int &second) {
+        const int a = arcs[i].a, b = arcs[i].b;
+        if (rank[a] == rank[b]) { first = a; second = b; }
+        else { first = rank[a] < rank[b] ? a : b; second = -1; }
+    };
+    for (int i = 0; i < static_cast<int>(arcs.size()); ++i) {
+        if (!active[i]) continue;
+        int first, second;
+        owners(i, first, second);
+        ch.offsets[first + 1]++;
+        if (second >= 0) ch.offsets[second + 1]++;
+    }
+    for (int v = 0; v < n; ++v) ch.offsets[v + 1] += ch.offsets[v];
+    const int slots = ch.offsets[n];
+    ch.heads.resize(slots);
+    ch.weights.resize(slots);
+    ch.arcIds.resize(slots);
+    std::vector<int> cursor(ch.offsets.begin(), ch.offsets.end() - 1);
+    for (int i = 0; i < static_cast<int>(arcs.size()); ++i) {
+        if (!active[i]) continue;
+        int first, second;
+        owners(i, first, second);
+        for (int tail : {first, second}) {
+            if (tail < 0) continue;
+            int s = cursor[tail]++;
+            ch.heads[s] = ch.otherEnd(i, tail);
+            ch.weights[s] = arcs[i].weight;
+            ch.arcIds[s] = i;
+        }
+    }
+    ch.coreSize = n - order;
+    if (options.progress) options.progress(n, n);
+    return ch;
+}
+
+std::uint64_t ContractionHierarchy::fingerprintOf(const Graph &g) {
+    // FNV-1a over the vertex count and every edge (u, v, weight bits)
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](std::uint64_t x) {
+        for (int i = 0; i < 8; ++i) {
+            h ^= (x >> (8 * i)) & 0xff;
+            h *= 1099511628211ull;
+        }
+    };
+    mix(g.getVertices().size());
+    mix(g.getEdges().size());
+    for (const auto &e : g.getEdges()) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &e.weight, sizeof(bits));
+        mix(static_cast<std::uint32_t>(e.u));
+        mix(static_cast<std::uint32_t>(e.v));
+        mix(bits);
+    }
+    return h;
+}
+
+bool ContractionHierarchy::matches(const Graph &g) const {
+    return !empty() && vertexCount() == static_cast<int>(g.getVertices().size())
+        && graphFingerprint == fingerprintOf(g);
+}
+
+/* ============================================================
+   Query — hai phía cùng đi lên, gặp nhau ở đỉnh rank cao nhất
+   ============================================================ */
+int ContractionHierarchy::meet(int source, int target, HierarchyScratch &scratch, double &best) const {
+    const int n = vertexCount();
+    ShortestPaths::StampedSearch<double> *sides[2] = {&scratch.forward, &scratch.backward};
+    const int roots[2] = {source, target};
+    bool done[2] = {false, false};
+    for (int k = 0; k < 2; ++k) {
+        auto &search = *sides[k];
+        search.begin(n);
+        search.stamp[roots[k]] = search.version;
+        search.dist[roots[k]] = 0.0;
+        search.parentEdge[roots[k]] = -1;
+        search.queue.push(0.0, roots[k]);
+    }
+
+    best = kInfinity;
+    int meeting = -1;
+    while (!done[0] || !done[1]) {
+        for (int k = 0; k < 2; ++k) {
+            if (done[k]) continue;
+            auto &search = *sides[k];
+            const auto &other = *sides[1 - k];
+            if (search.queue.empty()) { done[k] = true; continue; }
+            auto [d, x] = search.queue.pop();
+            if (d != search.dist[x]) continue;
+            if (d >= best) { done[k] = true; continue; }
+            if (other.reached(x) && d + other.dist[x] < best) {
+                best = d + other.dist[x];
+                meeting = x;
+            }
+            if (stalled(search, x, d)) continue;
+            for (int s = offsets[x]; s < offsets[x + 1]; ++s) {
+                int y = heads[s];
+                double nd = d + weights[s];
+                if (!search.reached(y) || nd < search.dist[y]) {
+                    search.stamp[y] = search.version;
+                    search.dist[y] = nd;
+                    search.parentEdge[y] = arcIds[s];
+                    search.queue.push(nd, y);
+                }
+            }
+        }
+    }
+    return meeting;
+}
+
+// Stall-on-demand: a higher neighbour already reached with a shorter
+// way down to x proves d is not x's distance, so x is not expanded
+// (nothing above x can be reached optimally through it)
+bool ContractionHierarchy::stalled(const ShortestPaths::StampedSearch<double> &search, int x, double d) const {
+    for (int s = offsets[x]; s < offsets[x + 1]; ++s) {
+        int y = heads[s];
+        if (search.reached(y) && search.dist[y] + weights[s] < d) return true;
+    }
+    return false;
+}
+
+void ContractionHierarchy::upwardSearch(int source, ShortestPaths::StampedSearch<double> &search,
+                                        std::vector<int> &settled) const {
+    search.begin(vertexCount());
+    search.stamp[source] = search.version;
+    search.dist[source] = 0.0;
+    search.queue.push(0.0, source);
+    settled.clear();
+    std::int64_t pushes = 1, pops = 0, relaxed = 0;
+    while (!search.queue.empty()) {
+        auto [d, x] = search.queue.pop();
+        ++pops;
+        if (d != search.dist[x]) continue;
+        if (stalled(search, x, d)) continue;
+        settled.push_back(x);
+        relaxed += offsets[x + 1] - offsets[x];
+        for (int s = offsets[x]; s < offsets[x + 1]; ++s) {
+            int y = heads[s];
+            double nd = d + weights[s];
+            if (!search.reached(y) || nd < search.dist[y]) {
+                search.stamp[y] = search.version;
+                search.dist[y] = nd;
+                search.queue.push(nd, y);
+                ++pushes;
+            }
+        }
+    }
+    search.pushes += pushes;
+    search.pops += pops;
+    search.relaxed += relaxed;
+    search.settled += static_cast<std::int64_t>(settled.size());
+}
+
+void ContractionHierarchy::unpack(int arc, int from, std::vector<int> &stack,
+                                  std::vector<int> &edgeIds) const {
+    // Explicit (arc, from) stack: shortcut chains can be deep
+    stack.clear();
+    stack.push_back(arc);
+    stack.push_back(from);
+    while (!stack.empty()) {
+        int f = stack.back(); stack.pop_back();
+        int id = stack.back(); stack.pop_back();
+        const Arc &x = arcs[id];
+        if (x.edgeId >= 0) { edgeIds.push_back(x.edgeId); continue; }
+        if (f == x.a) {
+            stack.push_back(x.childB); stack.push_back(x.middle);
+            stack.push_back(x.childA); stack.push_back(x.a);
+        } else {
+            stack.push_back(x.childA); stack.push_back(x.middle);
+            stack.push_back(x.childB); stack.push_back(x.b);
+        }
+    }
+}
+
+double ContractionHierarchy::distance(int source, int target, HierarchyScratch &scratch) const {
+    if (!valid(source) || !valid(target)) return kInfinity;
+    double best = kInfinity;
+    meet(source, target, scratch, best);
+    return best;
+}
+
+bool ContractionHierarchy::path(int source, int target, HierarchyScratch &scratch,
+                                std::vector<int> &edgeIds) const {
+    edgeIds.clear();
+    if (!valid(source) || !valid(target)) return false;
+    double best = kInfinity;
+    const int m = meet(source, target, scratch, best);
+    if (m < 0) return false;
+
+    // source → m: the forward tree is walked from m, so collect first
+    auto &upArcs = scratch.settledList;
+    upArcs.clear();
+    for (int v = m; v != source;) {
+        int arc = scratch.forward.parentEdge[v];
+        upArcs.push_back(arc);
+        v = otherEnd(arc, v);
+    }
+    int v = source;
+    for (auto it = upArcs.rbegin(); it != upArcs.rend(); ++it) {
+        unpack(*it, v, scratch.unpackStack, edgeIds);
+        v = otherEnd(*it, v);
+    }
+    // m → target along the backward tree
+    for (v = m; v != target;) {
+        int arc = scratch.backward.parentEdge[v];
+        unpack(arc, v, scratch.unpackStack, edgeIds);
+        v = otherEnd(arc, v);
+    }
+    return true;
+}
+
+void ContractionHierarchy::table(const std::vector<int> &sources, const std::vector<int> &targets,
+                                 std::vector<double> &out, const ParallelExecutor &executor,
+                                 std::vector<HierarchyScratch> &scratch) const {
+    const int rows = static_cast<int>(sources.size());
+    const int cols = static_cast<int>(targets.size());
+    out.assign(static_cast<std::size_t>(rows) * cols, kInfinity);
+    if (scratch.size() < executor.workerCount()) scratch.resize(executor.workerCount());
+
+    // Backward upward search per target → its search space
+    std::vector<std::vector<std::pair<int, double>>> spaces(cols);
+    executor.parallelFor(cols, [&](int j, unsigned worker) {
+        if (!valid(targets[j])) return;
+        auto &sc = scratch[worker];
+        upwardSearch(targets[j], sc.backward, sc.settledList);
+        spaces[j].reserve(sc.settledList.size());
+        for (int x : sc.settledList) spaces[j].push_back({x, sc.backward.dist[x]});
+    });
+
+    // Buckets: vertex → (target column, distance), CSR layout
+    const int n = vertexCount();
+    std::vector<int> bucketOffsets(n + 1, 0);
+    for (const auto &space : spaces)
+        for (const auto &item : space) bucketOffsets[item.first + 1]++;
+    for (int v = 0; v < n; ++v) bucketOffsets[v + 1] += bucketOffsets[v];
+    std::vector<std::pair<int, double>> buckets(bucketOffsets[n]);
+    {
+        std::vector<int> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+        for (int j = 0; j < cols; ++j)
+            for (const auto &item : spaces[j]) buckets[cursor[item.first]++] = {j, item.second};
+    }
+
+    // Forward upward search per source, scanning the buckets it settles
+    executor.parallelFor(rows, [&](int i, unsigned worker) {
+        if (!valid(sources[i])) return;
+        auto &sc = scratch[worker];
+        upwardSearch(sources[i], sc.forward, sc.settledList);
+        double *row = &out[static_cast<std::size_t>(i) * cols];
+        for (int x : sc.settledList) {
+            const double dx = sc.forward.dist[x];
+            for (int k = bucketOffsets[x]; k < bucketOffsets[x + 1]; ++k)
+                row[buckets[k].first] = std::min(row[buckets[k].first], dx + buckets[k].second);
+        }
+    });
+}
+
+/* ============================================================
+   File I/O (native byte order)
+   ============================================================ */
+bool ContractionHierarchy::save(const std::filesystem::path &file) const {
+    std::ofstream out(file, std::ios::binary);
+    if (!out) return false;
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char *>(&kFormatVersion), sizeof(kFormatVersion));
+    out.write(reinterpret_cast<const char *>(&graphFingerprint), sizeof(graphFingerprint));
+    const std::int32_t counts[2] = {shortcuts, coreSize};
+    out.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+    writeVector(out, offsets);
+    writeVector(out, heads);
+    writeVector(out, weights);
+    writeVector(out, arcIds);
+    writeVector(out, arcs);
+    return static_cast<bool>(out);
+}
+
+bool ContractionHierarchy::load(const std::filesystem::path &file, ContractionHierarchy &out) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) return false;
+    char magic[4];
+    std::uint32_t version = 0;
+    std::int32_t counts[2] = {0, 0};
+    ContractionHierarchy ch;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0) return false;
+    if (!in.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != kFormatVersion) return false;
+    if (!in.read(reinterpret_cast<char *>(&ch.graphFingerprint), sizeof(ch.graphFingerprint))) return false;
+    if (!in.read(reinterpret_cast<char *>(counts), sizeof(counts))) return false;
+    const std::uint64_t limit = std::uint64_t(1) << 32;
+    if (!readVector(in, ch.offsets, limit) || !readVector(in, ch.heads, limit)
+        || !readVector(in, ch.weights, limit) || !readVector(in, ch.arcIds, limit)
+        || !readVector(in, ch.arcs, limit))
+        return false;
+    ch.shortcuts = counts[0];
+    ch.coreSize = counts[1];
+
+    // Reject anything that could index out of range
+    const int n = ch.vertexCount();
+    const int slots = static_cast<int>(ch.heads.size());
+    const int arcCount = static_cast<int>(ch.arcs.size());
+    if (ch.offsets.empty() || ch.offsets[0] != 0 || ch.offsets[n] != slots
+        || ch.weights.size() != ch.heads.size() || ch.arcIds.size() != ch.heads.size())
+        return false;
+    for (int v = 0; v < n; ++v)
+        if (ch.offsets[v] > ch.offsets[v + 1]) return false;
+    for (int s = 0; s < slots; ++s)
+        if (ch.heads[s] < 0 || ch.heads[s] >= n || ch.arcIds[s] < 0 || ch.arcIds[s] >= arcCount) return false;
+    for (int i = 0; i < arcCount; ++i) {
+        const Arc &a = ch.arcs[i];
+        if (a.a < 0 || a.a >= n || a.b < 0 || a.b >= n) return false;
+        // Children always precede the shortcut built from them
+        if (a.edgeId < 0 && (a.middle < 0 || a.middle >= n || a.childA < 0 || a.childA >= i
+                             || a.childB < 0 || a.childB >= i))
+            return false;
+    }
+    out = std::move(ch);
+    return true;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+#include "Graph.h"
+#include "ShortestPaths.h"
+
+class ParallelExecutor;
+
+/* ============================================================
+   ContractionHierarchy — preprocessed shortest-path index
+   ------------------------------------------------------------
+   Vertices are contracted one at a time in order of importance
+   (edge difference + contracted neighbours, lazily updated).
+   Contracting v adds a shortcut u–w for every pair of remaining
+   neighbours unless a bounded witness search finds a path that
+   avoids v and is no longer. Queries then only ever move to
+   higher-ranked vertices: a point-to-point query is two small
+   upward searches meeting in the middle, and a sources × targets
+   table is one upward search per source and per target joined
+   through per-vertex buckets. Searches stall a vertex that a
+   higher neighbour already reaches by a shorter way down. When
+   the next vertex to contract has more than 128 remaining
+   neighbours, contraction stops: that dense core keeps all its
+   arcs in both directions and queries cross it like a plain
+   Dijkstra.
+
+   Shortcuts remember the two arcs they replace, so every path
+   is unpacked back to original edge ids. Weights are the Graph's
+   doubles; edges are undirected, parallel edges keep the
+   lightest and self-loops are dropped (neither is ever part of
+   a shortest path).
+
+   The index is immutable once built and can be shared by any
+   number of threads; each thread passes its own scratch. It is
+   bound to the graph it was built from by a fingerprint of the
+   edge list, so a stale file is detected with matches().
+   ============================================================ */
+
+// Scratch of one thread's queries, reused across queries
+struct HierarchyScratch {
+    ShortestPaths::StampedSearch<double> forward;
+    ShortestPaths::StampedSearch<double> backward;
+    std::vector<int> settledList;
+    std::vector<int> unpackStack;
+};
+
+struct HierarchyBuildOptions {
+    // Witness searches give up after settling this many vertices
+    // (an extra shortcut is harmless, only slightly slower)
+    int witnessSettleLimit{200};
+    // Polled every few hundred contractions; a cancelled build
+    // returns an empty hierarchy
+    const std::atomic<bool> *cancel{nullptr};
+    // progress(contracted, total)
+    std::function<void(int, int)> progress;
+};
+
+class ContractionHierarchy {
+public:
+    // Stored next to coords.txt / matrix.txt
+    static constexpr const char *kFileName = "hierarchy.ch";
+
+    ContractionHierarchy() = default;
+
+    static ContractionHierarchy build(const Graph &g, const HierarchyBuildOptions &options = {});
+
+    bool empty() const { return offsets.empty(); }
+    int vertexCount() const { return empty() ? 0 : static_cast<int>(offsets.size()) - 1; }
+    int shortcutCount() const { return shortcuts; }
+    // Vertices left uncontracted at the top (searched like plain Dijkstra)
+    int coreVertexCount() const { return coreSize; }
+    int arcCount() const { return static_cast<int>(arcs.size()); }
+    std::uint64_t fingerprint() const { return graphFingerprint; }
+
+    // True when built from a graph with exactly g's vertices and edges
+    bool matches(const Graph &g) const;
+    static std::uint64_t fingerprintOf(const Graph &g);
+
+    // +infinity when unreachable or out of range
+    double distance(int source, int target, HierarchyScratch &scratch) const;
+    // Original edge ids from source to target; false when unreachable
+    bool path(int source, int target, HierarchyScratch &scratch, std::vector<int> &edgeIds) const;
+
+    // out = sources.size() × targets.size() distances, row-major,
+    // +infinity when unreachable. One scratch per executor worker.
+    void table(const std::vector<int> &sources, const std::vector<int> &targets,
+               std::vector<double> &out, const ParallelExecutor &executor,
+               std::vector<HierarchyScratch> &scratch) const;
+
+    // Binary file; load() fails on a bad or truncated file
+    bool save(const std::filesystem::path &file) const;
+    static bool load(const std::filesystem::path &file, ContractionHierarchy &out);
+
+private:
+    // Arc between a and b: an original edge (edgeId >= 0) or a
+    // shortcut via `middle` made of childA (a–middle) and
+    // childB (middle–b)
+    struct Arc {
+        int a{0}, b{0};
+        double weight{0.0};
+        int edgeId{-1};
+        int middle{-1};
+        int childA{-1}, childB{-1};
+    };
+
+    // Upward graph: slots [offsets[v], offsets[v + 1]) are the arcs
+    // from v to higher-ranked neighbours
+    std::vector<int> offsets;
+    std::vector<int> heads;
+    std::vector<double> weights;
+    std::vector<int> arcIds;
+    std::vector<Arc> arcs;
+    int shortcuts{0};
+    int coreSize{0};
+    std::uint64_t graphFingerprint{0};
+
+    // Bidirectional upward search; returns the meeting vertex (-1 when
+    // unreachable) and its distance in `best`
+    int meet(int source, int target, HierarchyScratch &scratch, double &best) const;
+    bool stalled(const ShortestPaths::StampedSearch<double> &search, int x, double d) const;
+    // Full upward search (no target); settled vertices are appended
+    // to `settled`
+    void upwardSearch(int source, ShortestPaths::StampedSearch<double> &search,
+                      std::vector<int> &settled) const;
+    // Appends the original edges of arc `arc`, walked starting at `from`
+    void unpack(int arc, int from, std::vector<int> &stack, std::vector<int> &edgeIds) const;
+    int otherEnd(int arc, int v) const { return arcs[arc].a == v ? arcs[arc].b : arcs[arc].a; }
+    bool valid(int v) const { return v >= 0 && v < vertexCount(); }
+};
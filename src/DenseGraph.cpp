@@ -0,0 +1,316 @@
+#include "DenseGraph.h"
+#include "ParallelExecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DENSE_AVX2_DISPATCH 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define DENSE_AVX2_ALWAYS 1
+#endif
+
+namespace {
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+// Floyd–Warshall block edge: three 32 × 32 double blocks = 24 KB
+constexpr int kBlock = 32;
+
+int lowestBit(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int bit = 0;
+    while (!(x & 1)) { x >>= 1; ++bit; }
+    return bit;
+#endif
+}
+
+// d[i][j] = min(d[i][j], d[i][k] + d[k][j]) for the block (i0, j0)
+// with k over the block k0; k outermost, so the same kernel serves
+// the diagonal, row/column and independent phases
+void relaxBlockScalar(double *d, int stride, int i0, int j0, int k0) {
+    for (int k = k0; k < k0 + kBlock; ++k) {
+        const double *rowK = d + static_cast<std::size_t>(k) * stride + j0;
+        for (int i = i0; i < i0 + kBlock; ++i) {
+            double *rowI = d + static_cast<std::size_t>(i) * stride;
+            const double dik = rowI[k];
+            if (dik == kInfinity) continue;
+            double *c = rowI + j0;
+            for (int j = 0; j < kBlock; ++j) {
+                const double via = dik + rowK[j];
+                if (via < c[j]) c[j] = via;
+            }
+        }
+    }
+}
+
+// Same for a block whose row block (i0, k0) and column block (k0, j0)
+// are both different from it, so the order is free: i outermost, and
+// the 32 entries of row i stay in registers across all k
+void relaxIndependentScalar(double *d, int stride, int i0, int j0, int k0) {
+    for (int i = i0; i < i0 + kBlock; ++i) {
+        const double *rowI = d + static_cast<std::size_t>(i) * stride;
+        double c[kBlock];
+        std::copy(rowI + j0, rowI + j0 + kBlock, c);
+        for (int k = k0; k < k0 + kBlock; ++k) {
+            const double dik = rowI[k];
+            if (dik == kInfinity) continue;
+            const double *rowK = d + static_cast<std::size_t>(k) * stride + j0;
+            for (int j = 0; j < kBlock; ++j) c[j] = std::min(c[j], dik + rowK[j]);
+        }
+        std::copy(c, c + kBlock, d + static_cast<std::size_t>(i) * stride + j0);
+    }
+}
+
+#if defined(DENSE_AVX2_DISPATCH) || defined(DENSE_AVX2_ALWAYS)
+#if defined(DENSE_AVX2_DISPATCH)
+#define DENSE_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define DENSE_AVX2_TARGET
+#endif
+DENSE_AVX2_TARGET
+void relaxBlockAvx2(double *d, int stride, int i0, int j0, int k0) {
+    for (int k = k0; k < k0 + kBlock; ++k) {
+        const double *rowK = d + static_cast<std::size_t>(k) * stride + j0;
+        for (int i = i0; i < i0 + kBlock; ++i) {
+            double *rowI = d + static_cast<std::size_t>(i) * stride;
+            const double dik = rowI[k];
+            if (dik == kInfinity) continue;
+            const __m256d vik = _mm256_set1_pd(dik);
+            double *c = rowI + j0;
+            for (int j = 0; j < kBlock; j += 4) {
+                __m256d via = _mm256_add_pd(vik, _mm256_loadu_pd(rowK + j));
+                _mm256_storeu_pd(c + j, _mm256_min_pd(_mm256_loadu_pd(c + j), via));
+            }
+        }
+    }
+}
+
+DENSE_AVX2_TARGET
+void relaxIndependentAvx2(double *d, int stride, int i0, int j0, int k0) {
+    static_assert(kBlock == 32, "eight 4-wide accumulators per row");
+    for (int i = i0; i < i0 + kBlock; ++i) {
+        double *rowI = d + static_cast<std::size_t>(i) * stride;
+        double *c = rowI + j0;
+        __m256d c0 = _mm256_loadu_pd(c), c1 = _mm256_loadu_pd(c + 4);
+        __m256d c2 = _mm256_loadu_pd(c + 8), c3 = _mm256_loadu_pd(c + 12);
+        __m256d c4 = _mm256_loadu_pd(c + 16), c5 = _mm256_loadu_pd(c + 20);
+        __m256d c6 = _mm256_loadu_pd(c + 24), c7 = _mm256_loadu_pd(c + 28);
+        for (int k = k0; k < k0 + kBlock; ++k) {
+            const double dik = rowI[k];
+            if (dik == kInfinity) continue;
+            const __m256d v = _mm256_set1_pd(dik);
+            const double *r = d + static_cast<std::size_t>(k) * stride + j0;
+            c0 = _mm256_min_pd(c0, _mm256_add_pd(v, _mm256_loadu_pd(r)));
+            c1 = _mm256_min_pd(c1, _mm256_add_pd(v, _mm256_loadu_pd(r + 4)));
+            c2 = _mm256_min_pd(c2, _mm256_add_pd(v, _mm256_loadu_pd(r + 8)));
+            c3 = _mm256_min_pd(c3, _mm256_add_pd(v, _mm256_loadu_pd(r + 12)));
+            c4 = _mm256_min_pd(c4, _mm256_add_pd(v, _mm256_loadu_pd(r + 16)));
+            c5 = _mm256_min_pd(c5, _mm256_add_pd(v, _mm256_loadu_pd(r + 20)));
+            c6 = _mm256_min_pd(c6, _mm256_add_pd(v, _mm256_loadu_pd(r + 24)));
+            c7 = _mm256_min_pd(c7, _mm256_add_pd(v, _mm256_loadu_pd(r + 28)));
+        }
+        _mm256_storeu_pd(c, c0);
+        _mm256_storeu_pd(c + 4, c1);
+        _mm256_storeu_pd(c + 8, c2);
+        _mm256_storeu_pd(c + 12, c3);
+        _mm256_storeu_pd(c + 16, c4);
+        _mm256_storeu_pd(c + 20, c5);
+        _mm256_storeu_pd(c + 24, c6);
+        _mm256_storeu_pd(c + 28, c7);
+    }
+}
+#endif
+
+using RelaxBlock = void (*)(double *, int, int, int, int);
+
+struct Kernels {
+    RelaxBlock dependent;    // diagonal, row and column blocks
+    RelaxBlock independent;  // all other blocks
+};
+
+Kernels pickKernels() {
+#if defined(DENSE_AVX2_ALWAYS)
+    return {relaxBlockAvx2, relaxIndependentAvx2};
+#elif defined(DENSE_AVX2_DISPATCH)
+    if (__builtin_cpu_supports("avx2")) return {relaxBlockAvx2, relaxIndependentAvx2};
+    return {relaxBlockScalar, relaxIndependentScalar};
+#else
+    return {relaxBlockScalar, relaxIndependentScalar};
+#endif
+}
+
+template <typename T>
+std::size_t bytesOf(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
+}
+
+namespace DenseGraph {
+
+bool shouldUse(int vertices, int edges, int oddVertices) {
+    if (vertices < 2 || vertices > kMaxVertices || oddVertices == 0) return false;
+    // Measured on one core: ~0.15 ns per Floyd–Warshall relaxation
+    // (AVX2 kernels, padded n³ of them) against ~2 ns per CSR slot and
+    // source for Dijkstra (relaxation + heap traffic), i.e. dense mode
+    // pays off from roughly a third of all vertex pairs being streets.
+    const double n = vertices;
+    const double stride = std::ceil(n / kBlock) * kBlock;
+    const double floyd = stride * stride * stride;
+    const double dijkstra = 13.0 * oddVertices * (2.0 * edges + n);
+    return floyd < dijkstra;
+}
+
+void BitAdjacency::assign(const CsrTopology &csr) {
+    vertices = csr.vertexCount();
+    words = (vertices + 63) / 64;
+    bits.assign(static_cast<std::size_t>(vertices) * words, 0);
+    for (int v = 0; v < vertices; ++v) {
+        std::uint64_t *r = &bits[static_cast<std::size_t>(v) * words];
+        for (int s = csr.begin(v); s < csr.end(v); ++s) {
+            const int u = csr.neighbors[s];
+            r[u >> 6] |= std::uint64_t(1) << (u & 63);
+        }
+    }
+}
+
+bool isConnected(const CsrTopology &csr, Workspace &ws) {
+    const BitAdjacency &adj = ws.adjacency;
+    const int n = adj.vertices;
+    int start = -1;
+    for (int v = 0; v < n; ++v)
+        if (csr.degree(v) > 0) { start = v; break; }
+    if (start == -1) return true;
+
+    const int words = adj.words;
+    ws.visited.assign(words, 0);
+    ws.frontier.assign(words, 0);
+    ws.next.resize(words);
+    ws.visited[start >> 6] |= std::uint64_t(1) << (start & 63);
+    ws.frontier[start >> 6] = ws.visited[start >> 6];
+
+    // Each level ORs the rows of the frontier together and keeps what
+    // was not visited yet
+    for (bool grew = true; grew;) {
+        std::fill(ws.next.begin(), ws.next.end(), 0);
+        for (int w = 0; w < words; ++w)
+            for (std::uint64_t x = ws.frontier[w]; x; x &= x - 1) {
+                const std::uint64_t *r = adj.row(w * 64 + lowestBit(x));
+                for (int k = 0; k < words; ++k) ws.next[k] |= r[k];
+            }
+        grew = false;
+        for (int w = 0; w < words; ++w) {
+            ws.next[w] &= ~ws.visited[w];
+            ws.visited[w] |= ws.next[w];
+            grew = grew || ws.next[w] != 0;
+        }
+        ws.frontier.swap(ws.next);
+    }
+
+    for (int v = 0; v < n; ++v)
+        if (csr.degree(v) > 0 && !((ws.visited[v >> 6] >> (v & 63)) & 1u)) return false;
+    return true;
+}
+
+bool allPairs(const std::vector<Edge> &edges, int vertices, const ParallelExecutor &executor,
+              Workspace &ws, const std::atomic<bool> *cancel) {
+    const int n = vertices;
+    const int stride = (n + kBlock - 1) / kBlock * kBlock;
+    ws.vertices = n;
+    ws.stride = stride;
+
+    // --- B1. Ma trận khởi tạo: 0 trên đường chéo, cạnh nhẹ nhất ---
+    // Padding rows/columns stay at +infinity and never improve anything
+    ws.all.assign(static_cast<std::size_t>(stride) * stride, kInfinity);
+    double *d = ws.all.data();
+    for (int v = 0; v < n; ++v) d[static_cast<std::size_t>(v) * stride + v] = 0.0;
+    for (const auto &e : edges) {
+        if (e.u == e.v) continue;
+        double &uv = d[static_cast<std::size_t>(e.u) * stride + e.v];
+        double &vu = d[static_cast<std::size_t>(e.v) * stride + e.u];
+        uv = std::min(uv, e.weight);
+        vu = std::min(vu, e.weight);
+    }
+
+    // --- B2. Floyd–Warshall theo khối ---
+    const Kernels kernels = pickKernels();
+    const RelaxBlock relax = kernels.dependent;
+    const int blocks = stride / kBlock;
+    for (int kb = 0; kb < blocks; ++kb) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+        const int k0 = kb * kBlock;
+        // Diagonal block first: row and column blocks depend on it
+        relax(d, stride, k0, k0, k0);
+        // Row kb and column kb (each block only reads itself and the diagonal)
+        executor.parallelFor(2 * (blocks - 1), [&](int idx, unsigned) {
+            int b = idx % (blocks - 1);
+            if (b >= kb) ++b;
+            if (idx < blocks - 1) relax(d, stride, k0, b * kBlock, k0);
+            else relax(d, stride, b * kBlock, k0, k0);
+        });
+        // Everything else is independent given row and column kb
+        executor.parallelFor(blocks, [&](int ib, unsigned) {
+            if (ib == kb) return;
+            for (int jb = 0; jb < blocks; ++jb)
+                if (jb != kb) kernels.independent(d, stride, ib * kBlock, jb * kBlock, k0);
+        });
+    }
+    return true;
+}
+
+bool appendPath(const CsrTopology &csr, const std::vector<Edge> &edges, int u, int v,
+                Workspace &ws, std::vector<int> &out) {
+    if (u == v) return true;
+    const double total = ws.distance(u, v);
+    if (total == kInfinity) return false;
+    // The matrix is symmetric: row v holds d(·, v) contiguously
+    const double *toV = &ws.all[static_cast<std::size_t>(v) * ws.stride];
+    const double eps = 1e-9 * (1.0 + total);
+
+    const int n = csr.vertexCount();
+    if (static_cast<int>(ws.stamp.size()) != n) {
+        ws.stamp.assign(n, 0);
+        ws.parentEdge.resize(n);
+        ws.version = 0;
+    }
+    if (++ws.version == 0) {
+        std::fill(ws.stamp.begin(), ws.stamp.end(), 0);
+        ws.version = 1;
+    }
+
+    // BFS from u over edges that lose no distance to v; every such
+    // walk to v is a shortest path
+    ws.queue.clear();
+    ws.queue.push_back(u);
+    ws.stamp[u] = ws.version;
+    bool found = false;
+    for (std::size_t head = 0; head < ws.queue.size() && !found; ++head) {
+        const int x = ws.queue[head];
+        for (int s = csr.begin(x); s < csr.end(x); ++s) {
+            const int y = csr.neighbors[s];
+            const int eid = csr.edgeIds[s];
+            if (ws.stamp[y] == ws.version || edges[eid].weight + toV[y] > toV[x] + eps) continue;
+            ws.stamp[y] = ws.version;
+            ws.parentEdge[y] = eid;
+            if (y == v) { found = true; break; }
+            ws.queue.push_back(y);
+        }
+    }
+    if (!found) return false;
+
+    const std::size_t first = out.size();
+    for (int x = v; x != u;) {
+        const int eid = ws.parentEdge[x];
+        out.push_back(eid);
+        x = edges[eid].u == x ? edges[eid].v : edges[eid].u;
+    }
+    std::reverse(out.begin() + first, out.end());
+    return true;
+}
+
+std::size_t bytes(const Workspace &ws) {
+    return bytesOf(ws.adjacency.bits) + bytesOf(ws.visited) + bytesOf(ws.frontier) + bytesOf(ws.next)
+         + bytesOf(ws.all) + bytesOf(ws.parentEdge) + bytesOf(ws.stamp) + bytesOf(ws.queue);
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+
+class ParallelExecutor;
+
+/* ============================================================
+   DenseGraph — dense mode for matrix-imported graphs
+   ------------------------------------------------------------
+   Locations come from an n × n adjacency matrix, and the small
+   ones are often nearly complete. There, one Dijkstra per odd
+   vertex costs about as much as all-pairs, so the postman
+   switches to:
+     - adjacency as packed bitsets (one row of ⌈n/64⌉ words per
+       vertex); connectivity is a BFS whose frontier expands 64
+       neighbours per OR;
+     - Floyd–Warshall on the full n × n matrix, padded to 32 × 32
+       blocks and run block by block (diagonal, its row and
+       column, then the rest, spread over the executor) so three
+       blocks stay in L1. The inner min(d_ij, d_ik + d_kj) runs 4
+       doubles wide on AVX2 (picked at run time on x86 with
+       GCC/Clang, at compile time under /arch:AVX2), scalar
+       elsewhere;
+     - the odd-vertex matrix is read out of the all-pairs one, and
+       a matched pair's path is recovered from the distances by a
+       BFS over "tight" edges (w(x, y) + d(y, v) = d(x, v)), so no
+       predecessor matrix is stored.
+   shouldUse() decides by size and density.
+   ============================================================ */
+namespace DenseGraph {
+
+// All-pairs matrix limit: 2048² doubles = 32 MB
+constexpr int kMaxVertices = 2048;
+
+// True when Floyd–Warshall on all vertices is expected to beat one
+// Dijkstra per odd vertex (cost model calibrated on the benchmark)
+bool shouldUse(int vertices, int edges, int oddVertices);
+
+// Packed bitset adjacency; parallel edges and self-loops collapse
+struct BitAdjacency {
+    int vertices{0};
+    int words{0};                      // words per row
+    std::vector<std::uint64_t> bits;   // vertices × words
+
+    void assign(const CsrTopology &csr);
+    const std::uint64_t* row(int v) const { return &bits[static_cast<std::size_t>(v) * words]; }
+    bool test(int u, int v) const { return (row(u)[v >> 6] >> (v & 63)) & 1u; }
+};
+
+// Buffers of the dense mode, grown to the largest graph seen and
+// never shrunk (PostmanWorkspace keeps one)
+struct Workspace {
+    BitAdjacency adjacency;
+    std::vector<std::uint64_t> visited, frontier, next;
+    std::vector<double> all;           // n × stride all-pairs distances
+    int vertices{0};
+    int stride{0};
+    // Tight-edge BFS of path()
+    std::vector<int> parentEdge;
+    std::vector<std::uint32_t> stamp;
+    std::uint32_t version{0};
+    std::vector<int> queue;
+
+    double distance(int u, int v) const { return all[static_cast<std::size_t>(u) * stride + v]; }
+};
+
+// Every vertex with degree > 0 is in one component (word-parallel BFS
+// over ws.adjacency, which must be assigned)
+bool isConnected(const CsrTopology &csr, Workspace &ws);
+
+// All-pairs shortest paths into ws.all; +infinity when unreachable.
+// Returns false when cancelled.
+bool allPairs(const std::vector<Edge> &edges, int vertices, const ParallelExecutor &executor,
+              Workspace &ws, const std::atomic<bool> *cancel = nullptr);
+
+// Appends a shortest u → v path (edge ids) using the all-pairs
+// distances; false when v is unreachable
+bool appendPath(const CsrTopology &csr, const std::vector<Edge> &edges, int u, int v,
+                Workspace &ws, std::vector<int> &out);
+
+// Bytes held by ws (capacity)
+std::size_t bytes(const Workspace &ws);
+
+}
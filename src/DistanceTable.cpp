@@ -0,0 +1,215 @@
+#include "DistanceTable.h"
+#include "ParallelExecutor.h"
+#include "ShortestPaths.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+template <typename W>
+double toDouble(W d) {
+    return d == ShortestPaths::unreachable<W>() ? kInfinity : static_cast<double>(d);
+}
+
+// CSR with W weights plus one search state per executor worker
+template <typename W>
+struct WeightedIndex {
+    BasicCsrAdjacency<W> csr;
+    std::vector<ShortestPaths::StampedSearch<W>> searches;
+};
+}
+
+struct DistanceTableEngine::Impl {
+    ParallelExecutor executor;
+    bool integer{false};
+    WeightedIndex<ShortestPaths::IntegerWeight> integerIndex;
+    WeightedIndex<double> realIndex;
+    std::vector<int> edgeEnds;                 // u, v of every edge id
+    // Targets of the running table(), version-stamped like the searches
+    std::vector<std::uint32_t> targetStamp;
+    std::uint32_t targetVersion{0};
+    std::vector<std::vector<int>> rowPaths;    // per source row, pairs concatenated
+    Counters total;
+
+    explicit Impl(unsigned threads) : executor(threads) {}
+
+    // f(index) on the index matching the graph's weights
+    template <typename F>
+    auto visit(F &&f) { return integer ? f(integerIndex) : f(realIndex); }
+
+    int vertexCount() const {
+        return integer ? integerIndex.csr.vertexCount() : realIndex.csr.vertexCount();
+    }
+    bool valid(int v) const { return v >= 0 && v < vertexCount(); }
+
+    void beginTargets() {
+        if (static_cast<int>(targetStamp.size()) != vertexCount()) {
+            targetStamp.assign(vertexCount(), 0);
+            targetVersion = 0;
+        }
+        if (++targetVersion == 0) {
+            std::fill(targetStamp.begin(), targetStamp.end(), 0);
+            targetVersion = 1;
+        }
+    }
+
+    // Appends the edges source → target of a finished search to out
+    template <typename Search>
+    void appendPath(const Search &search, int source, int target, std::vector<int> &out) const {
+        const std::size_t first = out.size();
+        for (int v = target; v != source;) {
+            int eid = search.parentEdge[v];
+            out.push_back(eid);
+            v = edgeEnds[2 * eid] == v ? edgeEnds[2 * eid + 1] : edgeEnds[2 * eid];
+        }
+        std::reverse(out.begin() + first, out.end());
+    }
+
+    template <typename Search>
+    void account(Search &search) {
+        total.searches++;
+        total.settled += search.settled;
+        total.edgesRelaxed += search.relaxed;
+        search.settled = search.relaxed = search.pushes = search.pops = 0;
+    }
+
+    // One search to a single target; false when unreachable
+    template <typename Index>
+    bool searchTo(Index &index, int source, int target) {
+        auto &search = index.searches[0];
+        ShortestPaths::dijkstra(index.csr, source, search, 1, [target](int v) { return v == target; });
+        account(search);
+        return search.reached(target);
+    }
+};
+
+DistanceTableEngine::DistanceTableEngine(const Graph &g, unsigned threads)
+    : impl(std::make_unique<Impl>(threads)) {
+    rebuild(g);
+}
+
+DistanceTableEngine::~DistanceTableEngine() = default;
+DistanceTableEngine::DistanceTableEngine(DistanceTableEngine &&) noexcept = default;
+DistanceTableEngine& DistanceTableEngine::operator=(DistanceTableEngine &&) noexcept = default;
+
+void DistanceTableEngine::rebuild(const Graph &g) {
+    const auto &edges = g.getEdges();
+    const int n = static_cast<int>(g.getVertices().size());
+    impl->integer = ShortestPaths::hasIntegerWeights(edges);
+    impl->visit([&](auto &index) {
+        index.csr.assign(edges, n);
+        if (index.searches.size() < impl->executor.workerCount())
+            index.searches.resize(impl->executor.workerCount());
+        return 0;
+    });
+    impl->edgeEnds.resize(2 * edges.size());
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        impl->edgeEnds[2 * i] = edges[i].u;
+        impl->edgeEnds[2 * i + 1] = edges[i].v;
+    }
+}
+
+int DistanceTableEngine::vertexCount() const { return impl->vertexCount(); }
+bool DistanceTableEngine::integerWeights() const { return impl->integer; }
+DistanceTableEngine::Counters DistanceTableEngine::counters() const { return impl->total; }
+
+double DistanceTableEngine::distance(int source, int target) {
+    if (!impl->valid(source) || !impl->valid(target)) return kInfinity;
+    return impl->visit([&](auto &index) {
+        impl->searchTo(index, source, target);
+        return toDouble(index.searches[0].distance(target));
+    });
+}
+
+std::vector<int> DistanceTableEngine::pathEdges(int source, int target) {
+    std::vector<int> path;
+    if (!impl->valid(source) || !impl->valid(target)) return path;
+    impl->visit([&](auto &index) {
+        if (impl->searchTo(index, source, target))
+            impl->appendPath(index.searches[0], source, target, path);
+        return 0;
+    });
+    return path;
+}
+
+std::vector<int> DistanceTableEngine::pathVertices(int source, int target) {
+    std::vector<int> vertices;
+    if (!impl->valid(source) || !impl->valid(target)) return vertices;
+    std::vector<int> edges = pathEdges(source, target);
+    if (edges.empty() && source != target) return vertices;
+    vertices.push_back(source);
+    for (int eid : edges) {
+        int v = vertices.back();
+        vertices.push_back(impl->edgeEnds[2 * eid] == v ? impl->edgeEnds[2 * eid + 1] : impl->edgeEnds[2 * eid]);
+    }
+    return vertices;
+}
+
+void DistanceTableEngine::table(const std::vector<int> &sources, const std::vector<int> &targets,
+                                DistanceTable &out, bool withPaths) {
+    Impl &im = *impl;
+    const int rows = static_cast<int>(sources.size());
+    const int cols = static_cast<int>(targets.size());
+    out.sources.assign(sources.begin(), sources.end());
+    out.targets.assign(targets.begin(), targets.end());
+    out.distances.assign(static_cast<std::size_t>(rows) * cols, kInfinity);
+    out.pathOffsets.clear();
+    out.pathEdges.clear();
+    if (withPaths) {
+        out.pathOffsets.assign(static_cast<std::size_t>(rows) * cols + 1, 0);
+        if (static_cast<int>(im.rowPaths.size()) < rows) im.rowPaths.resize(rows);
+    }
+
+    // Mark the distinct targets once; every row stops when all of them
+    // are settled
+    im.beginTargets();
+    int distinctTargets = 0;
+    for (int t : targets)
+        if (im.valid(t) && im.targetStamp[t] != im.targetVersion) {
+            im.targetStamp[t] = im.targetVersion;
+            ++distinctTargets;
+        }
+    const std::uint32_t *targetStamp = im.targetStamp.data();
+    const std::uint32_t targetVersion = im.targetVersion;
+    auto isTarget = [targetStamp, targetVersion](int v) { return targetStamp[v] == targetVersion; };
+
+    im.visit([&](auto &index) {
+        im.executor.parallelFor(rows, [&](int i, unsigned worker) {
+            const int source = sources[i];
+            if (withPaths) im.rowPaths[i].clear();
+            if (!im.valid(source) || distinctTargets == 0) return;
+            auto &search = index.searches[worker];
+            ShortestPaths::dijkstra(index.csr, source, search, distinctTargets, isTarget);
+            double *row = &out.distances[static_cast<std::size_t>(i) * cols];
+            for (int j = 0; j < cols; ++j) {
+                const int t = targets[j];
+                if (!im.valid(t) || !search.reached(t)) continue;
+                row[j] = toDouble(search.dist[t]);
+                if (withPaths) {
+                    const std::size_t before = im.rowPaths[i].size();
+                    im.appendPath(search, source, t, im.rowPaths[i]);
+                    out.pathOffsets[static_cast<std::size_t>(i) * cols + j + 1] =
+                        static_cast<int>(im.rowPaths[i].size() - before);
+                }
+            }
+        });
+        for (auto &search : index.searches) {
+            im.total.settled += search.settled;
+            im.total.edgesRelaxed += search.relaxed;
+            search.settled = search.relaxed = search.pushes = search.pops = 0;
+        }
+        return 0;
+    });
+    for (int source : sources)
+        if (im.valid(source)) im.total.searches++;
+
+    if (withPaths) {
+        // Lengths → offsets, then the rows in order
+        for (std::size_t k = 1; k < out.pathOffsets.size(); ++k)
+            out.pathOffsets[k] += out.pathOffsets[k - 1];
+        out.pathEdges.reserve(out.pathOffsets.back());
+        for (int i = 0; i < rows; ++i)
+            out.pathEdges.insert(out.pathEdges.end(), im.rowPaths[i].begin(), im.rowPaths[i].end());
+    }
+}
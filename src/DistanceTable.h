@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Graph.h"
+
+/* ============================================================
+   DistanceTable — many-to-many shortest-path queries
+   ------------------------------------------------------------
+   DistanceTableEngine snapshots a graph once (CSR, integer
+   weights when every street is a whole number) and then answers
+   point-to-point queries and sources × targets tables without
+   touching the Graph again. Each source runs one Dijkstra that
+   stops as soon as every requested target is settled. Search
+   buffers are version-stamped, so a query costs what it visits,
+   not O(V) of re-initialisation. Table rows are spread over a
+   ParallelExecutor with one search state per worker.
+
+   An engine is not safe for concurrent calls; give each thread
+   its own. After editing the graph, call rebuild().
+   ============================================================ */
+struct DistanceTable {
+    std::vector<int> sources;
+    std::vector<int> targets;
+    // sources.size() × targets.size(), row-major; +infinity when the
+    // target cannot be reached (or a vertex id is out of range)
+    std::vector<double> distances;
+    // Filled only when paths were requested: the edges of pair (i, j),
+    // from sources[i] to targets[j], are
+    // pathEdges[pathOffsets[k] .. pathOffsets[k + 1]), k = i·targets + j
+    std::vector<int> pathOffsets;
+    std::vector<int> pathEdges;
+
+    double distance(int i, int j) const {
+        return distances[static_cast<std::size_t>(i) * targets.size() + j];
+    }
+    bool hasPaths() const { return !pathOffsets.empty(); }
+};
+
+class DistanceTableEngine {
+public:
+    // threads == 0 → all cores (used by table() only)
+    explicit DistanceTableEngine(const Graph &g, unsigned threads = 0);
+    ~DistanceTableEngine();
+    DistanceTableEngine(DistanceTableEngine &&) noexcept;
+    DistanceTableEngine& operator=(DistanceTableEngine &&) noexcept;
+
+    // Re-snapshot after the graph changed; search buffers are kept
+    void rebuild(const Graph &g);
+
+    int vertexCount() const;
+    bool integerWeights() const;
+
+    // +infinity when unreachable
+    double distance(int source, int target);
+    // Edge ids from source to target; empty when unreachable or equal
+    std::vector<int> pathEdges(int source, int target);
+    // source, ..., target; empty when unreachable
+    std::vector<int> pathVertices(int source, int target);
+
+    // Fills out.distances (and the paths when withPaths) for every
+    // source × target pair, reusing out's capacity.
+    void table(const std::vector<int> &sources, const std::vector<int> &targets,
+               DistanceTable &out, bool withPaths = false);
+
+    // Work done by all queries so far
+    struct Counters {
+        std::int64_t searches{0};
+        std::int64_t settled{0};
+        std::int64_t edgesRelaxed{0};
+    };
+    Counters counters() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
@@ -0,0 +1,308 @@
+#include "DistrictPostman.h"
+#include "Algorithms.h"
+#include "MinWeightMatching.h"
+#include "ParallelExecutor.h"
+#include "RuralPostman.h"
+#include "ShortestPaths.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+constexpr double kUnreachable = 1e9;   // "no path" in the matching matrix
+
+double ms(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Σ over odd vertices of half the distance to the nearest other odd
+// vertex: one multi-source Dijkstra labels every vertex with its nearest
+// odd source, and an edge between two cells closes a path between them
+double matchingLowerBound(const CsrAdjacency &csr, const std::vector<Edge> &edges,
+                          const std::vector<int> &odd) {
+    if (odd.empty()) return 0.0;
+    const double inf = std::numeric_limits<double>::infinity();
+    const int n = csr.vertexCount();
+    std::vector<double> dist(n, inf);
+    std::vector<int> cell(n, -1);
+    ShortestPaths::BinaryHeap<double> queue;
+    for (int i = 0; i < static_cast<int>(odd.size()); ++i) {
+        dist[odd[i]] = 0.0;
+        cell[odd[i]] = i;
+        queue.push(0.0, odd[i]);
+    }
+    while (!queue.empty()) {
+        auto [du, u] = queue.pop();
+        if (du != dist[u]) continue;
+        for (int s = csr.begin(u); s < csr.end(u); ++s) {
+            const int v = csr.neighbors[s];
+            const double nd = du + csr.weights[s];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                cell[v] = cell[u];
+                queue.push(nd, v);
+            }
+        }
+    }
+    std::vector<double> nearest(odd.size(), inf);
+    for (const Edge &e : edges) {
+        const int a = cell[e.u], b = cell[e.v];
+        if (a < 0 || b < 0 || a == b) continue;
+        const double through = dist[e.u] + e.weight + dist[e.v];
+        nearest[a] = std::min(nearest[a], through);
+        nearest[b] = std::min(nearest[b], through);
+    }
+    double bound = 0.0;
+    for (double d : nearest)
+        if (d != inf) bound += 0.5 * d;
+    return bound;
+}
+}
+
+int DistrictPostman::districtCount(const Graph &g, const DistrictOptions &options) {
+    const int edges = static_cast<int>(g.getEdges().size());
+    int k = options.districts > 0 ? options.districts
+                                  : (edges + std::max(1, options.targetEdges) - 1) / std::max(1, options.targetEdges);
+    return std::max(1, std::min(k, static_cast<int>(g.getVertices().size())));
+}
+
+/* ============================================================
+   Hàm solve() — Chinese Postman theo từng quận
+   ============================================================ */
+DistrictResult DistrictPostman::solve(SolverContext &ctx, const Graph &g, const DistrictOptions &options) {
+    DistrictResult out;
+    ChinesePostmanResult &route = out.route;
+    const auto &verts = g.getVertices();
+    const auto &edges = g.getEdges();
+    const int n = static_cast<int>(verts.size());
+    // With optional streets only the required ones need to be connected,
+    // which RuralPostman checks itself
+    if (edges.empty() || g.hasDirectedEdges() || (!g.hasOptionalEdges() && !g.isConnectedUndirected()))
+        return out;
+
+    const auto start = Clock::now();
+    auto last = start;
+    auto mark = [&](const char *name) -> PhaseStats & {
+        const auto now = Clock::now();
+        PhaseStats p;
+        p.name = name;
+        p.startMs = ms(start, last);
+        p.wallMs = ms(last, now);
+        route.stats.phases.push_back(p);
+        last = now;
+        return route.stats.phases.back();
+    };
+    auto report = [&options](const char *phase, int done, int total) {
+        if (options.progress) options.progress(phase, done, total);
+    };
+    auto cancelled = [&options, &route]() {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed)) route.cancelled = true;
+        return route.cancelled;
+    };
+    double totalWeight = 0.0;
+    for (const Edge &e : edges) totalWeight += e.weight;
+
+    // --- B1. Chia quận ---
+    report("partition", 0, 1);
+    PartitionOptions partitionOptions;
+    // Optional streets: RuralPostman's sparse construction handles the
+    // whole city at once
+    partitionOptions.parts = g.hasOptionalEdges() ? 1 : districtCount(g, options);
+    partitionOptions.imbalance = options.imbalance;
+    out.partition = GraphPartitioner::partition(g, partitionOptions);
+    const GraphPartition &partition = out.partition;
+    const int k = partition.parts;
+    mark("partition");
+    if (cancelled()) return out;
+
+    if (k == 1) {
+        ChinesePostmanOptions single;
+        single.threads = options.threads;
+        single.cancel = options.cancel;
+        single.progress = options.progress;
+        single.dense = options.dense;
+        single.contractChains = options.contractChains;
+        PhaseStats partitionPhase = route.stats.phases.back();
+        if (g.hasOptionalEdges()) {
+            // A heuristic tour, bounded by the weight of the required streets
+            RuralPostmanResult rural = RuralPostman::solve(ctx, g, single);
+            route = std::move(rural.route);
+            out.cost = rural.cost;
+            out.lowerBound = rural.requiredCost;
+            out.gap = rural.gap;
+        } else {
+            // The exact solve: its cost is the bound
+            ChinesePostmanOptimal::solveInto(ctx, g, single, route);
+            for (int eid : route.edgeOrder) out.cost += edges[eid].weight;
+            out.lowerBound = out.cost;
+        }
+        route.stats.phases.insert(route.stats.phases.begin(), partitionPhase);
+        return out;
+    }
+
+    // --- B2. Mỗi quận: cạnh trong quận + đỉnh biên ảo, giải song song ---
+    std::vector<int> localIndex(n, 0);
+    std::vector<std::vector<int>> districtVertices(k), internalEdges(k), boundaryLinks(k);
+    std::vector<double> internalWeight(k, 0.0);
+    for (int v = 0; v < n; ++v) {
+        auto &list = districtVertices[partition.partOf[v]];
+        localIndex[v] = static_cast<int>(list.size());
+        list.push_back(v);
+    }
+    for (const Edge &e : edges) {
+        const int a = partition.partOf[e.u], b = partition.partOf[e.v];
+        if (a == b) {
+            internalEdges[a].push_back(e.id);
+            internalWeight[a] += e.weight;
+        } else {
+            boundaryLinks[a].push_back(localIndex[e.u]);
+            boundaryLinks[b].push_back(localIndex[e.v]);
+        }
+    }
+
+    ParallelExecutor executor(options.threads);
+    const unsigned workers = std::min<unsigned>(executor.workerCount(), static_cast<unsigned>(k));
+    if (ctx.workerContexts.size() + 1 < workers) ctx.workerContexts.resize(workers - 1);
+    std::vector<Graph> subgraphs(workers);
+    std::vector<ChinesePostmanResult> districtRoutes(k);
+    std::vector<std::vector<int>> districtDuplicates(k);
+    std::atomic<int> solved{0};
+    std::atomic<bool> failed{false};
+    ChinesePostmanOptions districtOptions;
+    districtOptions.threads = 1;
+    districtOptions.cancel = options.cancel;
+    districtOptions.dense = options.dense;
+    districtOptions.contractChains = options.contractChains;
+    report("districts", 0, k);
+    executor.parallelFor(k, [&](int d, unsigned worker) {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed)) return;
+        if (internalEdges[d].empty() && boundaryLinks[d].empty()) return;
+        Graph &sub = subgraphs[worker];
+        sub.clear();
+        for (int v : districtVertices[d]) sub.addVertex(verts[v].position, verts[v].name);
+        for (int eid : internalEdges[d])
+            sub.addEdge(localIndex[edges[eid].u], localIndex[edges[eid].v], edges[eid].weight);
+        // Dearer than any path inside the district; whole number, so
+        // integer weights stay integer
+        const int boundary = sub.addVertex(verts[districtVertices[d][0]].position, "boundary");
+        const double link = std::floor(internalWeight[d]) + 1.0;
+        for (int v : boundaryLinks[d]) sub.addEdge(v, boundary, link);
+
+        SolverContext &local = worker == 0 ? ctx : ctx.workerContexts[worker - 1];
+        ChinesePostmanResult &result = districtRoutes[d];
+        ChinesePostmanOptimal::solveInto(local, sub, districtOptions, result);
+        if (result.edgeOrder.empty() && !result.cancelled) failed = true;
+        const int internalCount = static_cast<int>(internalEdges[d].size());
+        for (int eid : result.duplicateEdgeIds)
+            if (eid < internalCount) districtDuplicates[d].push_back(internalEdges[d][eid]);
+        report("districts", ++solved, k);
+    });
+    PhaseStats &districtsPhase = mark("districts");
+    for (const ChinesePostmanResult &r : districtRoutes)
+        for (const PhaseStats &p : r.stats.phases) {
+            districtsPhase.heapPushes += p.heapPushes;
+            districtsPhase.heapPops += p.heapPops;
+            districtsPhase.edgesRelaxed += p.edgesRelaxed;
+            districtsPhase.peakBytes = std::max(districtsPhase.peakBytes, p.peakBytes);
+        }
+    if (cancelled() || failed) return out;
+
+    // --- B3. Ghép các đỉnh còn lẻ trên biên (toàn thành phố) ---
+    report("boundary_matching", 0, 1);
+    PostmanWorkspace &ws = ctx.postman;
+    ws.csr.assign(edges, n);
+    const CsrAdjacency &csr = ws.csr;
+    std::vector<int> copies(edges.size(), 0);
+    std::vector<char> odd(n, 0);
+    std::vector<int> cityOdd;
+    for (const Edge &e : edges) {
+        odd[e.u] ^= 1;
+        odd[e.v] ^= 1;
+    }
+    for (int v = 0; v < n; ++v)
+        if (odd[v]) cityOdd.push_back(v);
+    for (const auto &list : districtDuplicates)
+        for (int eid : list) {
+            ++copies[eid];
+            odd[edges[eid].u] ^= 1;
+            odd[edges[eid].v] ^= 1;
+        }
+    std::vector<int> leftover;
+    for (int v = 0; v < n; ++v)
+        if (odd[v]) leftover.push_back(v);
+    const int m = static_cast<int>(leftover.size());
+    out.boundaryOddVertices = m;
+
+    if (m > 0) {
+        std::vector<char> isLeftover(n, 0);
+        for (int v : leftover) isLeftover[v] = 1;
+        std::vector<ShortestPaths::StampedSearch<double>> searches(executor.workerCount());
+        std::vector<double> &dist = ws.distances;
+        dist.assign(static_cast<std::size_t>(m) * m, kUnreachable);
+        executor.parallelFor(m, [&](int i, unsigned worker) {
+            auto &search = searches[worker];
+            ShortestPaths::dijkstra(csr, leftover[i], search, m, [&isLeftover](int v) { return isLeftover[v] != 0; });
+            for (int j = 0; j < m; ++j)
+                if (search.reached(leftover[j]))
+                    dist[static_cast<std::size_t>(i) * m + j] = search.dist[leftover[j]];
+        });
+        if (cancelled()) return out;
+        if (!MinWeightMatching::solve(dist, m, ws.mate, ws.matching, kUnreachable, options.cancel)) {
+            cancelled();
+            return out;
+        }
+        // One targeted search per matched pair for its path
+        std::vector<int> pairs;
+        for (int i = 0; i < m; ++i)
+            if (ws.mate[i] > i) pairs.push_back(i);
+        std::vector<std::vector<int>> pairPaths(pairs.size());
+        executor.parallelFor(static_cast<int>(pairs.size()), [&](int p, unsigned worker) {
+            auto &search = searches[worker];
+            const int source = leftover[pairs[p]], target = leftover[ws.mate[pairs[p]]];
+            ShortestPaths::dijkstra(csr, source, search, 1, [target](int v) { return v == target; });
+            for (int v = target; v != source;) {
+                const int eid = search.parentEdge[v];
+                pairPaths[p].push_back(eid);
+                v = edges[eid].u == v ? edges[eid].v : edges[eid].u;
+            }
+        });
+        for (const auto &path : pairPaths)
+            for (int eid : path) ++copies[eid];
+    }
+    mark("boundary_matching");
+
+    // --- B4. Khâu tour: bỏ bản sao theo cặp, Hierholzer toàn thành phố ---
+    report("euler", 0, 1);
+    AugmentedGraph &augmented = ws.augmented;
+    augmented.reset(g);
+    for (int eid = 0; eid < static_cast<int>(edges.size()); ++eid)
+        if (copies[eid] % 2 != 0) {
+            augmented.duplicate(eid);
+            route.duplicateEdgeIds.push_back(eid);
+        }
+    if (!Algorithms::findEulerTourHierholzer(ctx, augmented, csr, route.edgeOrder, route.isCycle))
+        route.edgeOrder.clear();
+    mark("euler");
+
+    // --- B5. Cận dưới và khoảng cách tối ưu ---
+    report("lower_bound", 0, 1);
+    out.lowerBound = totalWeight + matchingLowerBound(csr, edges, cityOdd);
+    for (int eid : route.edgeOrder) out.cost += edges[eid].weight;
+    out.gap = out.lowerBound > 0.0 ? out.cost / out.lowerBound - 1.0 : 0.0;
+    mark("lower_bound");
+
+    route.stats.oddVertices = static_cast<int>(cityOdd.size());
+    route.stats.matchingCost = out.cost - totalWeight;
+    route.stats.threads = executor.workerCount();
+    route.stats.totalMs = ms(start, Clock::now());
+    for (const ChinesePostmanResult &r : districtRoutes) {
+        route.stats.integerWeights = route.stats.integerWeights || r.stats.integerWeights;
+        route.stats.dense = route.stats.dense || r.stats.dense;
+        route.stats.chainVertices += r.stats.chainVertices;
+    }
+    ctx.stats = route.stats;
+    return out;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "Graph.h"
+#include "ChinesePostman.h"
+#include "GraphPartitioner.h"
+#include "SolverContext.h"
+
+/* ============================================================
+   DistrictPostman — citywide postman, district by district
+   ------------------------------------------------------------
+   The exact solver needs shortest paths between every pair of
+   odd vertices and an O(n³) matching over them, which does not
+   scale to a whole city. Here:
+     B1. GraphPartitioner splits the streets into balanced,
+         compact districts (coordinate-seeded multilevel).
+     B2. Each district is solved concurrently by the exact
+         solver on its own streets plus one virtual "boundary"
+         vertex joined to every endpoint of a cut street. With
+         those links every district vertex keeps its citywide
+         degree, so it has the right parity, and each link costs
+         more than any real path inside the district. The
+         matching therefore routes through the boundary only
+         when a district vertex has no partner inside: at most
+         once, plus once per piece the cut left disconnected.
+         Virtual links are dropped from the duplicates, so the
+         defect moves onto a vertex at the district edge.
+     B3. Stitching: the vertices still odd after every district's
+         duplicates (a few per district, all on the boundary) are
+         matched citywide. Duplicates of the same street cancel
+         in pairs, and one Hierholzer walk over the whole city
+         threads the district tours together along the cut
+         streets. The graph is connected, so the walk covers
+         everything.
+     B4. Quality: the lower bound is total weight + ½ Σ (distance
+         from each odd vertex to its nearest other odd vertex).
+         It comes from one multi-source Dijkstra (Voronoi
+         cells), and the reported gap is cost / bound − 1.
+   The graph must be connected (see ComponentSolver; with optional
+   streets only the required ones) and two-way throughout:
+   district tours and the stitching paths do not follow one-way
+   streets. With one district this is the exact solve. A graph with optional streets (Edge::required) is solved
+   whole by RuralPostman, covering only the required streets, with
+   their weight as the bound.
+   ============================================================ */
+
+struct DistrictOptions {
+    // Number of districts; 0 = one per targetEdges streets
+    int districts{0};
+    int targetEdges{20000};
+    // Allowed district overweight (streets) over the average
+    double imbalance{0.05};
+    // Worker threads over the districts (0 = all cores)
+    unsigned threads{0};
+    // Polled per district and between stages
+    const std::atomic<bool> *cancel{nullptr};
+    // progress(phase, done, total); "districts" once per solved district
+    std::function<void(const char *phase, int done, int total)> progress;
+    // Passed to every district solve
+    DenseMode dense{DenseMode::Auto};
+    bool contractChains{false};
+};
+
+struct DistrictResult {
+    // Citywide tour (ids of the original graph); route.stats holds the
+    // district phases
+    ChinesePostmanResult route;
+    GraphPartition partition;
+    int boundaryOddVertices{0};   // matched across districts in B3
+    double cost{0.0};
+    double lowerBound{0.0};
+    double gap{0.0};              // cost / lowerBound − 1
+};
+
+class DistrictPostman {
+public:
+    static DistrictResult solve(SolverContext &ctx, const Graph &g, const DistrictOptions &options = {});
+    // Number of districts options.districts resolves to for g (solve()
+    // uses one when g has optional streets)
+    static int districtCount(const Graph &g, const DistrictOptions &options);
+};
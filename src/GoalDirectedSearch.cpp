@@ -0,0 +1,252 @@
+#include "GoalDirectedSearch.h"
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+constexpr char kMagic[4] = {'T', 'P', 'L', 'M'};
+constexpr std::uint32_t kFormatVersion = 1;
+// Rounding margin on the geometric bound, so floating-point error in
+// |v − t| never makes it overestimate
+constexpr double kScaleMargin = 1.0 - 1e-9;
+
+double straightLine(const Point2D &a, const Point2D &b) {
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+}
+
+/* ============================================================
+   LandmarkTable — chọn landmark xa nhau + bảng khoảng cách
+   ============================================================ */
+LandmarkTable LandmarkTable::build(const Graph &g, int count) {
+    const int n = static_cast<int>(g.getVertices().size());
+    LandmarkTable table;
+    table.vertices = n;
+    table.graphFingerprint = ContractionHierarchy::fingerprintOf(g);
+    if (n == 0 || count <= 0) return table;
+
+    const CsrAdjacency csr = g.csr();
+    DijkstraScratch buf;
+    // Distance to the nearest chosen landmark; -1 = not a candidate
+    // (already a landmark, or isolated while other vertices are not)
+    std::vector<double> nearest(n, kInfinity);
+    bool anyEdge = false;
+    for (int v = 0; v < n; ++v) anyEdge = anyEdge || csr.degree(v) > 0;
+    for (int v = 0; v < n; ++v)
+        if (anyEdge && csr.degree(v) == 0) nearest[v] = -1.0;
+    auto farthest = [&nearest, n]() {
+        int best = -1;
+        for (int v = 0; v < n; ++v)
+            if (nearest[v] >= 0.0 && (best < 0 || nearest[v] > nearest[best])) best = v;
+        return best;
+    };
+
+    // --- B1. Điểm xuất phát: đỉnh xa nhất (cùng thành phần) từ một đỉnh bất kỳ ---
+    int start = 0;
+    while (start < n && nearest[start] < 0.0) ++start;
+    ShortestPaths::dijkstra(csr, start, buf);
+    int next = start;
+    for (int v = 0; v < n; ++v)
+        if (nearest[v] >= 0.0 && buf.dist[v] != kInfinity && buf.dist[v] > buf.dist[next]) next = v;
+
+    // --- B2. Mỗi landmark tiếp theo xa nhất so với các landmark đã chọn ---
+    // Unreachable vertices count as farthest, so every component gets
+    // a landmark before any component gets a second one.
+    std::vector<std::vector<double>> columns;
+    while (next >= 0 && static_cast<int>(columns.size()) < count) {
+        ShortestPaths::dijkstra(csr, next, buf);
+        table.landmarkIds.push_back(next);
+        columns.push_back(buf.dist);
+        for (int v = 0; v < n; ++v)
+            if (nearest[v] >= 0.0) nearest[v] = std::min(nearest[v], buf.dist[v]);
+        nearest[next] = -1.0;
+        next = farthest();
+    }
+
+    // --- B3. Bảng V × L theo đỉnh (các landmark của một đỉnh liền nhau) ---
+    const std::size_t l = columns.size();
+    table.distances.resize(static_cast<std::size_t>(n) * l);
+    for (int v = 0; v < n; ++v)
+        for (std::size_t i = 0; i < l; ++i)
+            table.distances[static_cast<std::size_t>(v) * l + i] = columns[i][v];
+    return table;
+}
+
+bool LandmarkTable::matches(const Graph &g) const {
+    return !empty() && vertices == static_cast<int>(g.getVertices().size())
+        && graphFingerprint == ContractionHierarchy::fingerprintOf(g);
+}
+
+bool LandmarkTable::save(const std::filesystem::path &file) const {
+    std::ofstream out(file, std::ios::binary);
+    if (!out) return false;
+    const std::int32_t counts[2] = {vertices, landmarkCount()};
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char *>(&kFormatVersion), sizeof(kFormatVersion));
+    out.write(reinterpret_cast<const char *>(&graphFingerprint), sizeof(graphFingerprint));
+    out.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+    out.write(reinterpret_cast<const char *>(landmarkIds.data()),
+              static_cast<std::streamsize>(landmarkIds.size() * sizeof(int)));
+    out.write(reinterpret_cast<const char *>(distances.data()),
+              static_cast<std::streamsize>(distances.size() * sizeof(double)));
+    return static_cast<bool>(out);
+}
+
+bool LandmarkTable::load(const std::filesystem::path &file, LandmarkTable &out) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) return false;
+    char magic[4];
+    std::uint32_t version = 0;
+    std::int32_t counts[2] = {0, 0};
+    LandmarkTable table;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0) return false;
+    if (!in.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != kFormatVersion) return false;
+    if (!in.read(reinterpret_cast<char *>(&table.graphFingerprint), sizeof(table.graphFingerprint))) return false;
+    if (!in.read(reinterpret_cast<char *>(counts), sizeof(counts))) return false;
+    const int n = counts[0], l = counts[1];
+    if (n < 0 || l <= 0 || l > n) return false;
+    table.vertices = n;
+    table.landmarkIds.resize(l);
+    table.distances.resize(static_cast<std::size_t>(n) * l);
+    if (!in.read(reinterpret_cast<char *>(table.landmarkIds.data()),
+                 static_cast<std::streamsize>(table.landmarkIds.size() * sizeof(int)))
+        || !in.read(reinterpret_cast<char *>(table.distances.data()),
+                    static_cast<std::streamsize>(table.distances.size() * sizeof(double))))
+        return false;
+    for (int id : table.landmarkIds)
+        if (id < 0 || id >= n) return false;
+    out = std::move(table);
+    return true;
+}
+
+/* ============================================================
+   GoalDirectedSearch
+   ============================================================ */
+GoalDirectedSearch::GoalDirectedSearch(const Graph &g, const LandmarkTable *table) {
+    rebuild(g, table);
+}
+
+void GoalDirectedSearch::rebuild(const Graph &g, const LandmarkTable *table) {
+    const auto &edges = g.getEdges();
+    const auto &verts = g.getVertices();
+    csr.assign(edges, static_cast<int>(verts.size()));
+    positions.resize(verts.size());
+    for (std::size_t v = 0; v < verts.size(); ++v) positions[v] = verts[v].position;
+    edgeEnds.resize(2 * edges.size());
+
+    // Largest scale with scale · |uv| <= weight on every edge
+    scale = kInfinity;
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        const Edge &e = edges[i];
+        edgeEnds[2 * i] = e.u;
+        edgeEnds[2 * i + 1] = e.v;
+        const double length = straightLine(positions[e.u], positions[e.v]);
+        if (length > 0.0) scale = std::min(scale, std::max(0.0, e.weight) / length);
+    }
+    scale = scale == kInfinity ? 0.0 : scale * kScaleMargin;
+
+    landmarks = table && table->matches(g) ? table : nullptr;
+}
+
+template <typename Bound>
+bool GoalDirectedSearch::run(int source, int target, const Bound &bound) {
+    search.begin(vertexCount());
+    if (potential.size() != search.dist.size()) potential.resize(search.dist.size());
+    auto &queue = search.queue;
+    Counters counters;
+
+    const double h0 = bound(source);
+    bool found = false;
+    if (h0 != kInfinity) {
+        search.stamp[source] = search.version;
+        search.dist[source] = 0.0;
+        search.parentEdge[source] = -1;
+        potential[source] = h0;
+        queue.push(h0, source);
+    }
+    while (!queue.empty()) {
+        auto [f, u] = queue.pop();
+        const double du = search.dist[u];
+        if (f != du + potential[u]) continue;
+        ++counters.settled;
+        if (u == target) { found = true; break; }
+        counters.edgesRelaxed += csr.end(u) - csr.begin(u);
+        for (int s = csr.begin(u); s < csr.end(u); ++s) {
+            const int v = csr.neighbors[s];
+            const double nd = du + csr.weights[s];
+            if (!search.reached(v)) {
+                const double h = bound(v);
+                if (h == kInfinity) continue;   // cannot reach the target
+                search.stamp[v] = search.version;
+                potential[v] = h;
+            } else if (nd >= search.dist[v]) {
+                continue;
+            }
+            search.dist[v] = nd;
+            search.parentEdge[v] = csr.edgeIds[s];
+            queue.push(nd + potential[v], v);
+        }
+    }
+    last = counters;
+    return found;
+}
+
+bool GoalDirectedSearch::run(int source, int target, SearchMode mode) {
+    const Point2D goal = positions[target];
+    const double k = scale;
+    auto geometric = [this, goal, k](int v) { return k * straightLine(positions[v], goal); };
+
+    if (mode == SearchMode::Landmarks && landmarks) {
+        const int l = landmarks->landmarkCount();
+        const double *t = landmarks->row(target);
+        targetRow.assign(t, t + l);
+        const double *tr = targetRow.data();
+        const LandmarkTable &table = *landmarks;
+        return run(source, target, [&, tr, l](int v) {
+            double h = k > 0.0 ? geometric(v) : 0.0;
+            const double *row = table.row(v);
+            for (int i = 0; i < l; ++i) {
+                // A landmark reaching exactly one of v, t proves that
+                // they lie in different components
+                if ((tr[i] == kInfinity) != (row[i] == kInfinity)) return kInfinity;
+                if (tr[i] != kInfinity) h = std::max(h, std::abs(tr[i] - row[i]));
+            }
+            return h;
+        });
+    }
+    if (mode != SearchMode::Dijkstra && k > 0.0) return run(source, target, geometric);
+    return run(source, target, [](int) { return 0.0; });
+}
+
+double GoalDirectedSearch::distance(int source, int target, SearchMode mode) {
+    if (!valid(source) || !valid(target)) return kInfinity;
+    return run(source, target, mode) ? search.dist[target] : kInfinity;
+}
+
+bool GoalDirectedSearch::pathEdges(int source, int target, SearchMode mode, std::vector<int> &edgeIds) {
+    edgeIds.clear();
+    if (!valid(source) || !valid(target) || !run(source, target, mode)) return false;
+    for (int v = target; v != source;) {
+        const int eid = search.parentEdge[v];
+        edgeIds.push_back(eid);
+        v = edgeEnds[2 * eid] == v ? edgeEnds[2 * eid + 1] : edgeEnds[2 * eid];
+    }
+    std::reverse(edgeIds.begin(), edgeIds.end());
+    return true;
+}
+
+std::vector<int> GoalDirectedSearch::pathVertices(int source, int target, SearchMode mode) {
+    std::vector<int> vertices;
+    std::vector<int> edges;
+    if (!pathEdges(source, target, mode, edges)) return vertices;
+    vertices.push_back(source);
+    for (int eid : edges) {
+        const int v = vertices.back();
+        vertices.push_back(edgeEnds[2 * eid] == v ? edgeEnds[2 * eid + 1] : edgeEnds[2 * eid]);
+    }
+    return vertices;
+}
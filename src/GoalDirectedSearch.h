@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include "Graph.h"
+#include "ShortestPaths.h"
+
+/* ============================================================
+   GoalDirectedSearch — A* / ALT point-to-point queries
+   ------------------------------------------------------------
+   Dijkstra settles everything closer than the target, in every
+   direction. A* orders the queue by d(s, v) + h(v) with a lower
+   bound h on d(v, t), so it grows towards the target instead:
+     - AStar: h(v) = scale · |v − t| from the vertex positions.
+       scale is the smallest weight / segment length over all
+       edges, which makes h consistent for ANY weights; when the
+       weights are the street lengths (the synthetic networks,
+       most surveyed maps) scale ≈ 1 and the bound is tight. A
+       zero-length street with positive weight is fine, a
+       positive-length street of weight 0 turns the bound off.
+     - Landmarks (ALT): a few landmark vertices with a full
+       distance table each; by the triangle inequality
+       h(v) = max_L |d(L, t) − d(L, v)|. Landmarks are picked far
+       apart (each one the vertex farthest from those already
+       chosen), so h does not depend on the coordinates at all.
+       The geometric bound is folded in with max() when present.
+   Both bounds are consistent, so every vertex is settled once
+   and the first time t is popped its path is shortest.
+
+   The landmark table is per location (landmarks.alt next to
+   coords.txt / matrix.txt) and bound to its graph by the same
+   edge-list fingerprint as the contraction hierarchy.
+   ============================================================ */
+
+enum class SearchMode {
+    Dijkstra,
+    AStar,      // geometric lower bound
+    Landmarks,  // ALT (+ geometric bound); AStar without a table
+};
+
+class LandmarkTable {
+public:
+    static constexpr const char *kFileName = "landmarks.alt";
+
+    LandmarkTable() = default;
+
+    // count landmarks (fewer on tiny graphs), one full Dijkstra each
+    static LandmarkTable build(const Graph &g, int count = 16);
+
+    bool empty() const { return landmarkIds.empty(); }
+    int landmarkCount() const { return static_cast<int>(landmarkIds.size()); }
+    int vertexCount() const { return vertices; }
+    const std::vector<int>& landmarks() const { return landmarkIds; }
+    // d(landmarks()[i], v); +infinity when unreachable
+    double distance(int i, int v) const {
+        return distances[static_cast<std::size_t>(v) * landmarkIds.size() + i];
+    }
+    // All landmark distances of v, contiguous
+    const double* row(int v) const { return &distances[static_cast<std::size_t>(v) * landmarkIds.size()]; }
+
+    bool matches(const Graph &g) const;
+
+    bool save(const std::filesystem::path &file) const;
+    static bool load(const std::filesystem::path &file, LandmarkTable &out);
+
+private:
+    std::vector<int> landmarkIds;
+    std::vector<double> distances;   // V × L, vertex-major
+    int vertices{0};
+    std::uint64_t graphFingerprint{0};
+};
+
+class GoalDirectedSearch {
+public:
+    // The landmark table, when given, must outlive the search; it is
+    // used only if it matches the graph
+    explicit GoalDirectedSearch(const Graph &g, const LandmarkTable *landmarks = nullptr);
+
+    // Re-snapshot after the graph changed; search buffers are kept
+    void rebuild(const Graph &g, const LandmarkTable *landmarks = nullptr);
+
+    int vertexCount() const { return csr.vertexCount(); }
+    // 0 when the coordinates give no usable bound
+    double geometricScale() const { return scale; }
+    bool hasLandmarks() const { return landmarks != nullptr; }
+
+    // +infinity when unreachable or out of range
+    double distance(int source, int target, SearchMode mode);
+    // Edge ids from source to target; false when unreachable
+    bool pathEdges(int source, int target, SearchMode mode, std::vector<int> &edgeIds);
+    // source, ..., target; empty when unreachable
+    std::vector<int> pathVertices(int source, int target, SearchMode mode);
+
+    // Work of the last query
+    struct Counters {
+        std::int64_t settled{0};
+        std::int64_t edgesRelaxed{0};
+    };
+    Counters lastQuery() const { return last; }
+
+private:
+    CsrAdjacency csr;
+    std::vector<Point2D> positions;
+    std::vector<int> edgeEnds;   // u, v of every edge id
+    double scale{0.0};
+    const LandmarkTable *landmarks{nullptr};
+
+    ShortestPaths::StampedSearch<double> search;
+    std::vector<double> potential;   // h(v), valid where search.reached(v)
+    std::vector<double> targetRow;   // d(L, target) of every landmark
+    Counters last;
+
+    bool valid(int v) const { return v >= 0 && v < vertexCount(); }
+    // A* from source; true when target was settled
+    bool run(int source, int target, SearchMode mode);
+    template <typename Bound>
+    bool run(int source, int target, const Bound &bound);
+};
@@ -1,13 +1,18 @@
 #pragma once
-#include <QPointF>
-#include <QString>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
+// Plain 2D coordinate so the solver core does not depend on Qt
+struct Point2D {
+    double x{0.0};
+    double y{0.0};
+};
+
 struct Vertex {
     int id;
-    QString name;
-    QPointF position;
+    std::string name;
+    Point2D position;
 };
 
 struct Edge {
@@ -15,8 +20,115 @@ struct Edge {
     int u, v;
     double weight;
     bool directed{false};
+    // Street that must be inspected; the others may be driven through
+    // but need not be (rural postman, RuralPostman.h)
+    bool required{true};
 };
 
+// -----------------------------
+// CSR ADJACENCY SNAPSHOT
+// -----------------------------
+// Immutable compressed-sparse-row view of an edge list. The edges
+// incident to v are the slots [offsets[v], offsets[v + 1]); for each
+// slot, neighbors[] holds the opposite endpoint and edgeIds[] the edge
+// id. Edges are undirected here (even directed ones), so a
+// self-loop occupies two slots of its vertex. The topology is shared
+// by every weight type; walks that ignore weights (Euler, BFS) take
+// a CsrTopology.
+struct CsrTopology {
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+    std::vector<int> edgeIds;
+
+    int vertexCount() const { return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1; }
+    int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+    int begin(int v) const { return offsets[v]; }
+    int end(int v) const { return offsets[v + 1]; }
+
+    // All vertices with degree > 0 lie in a single component (BFS, O(V+E)).
+    bool isConnected() const {
+        std::vector<char> visited;
+        std::vector<int> queue;
+        return isConnected(visited, queue);
+    }
+
+    // Same, with caller-owned scratch for the BFS
+    bool isConnected(std::vector<char> &visited, std::vector<int> &queue) const {
+        const int n = vertexCount();
+        int start = -1;
+        for (int v = 0; v < n; ++v)
+            if (degree(v) > 0) { start = v; break; }
+        if (start == -1) return true;
+
+        visited.assign(n, 0);
+        queue.clear();
+        queue.push_back(start);
+        visited[start] = 1;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            for (int s = begin(u); s < end(u); ++s) {
+                int w = neighbors[s];
+                if (!visited[w]) { visited[w] = 1; queue.push_back(w); }
+            }
+        }
+        for (int v = 0; v < n; ++v)
+            if (!visited[v] && degree(v) > 0) return false;
+        return true;
+    }
+};
+
+// Topology plus weights[] per slot, stored as W. Edge weights are
+// converted with static_cast, so an integral W is only meaningful
+// when every weight is a whole number (see ShortestPaths.h).
+template <typename W>
+struct BasicCsrAdjacency : CsrTopology {
+    using Weight = W;
+    std::vector<W> weights;
+
+    static BasicCsrAdjacency build(const std::vector<Edge> &edges, int vertexCount) {
+        BasicCsrAdjacency csr;
+        csr.assign(edges, vertexCount);
+        return csr;
+    }
+
+    // Rebuilds in place, reusing the capacity of every array, so a
+    // snapshot kept across solves stops allocating once it is warm.
+    void assign(const std::vector<Edge> &edges, int vertexCount) {
+        offsets.assign(vertexCount + 1, 0);
+        auto valid = [vertexCount](const Edge &e) {
+            return e.u >= 0 && e.v >= 0 && e.u < vertexCount && e.v < vertexCount;
+        };
+        for (const auto &e : edges) {
+            if (!valid(e)) continue;
+            offsets[e.u + 1]++;
+            offsets[e.v + 1]++;
+        }
+        for (int v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+
+        const int slots = offsets[vertexCount];
+        neighbors.resize(slots);
+        edgeIds.resize(slots);
+        weights.resize(slots);
+        // offsets[v] doubles as the fill cursor of v; afterwards it has
+        // moved to the old offsets[v + 1], so shift everything back.
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const Edge &e = edges[i];
+            if (!valid(e)) continue;
+            const W w = static_cast<W>(e.weight);
+            int a = offsets[e.u]++;
+            neighbors[a] = e.v; edgeIds[a] = static_cast<int>(i); weights[a] = w;
+            int b = offsets[e.v]++;
+            neighbors[b] = e.u; edgeIds[b] = static_cast<int>(i); weights[b] = w;
+        }
+        for (int v = vertexCount; v > 0; --v)
+            offsets[v] = offsets[v - 1];
+        offsets[0] = 0;
+    }
+};
+
+using CsrAdjacency = BasicCsrAdjacency<double>;
+
 class Graph {
 private:
     std::vector<Vertex> vertices;
@@ -29,11 +141,11 @@ public:
     // -----------------------------
     // BASIC GRAPH MODIFICATION
     // -----------------------------
-    int addVertex(const QPointF &pos, const QString &name = QString()) {
+    int addVertex(const Point2D &pos, const std::string &name = std::string()) {
         Vertex v;
         v.id = static_cast<int>(vertices.size());
         v.position = pos;
-        v.name = name.isEmpty() ? QString(QChar('A' + v.id)) : name;
+        v.name = name.empty() ? defaultVertexName(v.id) : name;
         vertices.push_back(v);
         return v.id;
     }
@@ -65,7 +177,15 @@ public:
         duplicateEdgeIds.clear();
     }
 
-    void moveVertex(int id, const QPointF &pos) {
+    // A, B, ..., Z, AA, AB, ...
+    static std::string defaultVertexName(int index) {
+        std::string s;
+        for (int i = index; i >= 0; i = i / 26 - 1)
+            s.insert(s.begin(), static_cast<char>('A' + i % 26));
+        return s;
+    }
+
+    void moveVertex(int id, const Point2D &pos) {
         if (id >= 0 && id < static_cast<int>(vertices.size()))
             vertices[id].position = pos;
     }
@@ -101,44 +221,71 @@ public:
     // -----------------------------
     // CONNECTIVITY (DFS)
     // -----------------------------
+    // Explicit stack over a CSR snapshot: a long chain of streets must
+    // not overflow the call stack. Directed edges are followed u → v
+    // only, as in neighbors(). Components: see GraphComponents.
     void dfs(int start, std::vector<bool> &visited) const {
+        const CsrAdjacency topo = csr();
+        std::vector<int> stack{start};
         visited[start] = true;
-        for (int v : neighbors(start))
-            if (!visited[v])
-                dfs(v, visited);
+        while (!stack.empty()) {
+            const int u = stack.back();
+            stack.pop_back();
+            for (int s = topo.begin(u); s < topo.end(u); ++s) {
+                const Edge &e = edges[topo.edgeIds[s]];
+                const int v = topo.neighbors[s];
+                if (visited[v] || (e.directed && e.u != u)) continue;
+                visited[v] = true;
+                stack.push_back(v);
+            }
+        }
     }
 
     bool isConnectedUndirected() const {
-        if (vertices.empty()) return true;
-        std::vector<bool> visited(vertices.size(), false);
-
-        // tìm 1 đỉnh có bậc > 0 làm điểm bắt đầu
-        int start = -1;
-        for (size_t i = 0; i < vertices.size(); ++i)
-            if (degree(i) > 0) { start = i; break; }
-
-        if (start == -1) return true;  // không có cạnh nào
+        return csr().isConnected();
+    }
 
-        dfs(start, visited);
+    // One-way streets present: the postman and Euler solvers switch to
+    // the directed / mixed versions (MixedPostman.h)
+    bool hasDirectedEdges() const {
+        for (const auto &e : edges)
+            if (e.directed) return true;
+        return false;
+    }
 
-        for (size_t i = 0; i < vertices.size(); ++i)
-            if (!visited[i] && degree(i) > 0)
-                return false;
-        return true;
+    // Some street is not required: the postman covers only the
+    // required ones (RuralPostman.h)
+    bool hasOptionalEdges() const {
+        for (const auto &e : edges)
+            if (!e.required) return true;
+        return false;
     }
 
     // -----------------------------
     // ADJACENCY REPRESENTATION
     // -----------------------------
+    // Edge ids leaving each vertex: a directed edge is listed at its
+    // tail u only, as in neighbors()
     std::unordered_map<int, std::vector<int>> adjacency() const {
         std::unordered_map<int, std::vector<int>> adj;
         for (const auto &e : edges) {
             adj[e.u].push_back(e.id);
-            adj[e.v].push_back(e.id);
+            if (!e.directed) adj[e.v].push_back(e.id);
         }
         return adj;
     }
 
+    // Packed snapshot for the solver hot paths; build once per solve.
+    CsrAdjacency csr() const {
+        return CsrAdjacency::build(edges, static_cast<int>(vertices.size()));
+    }
+
+    // Same, with the weights stored as W (e.g. whole meters)
+    template <typename W>
+    BasicCsrAdjacency<W> csrAs() const {
+        return BasicCsrAdjacency<W>::build(edges, static_cast<int>(vertices.size()));
+    }
+
     // -----------------------------
     // DUPLICATE EDGE MANAGEMENT
     // -----------------------------
@@ -1,4 +1,5 @@
 #include "GraphCanvas.h"
+#include "QtGraphAdapters.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <QtMath>
@@ -41,6 +42,7 @@ GraphCanvas::GraphCanvas(QWidget *parent) : QWidget(parent) {
 void GraphCanvas::setRoute(const std::vector<int>& edgeOrder) {
     routeEdgeOrder = edgeOrder;
     duplicateEdgeIds.clear();
+    routeSets.clear();
     originalEdgeCount = 0;
     update();
 }
@@ -52,12 +54,22 @@ void GraphCanvas::setRouteWithDuplicates(const std::vector<int>& edgeOrder,
     routeEdgeOrder = edgeOrder;
     duplicateEdgeIds = dupIds;
     this->originalEdgeCount = originalEdgeCount;
+    routeSets.clear();
+    update();
+}
+
+void GraphCanvas::setRoutes(const std::vector<std::vector<int>>& edgeOrders) {
+    routeEdgeOrder.clear();
+    duplicateEdgeIds.clear();
+    originalEdgeCount = 0;
+    routeSets = edgeOrders;
     update();
 }
 
 void GraphCanvas::clearRoute() {
     routeEdgeOrder.clear();
     duplicateEdgeIds.clear();
+    routeSets.clear();
     update();
 }
 
@@ -66,7 +78,7 @@ void GraphCanvas::clearRoute() {
    ============================================================ */
 int GraphCanvas::hitTestVertex(const QPointF &p) const {
     for (const auto &v : graph.getVertices()) {
-        if (QLineF(p, v.position).length() <= VERTEX_RADIUS + 3)
+        if (QLineF(p, toQPointF(v.position)).length() <= VERTEX_RADIUS + 3)
             return v.id;
     }
     return -1;
@@ -85,14 +97,17 @@ void GraphCanvas::paintEvent(QPaintEvent*) {
     const auto &edges = graph.getEdges();
     const auto &verts = graph.getVertices();
 
-    // --- Vẽ cạnh nền ---
+    // --- Vẽ cạnh nền (cạnh không bắt buộc: nét đứt, nhạt) ---
     QPen basePen(QColor(160, 160, 160));
     basePen.setWidth(2);
-    painter.setPen(basePen);
+    QPen optionalPen(QColor(200, 200, 200));
+    optionalPen.setWidth(1);
+    optionalPen.setStyle(Qt::DashLine);
     for (const auto &e : edges) {
         const auto &u = verts[e.u];
         const auto &v = verts[e.v];
-        painter.drawLine(u.position, v.position);
+        painter.setPen(e.required ? basePen : optionalPen);
+        painter.drawLine(toQPointF(u.position), toQPointF(v.position));
     }
 
     // --- Vẽ route nếu có ---
@@ -107,7 +122,7 @@ void GraphCanvas::paintEvent(QPaintEvent*) {
             const auto &e = edges[eid];
             const auto &u = verts[e.u];
             const auto &v = verts[e.v];
-            painter.drawLine(u.position, v.position);
+            painter.drawLine(toQPointF(u.position), toQPointF(v.position));
         }
 
         // 🔴 Cạnh duplicated (theo danh sách ID gốc)
@@ -122,12 +137,24 @@ void GraphCanvas::paintEvent(QPaintEvent*) {
                     const auto &e = edges[eid];
                     const auto &u = verts[e.u];
                     const auto &v = verts[e.v];
-                    painter.drawLine(u.position, v.position);
+                    painter.drawLine(toQPointF(u.position), toQPointF(v.position));
                 }
             }
         }
     }
 
+    // --- Vẽ nhiều tuyến (mỗi đơn vị tuần tra một màu) ---
+    for (size_t r = 0; r < routeSets.size(); ++r) {
+        QPen routePen(routeColor(static_cast<int>(r)));
+        routePen.setWidth(4);
+        painter.setPen(routePen);
+        for (int eid : routeSets[r]) {
+            if (eid < 0 || static_cast<size_t>(eid) >= edges.size()) continue;
+            const auto &e = edges[eid];
+            painter.drawLine(toQPointF(verts[e.u].position), toQPointF(verts[e.v].position));
+        }
+    }
+
     // --- Vẽ nhãn cạnh ---
     painter.setPen(Qt::black);
     QFont edgeFont = painter.font();
@@ -136,9 +163,9 @@ void GraphCanvas::paintEvent(QPaintEvent*) {
     for (const auto &e : edges) {
         const auto &u = verts[e.u];
         const auto &v = verts[e.v];
-        QPointF mid((u.position.x() + v.position.x()) / 2.0,
-                    (u.position.y() + v.position.y()) / 2.0);
-        QPointF d = v.position - u.position;
+        QPointF mid((u.position.x + v.position.x) / 2.0,
+                    (u.position.y + v.position.y) / 2.0);
+        QPointF d = toQPointF(v.position) - toQPointF(u.position);
         double len = std::hypot(d.x(), d.y());
         QPointF n = (len > 0.0) ? QPointF(-d.y()/len, d.x()/len) : QPointF(0.0, -1.0);
         QPointF pos = mid + n * 10.0;
@@ -153,10 +180,10 @@ void GraphCanvas::paintEvent(QPaintEvent*) {
     for (const auto &v : verts) {
         painter.setBrush(Qt::white);
         painter.setPen(QPen(Qt::black, 2));
-        painter.drawEllipse(v.position, VERTEX_RADIUS, VERTEX_RADIUS);
-        QString label = v.name.isEmpty() ? indexToLetters(v.id) : v.name;
-        QRectF textRect(v.position.x() - VERTEX_RADIUS,
-                        v.position.y() - VERTEX_RADIUS - 28,
+        painter.drawEllipse(toQPointF(v.position), VERTEX_RADIUS, VERTEX_RADIUS);
+        QString label = v.name.empty() ? indexToLetters(v.id) : toQString(v.name);
+        QRectF textRect(v.position.x - VERTEX_RADIUS,
+                        v.position.y - VERTEX_RADIUS - 28,
                         VERTEX_RADIUS*2, VERTEX_RADIUS*2);
         painter.drawText(textRect, Qt::AlignHCenter | Qt::AlignBottom, label);
     }
@@ -167,7 +194,7 @@ void GraphCanvas::paintEvent(QPaintEvent*) {
    ============================================================ */
 void GraphCanvas::mousePressEvent(QMouseEvent *event) {
     if (mode == AddVertex) {
-        graph.addVertex(event->pos());
+        graph.addVertex(toPoint2D(event->pos()));
     } else if (mode == AddEdge) {
         if (selectedVertex < 0)
             selectedVertex = hitTestVertex(event->pos());
@@ -177,6 +204,18 @@ void GraphCanvas::mousePressEvent(QMouseEvent *event) {
                 graph.addEdge(selectedVertex, v2);
             selectedVertex = -1;
         }
+    } else if (mode == ToggleRequired) {
+        if (selectedVertex < 0)
+            selectedVertex = hitTestVertex(event->pos());
+        else {
+            int v2 = hitTestVertex(event->pos());
+            for (auto &e : graph.getEdges())
+                if ((e.u == selectedVertex && e.v == v2) || (e.u == v2 && e.v == selectedVertex)) {
+                    e.required = !e.required;
+                    emit statusMessage(e.required ? "Street required" : "Street optional");
+                }
+            selectedVertex = -1;
+        }
     } else if (mode == Eraser) {
         int vid = hitTestVertex(event->pos());
         if (vid >= 0) graph.removeVertex(vid);
@@ -190,7 +229,7 @@ void GraphCanvas::mouseMoveEvent(QMouseEvent *event) {
     if (mode == MoveVertex && selectedVertex >= 0) {
         auto &verts = graph.getVertices();
         if (selectedVertex < static_cast<int>(verts.size()))
-            graph.moveVertex(selectedVertex, event->pos());
+            graph.moveVertex(selectedVertex, toPoint2D(event->pos()));
         update();
     }
 }
@@ -13,7 +13,8 @@ public:
         AddVertex,
         AddEdge,
         MoveVertex,
-        Eraser
+        Eraser,
+        ToggleRequired   // click both ends of a street to flip Edge::required
     };
 
     explicit GraphCanvas(QWidget *parent = nullptr);
@@ -27,6 +28,8 @@ public:
     void setRouteWithDuplicates(const std::vector<int>& edgeOrder,
                                 const std::vector<int>& dupIds,
                                 int originalEdgeCount);
+    // Several routes at once (patrol units), one colour each
+    void setRoutes(const std::vector<std::vector<int>>& edgeOrders);
     void clearRoute();
 
     // === Background ===
@@ -56,6 +59,7 @@ private:
     std::vector<int> routeEdgeOrder;
     int originalEdgeCount{0};
     std::vector<int> duplicateEdgeIds;
+    std::vector<std::vector<int>> routeSets;
 
     // === Animation ===
     QTimer *animationTimer{nullptr};
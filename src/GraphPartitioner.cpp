@@ -0,0 +1,293 @@
+#include "GraphPartitioner.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+// One level of the hierarchy: weighted graph without self-loops,
+// parallel edges merged into one weighted arc
+struct Level {
+    int n{0};
+    std::vector<int> offsets;
+    std::vector<int> adj;
+    std::vector<std::int64_t> adjWeight;
+    std::vector<std::int64_t> vertexWeight;
+    std::vector<double> x, y;
+    std::vector<int> coarseOf;   // vertex of the next coarser level
+};
+
+// Merges the raw arc lists (duplicates allowed) into level.offsets /
+// adj / adjWeight
+void mergeArcs(Level &level, const std::vector<int> &rawOffsets, const std::vector<int> &rawAdj,
+               const std::vector<std::int64_t> &rawWeight) {
+    const int n = level.n;
+    level.offsets.assign(n + 1, 0);
+    level.adj.clear();
+    level.adjWeight.clear();
+    std::vector<int> slotOf(n, -1);
+    for (int v = 0; v < n; ++v) {
+        const int first = static_cast<int>(level.adj.size());
+        for (int s = rawOffsets[v]; s < rawOffsets[v + 1]; ++s) {
+            const int u = rawAdj[s];
+            if (slotOf[u] >= first) {
+                level.adjWeight[slotOf[u]] += rawWeight[s];
+            } else {
+                slotOf[u] = static_cast<int>(level.adj.size());
+                level.adj.push_back(u);
+                level.adjWeight.push_back(rawWeight[s]);
+            }
+        }
+        level.offsets[v + 1] = static_cast<int>(level.adj.size());
+    }
+}
+
+Level fromGraph(const Graph &g, const std::vector<std::int64_t> &weights) {
+    const auto &verts = g.getVertices();
+    const auto &edges = g.getEdges();
+    Level level;
+    level.n = static_cast<int>(verts.size());
+    std::vector<int> rawOffsets(level.n + 1, 0);
+    std::vector<int> degree(level.n, 0);
+    for (const Edge &e : edges) {
+        ++degree[e.u];
+        ++degree[e.v];
+        if (e.u == e.v) continue;
+        ++rawOffsets[e.u + 1];
+        ++rawOffsets[e.v + 1];
+    }
+    for (int v = 0; v < level.n; ++v) rawOffsets[v + 1] += rawOffsets[v];
+    std::vector<int> rawAdj(rawOffsets[level.n]);
+    std::vector<int> fill(rawOffsets.begin(), rawOffsets.end() - 1);
+    for (const Edge &e : edges) {
+        if (e.u == e.v) continue;
+        rawAdj[fill[e.u]++] = e.v;
+        rawAdj[fill[e.v]++] = e.u;
+    }
+    mergeArcs(level, rawOffsets, rawAdj, std::vector<std::int64_t>(rawAdj.size(), 1));
+
+    level.vertexWeight.resize(level.n);
+    level.x.resize(level.n);
+    level.y.resize(level.n);
+    for (int v = 0; v < level.n; ++v) {
+        level.vertexWeight[v] = weights.empty() ? std::max(1, degree[v]) : weights[v];
+        level.x[v] = verts[v].position.x;
+        level.y[v] = verts[v].position.y;
+    }
+    return level;
+}
+
+// Heavy-edge matching; fine.coarseOf is filled, the coarse level returned
+Level coarsen(Level &fine, std::mt19937 &rng, std::int64_t maxVertexWeight) {
+    const int n = fine.n;
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<int> match(n, -1);
+    for (int v : order) {
+        if (match[v] >= 0) continue;
+        int best = -1;
+        std::int64_t bestWeight = 0;
+        for (int s = fine.offsets[v]; s < fine.offsets[v + 1]; ++s) {
+            const int u = fine.adj[s];
+            if (match[u] >= 0 || fine.vertexWeight[v] + fine.vertexWeight[u] > maxVertexWeight) continue;
+            if (fine.adjWeight[s] > bestWeight) {
+                best = u;
+                bestWeight = fine.adjWeight[s];
+            }
+        }
+        match[v] = best >= 0 ? best : v;
+        if (best >= 0) match[best] = v;
+    }
+
+    Level coarse;
+    fine.coarseOf.assign(n, -1);
+    for (int v = 0; v < n; ++v) {
+        if (fine.coarseOf[v] >= 0) continue;
+        fine.coarseOf[v] = fine.coarseOf[match[v]] = coarse.n++;
+    }
+    coarse.vertexWeight.assign(coarse.n, 0);
+    coarse.x.assign(coarse.n, 0.0);
+    coarse.y.assign(coarse.n, 0.0);
+    std::vector<int> memberOffsets(coarse.n + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        const int c = fine.coarseOf[v];
+        const double w = static_cast<double>(fine.vertexWeight[v]);
+        coarse.vertexWeight[c] += fine.vertexWeight[v];
+        coarse.x[c] += w * fine.x[v];
+        coarse.y[c] += w * fine.y[v];
+        memberOffsets[c + 1] += fine.offsets[v + 1] - fine.offsets[v];
+    }
+    for (int c = 0; c < coarse.n; ++c) {
+        coarse.x[c] /= static_cast<double>(coarse.vertexWeight[c]);
+        coarse.y[c] /= static_cast<double>(coarse.vertexWeight[c]);
+        memberOffsets[c + 1] += memberOffsets[c];
+    }
+
+    // Arcs of both members, mapped to the coarse level; the arc between
+    // the two members disappears
+    std::vector<int> rawAdj(memberOffsets[coarse.n]);
+    std::vector<std::int64_t> rawWeight(rawAdj.size());
+    std::vector<int> fill(memberOffsets.begin(), memberOffsets.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        const int c = fine.coarseOf[v];
+        for (int s = fine.offsets[v]; s < fine.offsets[v + 1]; ++s) {
+            const int cu = fine.coarseOf[fine.adj[s]];
+            if (cu == c) continue;
+            rawAdj[fill[c]] = cu;
+            rawWeight[fill[c]++] = fine.adjWeight[s];
+        }
+    }
+    // Compact away the dropped slots before merging
+    std::vector<int> rawOffsets(coarse.n + 1, 0);
+    int out = 0;
+    for (int c = 0; c < coarse.n; ++c) {
+        for (int s = memberOffsets[c]; s < fill[c]; ++s) {
+            rawAdj[out] = rawAdj[s];
+            rawWeight[out++] = rawWeight[s];
+        }
+        rawOffsets[c + 1] = out;
+    }
+    mergeArcs(coarse, rawOffsets, rawAdj, rawWeight);
+    return coarse;
+}
+
+// Recursive coordinate bisection of `ids` into parts [firstPart, firstPart + k)
+void bisect(const Level &level, std::vector<int> &ids, int begin, int end, int firstPart, int k,
+            std::vector<int> &partOf) {
+    if (k == 1 || end - begin <= 1) {
+        for (int i = begin; i < end; ++i) partOf[ids[i]] = firstPart;
+        return;
+    }
+    double minX = level.x[ids[begin]], maxX = minX, minY = level.y[ids[begin]], maxY = minY;
+    std::int64_t total = 0;
+    for (int i = begin; i < end; ++i) {
+        const int v = ids[i];
+        minX = std::min(minX, level.x[v]);
+        maxX = std::max(maxX, level.x[v]);
+        minY = std::min(minY, level.y[v]);
+        maxY = std::max(maxY, level.y[v]);
+        total += level.vertexWeight[v];
+    }
+    const std::vector<double> &axis = maxX - minX >= maxY - minY ? level.x : level.y;
+    std::sort(ids.begin() + begin, ids.begin() + end, [&axis](int a, int b) {
+        return axis[a] < axis[b] || (axis[a] == axis[b] && a < b);
+    });
+
+    // Split where the left side's weight is closest to its share
+    const int kLeft = k / 2;
+    const double target = static_cast<double>(total) * kLeft / k;
+    int split = begin + 1;
+    std::int64_t acc = level.vertexWeight[ids[begin]];
+    while (split < end - 1
+           && std::abs(static_cast<double>(acc + level.vertexWeight[ids[split]]) - target)
+                  <= std::abs(static_cast<double>(acc) - target)) {
+        acc += level.vertexWeight[ids[split]];
+        ++split;
+    }
+    bisect(level, ids, begin, split, firstPart, kLeft, partOf);
+    bisect(level, ids, split, end, firstPart + kLeft, k - kLeft, partOf);
+}
+
+// Greedy boundary moves: positive gain under the weight limit, or zero
+// gain towards a lighter part, or out of an overweight part
+void refine(const Level &level, int k, std::int64_t maxPartWeight, int passes,
+            std::vector<int> &partOf) {
+    std::vector<std::int64_t> partWeight(k, 0);
+    for (int v = 0; v < level.n; ++v) partWeight[partOf[v]] += level.vertexWeight[v];
+    std::vector<std::int64_t> connection(k, 0);
+    std::vector<int> touched;
+    for (int pass = 0; pass < passes; ++pass) {
+        int moved = 0;
+        for (int v = 0; v < level.n; ++v) {
+            const int a = partOf[v];
+            touched.clear();
+            for (int s = level.offsets[v]; s < level.offsets[v + 1]; ++s) {
+                const int p = partOf[level.adj[s]];
+                if (connection[p] == 0) touched.push_back(p);
+                connection[p] += level.adjWeight[s];
+            }
+            int best = -1;
+            for (int p : touched)
+                if (p != a && (best < 0 || connection[p] > connection[best]
+                               || (connection[p] == connection[best] && partWeight[p] < partWeight[best])))
+                    best = p;
+            if (best >= 0) {
+                const std::int64_t w = level.vertexWeight[v];
+                const std::int64_t gain = connection[best] - connection[a];
+                const bool fits = partWeight[best] + w <= maxPartWeight && partWeight[a] > w;
+                const bool move = fits && (gain > 0
+                                           || (gain == 0 && partWeight[best] + w < partWeight[a])
+                                           || partWeight[a] > maxPartWeight);
+                if (move) {
+                    partOf[v] = best;
+                    partWeight[a] -= w;
+                    partWeight[best] += w;
+                    ++moved;
+                }
+            }
+            for (int p : touched) connection[p] = 0;
+        }
+        if (moved == 0) break;
+    }
+}
+}
+
+double GraphPartition::imbalance() const {
+    if (parts == 0) return 1.0;
+    const std::int64_t total = std::accumulate(partWeight.begin(), partWeight.end(), std::int64_t{0});
+    if (total == 0) return 1.0;
+    const std::int64_t heaviest = *std::max_element(partWeight.begin(), partWeight.end());
+    return static_cast<double>(heaviest) * parts / static_cast<double>(total);
+}
+
+GraphPartition GraphPartitioner::partition(const Graph &g, const PartitionOptions &options) {
+    const int n = static_cast<int>(g.getVertices().size());
+    GraphPartition result;
+    result.parts = std::max(1, std::min(options.parts, n));
+    result.partOf.assign(n, 0);
+    result.partWeight.assign(result.parts, 0);
+    const int k = result.parts;
+
+    // --- B1. Thô hoá: ghép cặp theo cạnh nặng nhất ---
+    std::vector<Level> levels;
+    levels.push_back(fromGraph(g, options.vertexWeights));
+    const std::int64_t total = std::accumulate(levels[0].vertexWeight.begin(), levels[0].vertexWeight.end(),
+                                               std::int64_t{0});
+    if (k > 1) {
+        std::mt19937 rng(options.seed);
+        // A coarse vertex never outweighs a quarter of a part, so the
+        // seed can still be balanced
+        const std::int64_t maxVertexWeight = std::max<std::int64_t>(2, total / (4 * k));
+        const int stopAt = std::max(200, 40 * k);
+        while (levels.back().n > stopAt) {
+            Level coarse = coarsen(levels.back(), rng, maxVertexWeight);
+            if (coarse.n > levels.back().n * 19 / 20) break;   // matching stalled
+            levels.push_back(std::move(coarse));
+        }
+
+        // --- B2. Khởi tạo: chia đôi đệ quy theo toạ độ ---
+        const std::int64_t maxPartWeight =
+            static_cast<std::int64_t>((1.0 + options.imbalance) * static_cast<double>(total) / k) + 1;
+        const Level &coarsest = levels.back();
+        std::vector<int> partOf(coarsest.n, 0);
+        std::vector<int> ids(coarsest.n);
+        std::iota(ids.begin(), ids.end(), 0);
+        bisect(coarsest, ids, 0, coarsest.n, 0, k, partOf);
+        refine(coarsest, k, maxPartWeight, options.refinementPasses, partOf);
+
+        // --- B3. Tinh chỉnh từng mức khi chiếu ngược về đồ thị gốc ---
+        for (int l = static_cast<int>(levels.size()) - 2; l >= 0; --l) {
+            std::vector<int> finer(levels[l].n);
+            for (int v = 0; v < levels[l].n; ++v) finer[v] = partOf[levels[l].coarseOf[v]];
+            partOf.swap(finer);
+            refine(levels[l], k, maxPartWeight, options.refinementPasses, partOf);
+        }
+        result.partOf.swap(partOf);
+    }
+    result.levels = static_cast<int>(levels.size());
+
+    for (int v = 0; v < n; ++v) result.partWeight[result.partOf[v]] += levels[0].vertexWeight[v];
+    for (const Edge &e : g.getEdges())
+        if (result.partOf[e.u] != result.partOf[e.v]) ++result.cutEdges;
+    return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+
+/* ============================================================
+   GraphPartitioner — balanced districts with few cut streets
+   ------------------------------------------------------------
+   Multilevel scheme, in three stages:
+     - coarsening: heavy-edge matching merges each vertex with
+       the unmatched neighbour it shares the most streets with,
+       level after level, until a few dozen vertices per part
+       remain (vertex weights and street counts add up, positions
+       become weighted centroids);
+     - seeding: the coarsest graph is cut by recursive coordinate
+       bisection, splitting along the longer axis at the weighted
+       point that gives each side its share of the parts, so the
+       districts start out as compact map regions;
+     - refinement: back up the levels, every vertex moves to the
+       neighbouring part it is most connected to when that cuts
+       fewer streets and keeps the part under its weight limit
+       (greedy boundary passes, in the spirit of FM).
+   Vertex weight defaults to the degree, so districts are
+   balanced by street count. Deterministic for a given seed.
+   ============================================================ */
+
+struct PartitionOptions {
+    int parts{2};
+    // Allowed overweight of a part over total / parts
+    double imbalance{0.05};
+    // Greedy passes per level
+    int refinementPasses{4};
+    unsigned seed{1};
+    // Per-vertex weights (size V); empty → max(1, degree)
+    std::vector<std::int64_t> vertexWeights;
+};
+
+struct GraphPartition {
+    int parts{0};
+    std::vector<int> partOf;                // per vertex
+    std::vector<std::int64_t> partWeight;   // per part
+    int cutEdges{0};                        // edges whose ends lie in different parts
+    int levels{0};                          // coarsening levels used
+
+    // Heaviest part relative to the average (1.0 = perfect balance)
+    double imbalance() const;
+};
+
+namespace GraphPartitioner {
+
+GraphPartition partition(const Graph &g, const PartitionOptions &options);
+
+}
@@ -0,0 +1,151 @@
+#include "LocationIO.h"
+#include "Algorithms.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Same rule as QString::toInt(): anything that is not a whole integer is 0
+int toInt(const std::string &token) {
+    char *end = nullptr;
+    long value = std::strtol(token.c_str(), &end, 10);
+    return (end && *end == '\0') ? static_cast<int>(value) : 0;
+}
+}
+
+std::vector<std::vector<int>> LocationIO::readMatrix(const fs::path &file) {
+    std::vector<std::vector<int>> mat;
+    std::ifstream in(file);
+    std::string line, token;
+    while (std::getline(in, line)) {
+        for (char &c : line)
+            if (c == ',') c = ' ';
+        std::istringstream parts(line);
+        std::vector<int> row;
+        while (parts >> token) row.push_back(toInt(token));
+        if (!row.empty()) mat.push_back(std::move(row));
+    }
+    return mat;
+}
+
+void LocationIO::addMatrixEdges(Graph &g, const std::vector<std::vector<int>> &mat) {
+    const int n = static_cast<int>(g.getVertices().size());
+    for (int i = 0; i < n && i < static_cast<int>(mat.size()); ++i)
+        for (int j = i + 1; j < n && j < static_cast<int>(mat[i].size()); ++j)
+            if (mat[i][j] != 0) g.addEdge(i, j);
+}
+
+LocationIO::LoadReport LocationIO::loadLocation(const fs::path &dir, Graph &g) {
+    LoadReport report;
+    std::error_code ec;
+    report.directoryFound = fs::is_directory(dir, ec);
+    if (!report.directoryFound) return report;
+
+    std::ifstream coords(dir / "coords.txt");
+    if (coords) {
+        report.coordsFound = true;
+        std::string line;
+        while (std::getline(coords, line)) {
+            std::istringstream parts(line);
+            std::vector<std::string> tokens;
+            std::string token;
+            while (parts >> token) tokens.push_back(token);
+            if (tokens.size() == 2)
+                g.addVertex(Point2D{std::atof(tokens[0].c_str()), std::atof(tokens[1].c_str())});
+        }
+    }
+
+    fs::path matrixPath = dir / "matrix.txt";
+    if (fs::is_regular_file(matrixPath, ec)) {
+        report.matrixFound = true;
+        addMatrixEdges(g, readMatrix(matrixPath));
+    }
+
+    std::ifstream required(dir / "required.txt");
+    if (required) {
+        report.requiredFound = true;
+        const int n = static_cast<int>(g.getVertices().size());
+        auto key = [n](int u, int v) {
+            return static_cast<long long>(std::min(u, v)) * n + std::max(u, v);
+        };
+        std::unordered_map<long long, int> edgeAt;
+        for (Edge &e : g.getEdges()) {
+            edgeAt[key(e.u, e.v)] = e.id;
+            e.required = false;
+        }
+        std::string line;
+        while (std::getline(required, line)) {
+            std::istringstream parts(line);
+            int u = 0, v = 0;
+            if (!(parts >> u >> v) || u < 1 || v < 1 || u > n || v > n) continue;
+            auto it = edgeAt.find(key(u - 1, v - 1));
+            if (it != edgeAt.end()) g.getEdges()[it->second].required = true;
+        }
+    }
+    return report;
+}
+
+bool LocationIO::writeRequired(const fs::path &dir, const Graph &g) {
+    const fs::path file = dir / "required.txt";
+    if (!g.hasOptionalEdges()) {
+        std::error_code ec;
+        fs::remove(file, ec);
+        return true;
+    }
+    std::ofstream out(file);
+    if (!out) return false;
+    for (const Edge &e : g.getEdges())
+        if (e.required) out << e.u + 1 << ' ' << e.v + 1 << "\n";
+    return static_cast<bool>(out);
+}
+
+namespace {
+void writeRouteBody(std::ostream &out, const Graph &g, const std::vector<int> &edgeOrder,
+                    const std::vector<int> &duplicateEdgeIds) {
+    const auto &edges = g.getEdges();
+    const auto &verts = g.getVertices();
+    double cost = 0;
+    for (int eid : edgeOrder) cost += edges[eid].weight;
+
+    out << "cost " << cost << "\n";
+    out << "edges " << edgeOrder.size() << ":";
+    for (int eid : edgeOrder) out << ' ' << eid + 1;
+    out << "\n";
+
+    out << "vertices:";
+    for (int v : Algorithms::getVertexSequence(g, edgeOrder)) out << ' ' << verts[v].name;
+    out << "\n";
+
+    out << "duplicates " << duplicateEdgeIds.size() << ":";
+    for (int eid : duplicateEdgeIds) out << ' ' << eid + 1;
+    out << "\n";
+}
+}
+
+bool LocationIO::writeRoute(const fs::path &file, const Graph &g,
+                            const std::vector<int> &edgeOrder,
+                            const std::vector<int> &duplicateEdgeIds) {
+    std::ofstream out(file);
+    if (!out) return false;
+    writeRouteBody(out, g, edgeOrder, duplicateEdgeIds);
+    return static_cast<bool>(out);
+}
+
+bool LocationIO::writeRoutes(const fs::path &file, const Graph &g,
+                             const std::vector<std::vector<int>> &edgeOrders,
+                             const std::vector<std::vector<int>> &duplicateEdgeIds) {
+    std::ofstream out(file);
+    if (!out) return false;
+    out << "routes " << edgeOrders.size() << "\n";
+    for (std::size_t r = 0; r < edgeOrders.size(); ++r) {
+        out << "route " << r + 1 << "\n";
+        writeRouteBody(out, g, edgeOrders[r],
+                       r < duplicateEdgeIds.size() ? duplicateEdgeIds[r] : std::vector<int>());
+    }
+    return static_cast<bool>(out);
+}
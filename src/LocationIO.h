@@ -0,0 +1,53 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "Graph.h"
+
+/* ============================================================
+   Location folders (coords.txt + matrix.txt [+ required.txt]
+   [+ background.*])
+   ------------------------------------------------------------
+   Qt-free reader/writer shared by the GUI and the batch tool.
+   The background image is never opened here: the solver does
+   not need it, and decoding it dominates load time.
+   required.txt lists the streets that must be inspected, one
+   "u v" pair of 1-based vertex numbers (coords.txt lines) per
+   line; without it every street is required.
+   ============================================================ */
+namespace LocationIO {
+
+struct LoadReport {
+    bool directoryFound{false};
+    bool coordsFound{false};
+    bool matrixFound{false};
+    bool requiredFound{false};
+};
+
+// Appends the location's vertices (coords.txt, "x y" per line) and
+// edges (matrix.txt, non-zero upper-triangle entries) to `g`, and
+// marks the streets missing from required.txt (if any) optional.
+LoadReport loadLocation(const std::filesystem::path &dir, Graph &g);
+
+// Writes required.txt for g's required streets when some street is
+// optional, otherwise removes a stale one; false if it cannot be written
+bool writeRequired(const std::filesystem::path &dir, const Graph &g);
+
+// Whitespace/comma separated integer matrix, one row per line.
+std::vector<std::vector<int>> readMatrix(const std::filesystem::path &file);
+
+// Adds an edge (weight 1) for every non-zero entry above the diagonal.
+void addMatrixEdges(Graph &g, const std::vector<std::vector<int>> &mat);
+
+// Writes a route file: cost, 1-based edge numbers and vertex names.
+bool writeRoute(const std::filesystem::path &file, const Graph &g,
+                const std::vector<int> &edgeOrder,
+                const std::vector<int> &duplicateEdgeIds);
+
+// Several routes in one file (one per component / patrol unit):
+// "routes N", then "route k" followed by the writeRoute() lines
+bool writeRoutes(const std::filesystem::path &file, const Graph &g,
+                 const std::vector<std::vector<int>> &edgeOrders,
+                 const std::vector<std::vector<int>> &duplicateEdgeIds);
+
+}
@@ -3,6 +3,8 @@
 #include "Algorithms.h"
 #include "GraphCanvas.h"
 #include "AnimationWindow.h"
+#include "QtGraphAdapters.h"
+#include "LocationIO.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QImageReader>
@@ -17,13 +19,22 @@
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QTimer>
+#include <QKeySequence>
+#include <exception>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
+    solvePool.setMaxThreadCount(1);
     setupUi();
 }
 
+MainWindow::~MainWindow() {
+    // The worker still references this window: stop it and wait
+    if (solveCancel) solveCancel->store(true);
+    solvePool.waitForDone();
+}
+
 /* ============================================================
    UI SETUP
    ============================================================ */
@@ -112,6 +123,12 @@ void MainWindow::setupToolbar() {
     menuGraph->addAction("Add Edge", this, &MainWindow::setAddEdge);
     menuGraph->addAction("Move Vertex", this, &MainWindow::setMoveVertex);
     menuGraph->addAction("Erase Edge/Vertex", this, &MainWindow::setEraser);
+    menuGraph->addAction("Mark Required Streets", this, &MainWindow::setToggleRequired);
+    menuGraph->addAction("Require All Streets", this, [this]() {
+        for (Edge &e : canvas->model().getEdges()) e.required = true;
+        canvas->update();
+        statusBar()->showMessage("Every street is required", 2000);
+    });
     menuGraph->addSeparator();
     menuGraph->addAction("Clear All", this, [this]() {
         canvas->model().clear();
@@ -129,8 +146,19 @@ void MainWindow::setupToolbar() {
     QMenu *menuAlgo = new QMenu(this);
     menuAlgo->addAction("Euler", this, &MainWindow::runEuler);
     menuAlgo->addAction("Postman", this, &MainWindow::runPostman);
+    menuAlgo->addAction("Postman by Districts", this, &MainWindow::runDistrictPostman);
+    menuAlgo->addAction("Patrol Routes (k units)...", this, &MainWindow::runPatrolRoutes);
+    animatePatrolAction = menuAlgo->addAction("Animate Patrol Routes", this, &MainWindow::animatePatrolRoutes);
+    animatePatrolAction->setEnabled(false);
+    splitShiftsAction = menuAlgo->addAction("Split Route into Shifts...", this, &MainWindow::splitIntoShifts);
+    splitShiftsAction->setEnabled(false);
+    menuAlgo->addSeparator();
+    cancelAction = menuAlgo->addAction("⏹ Cancel Solve", this, &MainWindow::cancelSolve);
+    cancelAction->setShortcut(QKeySequence(Qt::Key_Escape));
+    cancelAction->setEnabled(false);
     btnAlgo->setMenu(menuAlgo);
     tb->addWidget(btnAlgo);
+    tb->addAction(cancelAction);
 
     // === 🗺 Map Tools === (Giữ nguyên)
     QToolButton *btnMap = new QToolButton(this);
@@ -156,31 +184,345 @@ void MainWindow::setAddVertex()  { canvas->setMode(GraphCanvas::AddVertex);  sta
 void MainWindow::setAddEdge()    { canvas->setMode(GraphCanvas::AddEdge);    statusBar()->showMessage("Mode: Add Edge"); }
 void MainWindow::setMoveVertex() { canvas->setMode(GraphCanvas::MoveVertex); statusBar()->showMessage("Mode: Move Vertex"); }
 void MainWindow::setEraser()     { canvas->setMode(GraphCanvas::Eraser);     statusBar()->showMessage("Mode: Eraser"); }
+void MainWindow::setToggleRequired() {
+    canvas->setMode(GraphCanvas::ToggleRequired);
+    statusBar()->showMessage("Mode: Mark Required Streets (click both ends of a street to toggle it)");
+}
 
 /* ============================================================
    ALGORITHMS (Giữ nguyên)
    ============================================================ */
-void MainWindow::runEuler() {
-    auto res = Algorithms::findEulerTourHierholzer(canvas->model());
-    if (!res) {
+void MainWindow::runEuler()   { startSolve(SolveKind::Euler); }
+void MainWindow::runPostman() { startSolve(SolveKind::Postman); }
+void MainWindow::runDistrictPostman() { startSolve(SolveKind::Districts); }
+
+void MainWindow::runPatrolRoutes() {
+    const auto &verts = canvas->model().getVertices();
+    if (verts.empty()) {
+        QMessageBox::information(this, "Patrol Routes", "The graph is empty.");
+        return;
+    }
+    bool ok = false;
+    const int units = QInputDialog::getInt(this, "Patrol Routes", "Number of patrol units:", 3, 1, 100, 1, &ok);
+    if (!ok) return;
+    QStringList stations;
+    for (const auto &v : verts)
+        stations << (v.name.empty() ? QString("#%1").arg(v.id) : toQString(v.name));
+    const QString station = QInputDialog::getItem(this, "Patrol Routes", "Station (depot) vertex:", stations, 0, false, &ok);
+    if (!ok) return;
+    startSolve(SolveKind::Patrol, units, static_cast<int>(stations.indexOf(station)));
+}
+
+void MainWindow::splitIntoShifts() {
+    if (lastTours.empty()) return;
+    if (tourGraph.hasDirectedEdges()) {
+        QMessageBox::warning(this, "Split into Shifts", "Shifts do not support one-way streets.");
+        return;
+    }
+    const auto &verts = tourGraph.getVertices();
+    const auto &edges = tourGraph.getEdges();
+    double tourCost = 0.0;
+    for (const auto &tour : lastTours)
+        for (int eid : tour) tourCost += edges[eid].weight;
+    bool ok = false;
+    const double maxShift = QInputDialog::getDouble(this, "Split into Shifts", "Maximum shift cost:",
+                                                    std::ceil(tourCost / 3.0), 0.0, 1e12, 1, &ok);
+    if (!ok) return;
+    QStringList stations;
+    for (const auto &v : verts)
+        stations << (v.name.empty() ? QString("#%1").arg(v.id) : toQString(v.name));
+    const QString station = QInputDialog::getItem(this, "Split into Shifts", "Station (depot) vertex:", stations, 0, false, &ok);
+    if (!ok) return;
+
+    // One linear pass per tour; fast enough to run on the UI thread
+    ShiftOptions options;
+    options.maxShiftCost = maxShift;
+    options.depot = static_cast<int>(stations.indexOf(station));
+    SolverContext ctx;
+    std::vector<std::vector<int>> shifts;
+    double total = 0.0, deadhead = 0.0;
+    for (const auto &tour : lastTours) {
+        ShiftPlan plan = ShiftSplitter::split(ctx, tourGraph, tour, options);
+        if (!plan.feasible) {
+            QString why = "The station is not connected to the route.";
+            if (plan.blockingPosition >= 0) {
+                const Edge &e = edges[tour[plan.blockingPosition]];
+                why = QString("Street %1 (%2-%3) cannot be patrolled from the station within one shift.")
+                          .arg(e.id + 1).arg(stations[e.u], stations[e.v]);
+            }
+            QMessageBox::warning(this, "Split into Shifts", why);
+            return;
+        }
+        for (Shift &shift : plan.shifts) shifts.push_back(std::move(shift.edgeOrder));
+        total += plan.totalCost;
+        deadhead += plan.deadheadCost;
+    }
+    patrolGraph = tourGraph;
+    patrolRoutes = shifts;
+    canvas->setRoutes(patrolRoutes);
+    animatePatrolAction->setEnabled(true);
+    statusBar()->showMessage(QString("%1 shifts from %2: total cost %3, of which %4 to and from the station")
+                                 .arg(shifts.size()).arg(station).arg(total).arg(deadhead), 8000);
+}
+
+void MainWindow::animatePatrolRoutes() {
+    if (patrolRoutes.empty()) return;
+    auto *anim = new AnimationWindow(patrolGraph, patrolRoutes, this);
+    anim->show();
+}
+
+void MainWindow::cancelSolve() {
+    if (!solveCancel) return;
+    solveCancel->store(true);
+    ++solveGeneration;  // bỏ qua kết quả đang chạy
+    solveCancel.reset();
+    cancelAction->setEnabled(false);
+    statusBar()->showMessage("Solve cancelled", 3000);
+}
+
+namespace {
+QString phaseLabel(const char *phase) {
+    const QString p = QString::fromLatin1(phase);
+    if (p == "csr") return "building adjacency";
+    if (p == "shortest_paths") return "shortest paths between odd vertices";
+    if (p == "matching") return "matching odd vertices";
+    if (p == "augment") return "duplicating edges";
+    if (p == "euler") return "walking the Euler tour";
+    if (p == "components") return "solving disjoint sectors";
+    if (p == "chains") return "contracting degree-2 chains";
+    if (p == "partition") return "splitting into districts";
+    if (p == "districts") return "solving districts";
+    if (p == "boundary_matching") return "stitching districts";
+    if (p == "lower_bound") return "computing the lower bound";
+    if (p == "tour") return "solving the station tour";
+    if (p == "deadhead") return "paths from the station";
+    if (p == "split") return "splitting the tour between units";
+    if (p == "improve") return "improving each unit's route";
+    if (p == "flow") return "balancing one-way streets";
+    if (p == "parity") return "walking the remaining two-way streets";
+    if (p == "required") return "finding the required streets";
+    if (p == "connect") return "connecting the required streets";
+    return p;
+}
+
+// Same vertices and edges (by id and endpoints) as the snapshot
+bool sameGraph(const Graph &a, const Graph &b) {
+    if (a.getVertices().size() != b.getVertices().size()) return false;
+    const auto &ea = a.getEdges();
+    const auto &eb = b.getEdges();
+    if (ea.size() != eb.size()) return false;
+    for (size_t i = 0; i < ea.size(); ++i)
+        if (ea[i].u != eb[i].u || ea[i].v != eb[i].v || ea[i].weight != eb[i].weight
+            || ea[i].directed != eb[i].directed || ea[i].required != eb[i].required)
+            return false;
+    return true;
+}
+}
+
+void MainWindow::startSolve(SolveKind kind, int units, int depot) {
+    // A new request supersedes the running one
+    if (solveCancel) solveCancel->store(true);
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    solveCancel = cancel;
+    const int generation = ++solveGeneration;
+    auto snapshot = std::make_shared<const Graph>(canvas->model());
+
+    cancelAction->setEnabled(true);
+    statusBar()->showMessage(kind == SolveKind::Euler ? "Euler: solving..." : "Postman: solving...");
+
+    std::shared_ptr<const ContractionHierarchy> index = hierarchy;
+
+    solvePool.start([this, kind, units, depot, cancel, generation, snapshot, index]() {
+        if (cancel->load()) return;
+        try {
+            if (kind == SolveKind::Euler) {
+                auto res = std::make_shared<ComponentSolver::EulerRoutes>(
+                    ComponentSolver::euler(solverContext, *snapshot));
+                QMetaObject::invokeMethod(this, [this, generation, snapshot, res]() {
+                    finishEuler(generation, *snapshot, *res);
+                }, Qt::QueuedConnection);
+                return;
+            }
+
+            auto progress = [this, generation](const char *phase, int done, int total) {
+                QString text = "Postman: " + phaseLabel(phase);
+                if (total > 1) text += QString(" (%1/%2)").arg(done).arg(total);
+                QMetaObject::invokeMethod(this, [this, generation, text]() {
+                    if (generation == solveGeneration) statusBar()->showMessage(text);
+                }, Qt::QueuedConnection);
+            };
+            if (kind == SolveKind::Patrol) {
+                MultiRouteOptions options;
+                options.routes = units;
+                options.depot = depot;
+                options.cancel = cancel.get();
+                options.contractChains = true;
+                options.progress = progress;
+                auto res = std::make_shared<MultiRouteResult>(
+                    MultiRoutePostman::solve(solverContext, *snapshot, options));
+                QMetaObject::invokeMethod(this, [this, generation, snapshot, res]() {
+                    finishPatrol(generation, *snapshot, *res);
+                }, Qt::QueuedConnection);
+                return;
+            }
+            if (kind == SolveKind::Districts) {
+                DistrictOptions options;
+                options.cancel = cancel.get();
+                options.contractChains = true;
+                options.progress = progress;
+                auto res = std::make_shared<DistrictResult>(
+                    DistrictPostman::solve(solverContext, *snapshot, options));
+                QMetaObject::invokeMethod(this, [this, generation, snapshot, res]() {
+                    finishDistricts(generation, *snapshot, *res);
+                }, Qt::QueuedConnection);
+                return;
+            }
+
+            ChinesePostmanOptions options;
+            options.cancel = cancel.get();
+            options.hierarchy = index.get();
+            options.contractChains = true;
+            options.progress = progress;
+            auto res = std::make_shared<ComponentSolver::PostmanRoutes>(
+                ComponentSolver::postman(solverContext, *snapshot, options));
+            QMetaObject::invokeMethod(this, [this, generation, snapshot, res]() {
+                finishPostman(generation, *snapshot, *res);
+            }, Qt::QueuedConnection);
+        } catch (const std::exception &e) {
+            QString what = QString::fromLocal8Bit(e.what());
+            QMetaObject::invokeMethod(this, [this, generation, what]() {
+                if (generation != solveGeneration) return;
+                solveCancel.reset();
+                cancelAction->setEnabled(false);
+                QMessageBox::warning(this, "Solve", "Solver failed: " + what);
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+bool MainWindow::isCurrentSolve(int generation, const Graph &snapshot) {
+    if (generation != solveGeneration) return false;  // bị thay thế / đã huỷ
+    solveCancel.reset();
+    cancelAction->setEnabled(false);
+    if (!sameGraph(snapshot, canvas->model())) {
+        statusBar()->showMessage("Graph changed while solving; route discarded", 3000);
+        return false;
+    }
+    return true;
+}
+
+void MainWindow::finishEuler(int generation, const Graph &snapshot, const ComponentSolver::EulerRoutes &res) {
+    if (!isCurrentSolve(generation, snapshot)) return;
+    const int sectors = static_cast<int>(res.routes.size());
+    // Disjoint sectors are walked one after the other
+    std::vector<int> edgeOrder;
+    bool allCycles = true;
+    for (int c = 0; c < sectors; ++c) {
+        if (!res.routes[c]) {
+            QMessageBox::information(this, "Euler", sectors > 1
+                ? QString("No Euler path/cycle exists in sector %1 of %2.").arg(c + 1).arg(sectors)
+                : QString("No Euler path/cycle exists."));
+            return;
+        }
+        edgeOrder.insert(edgeOrder.end(), res.routes[c]->edgeOrder.begin(), res.routes[c]->edgeOrder.end());
+        allCycles = allCycles && res.routes[c]->isCycle;
+    }
+    if (edgeOrder.empty()) {
         QMessageBox::information(this, "Euler", "No Euler path/cycle exists.");
         return;
     }
-    canvas->setRoute(res->edgeOrder);
-    statusBar()->showMessage(res->isCycle ? "Euler cycle found" : "Euler path found", 3000);
+    canvas->setRoute(edgeOrder);
+    QString text = allCycles ? "Euler cycle found" : "Euler path found";
+    if (sectors > 1) text += QString(" in each of %1 disjoint sectors").arg(sectors);
+    statusBar()->showMessage(text, 3000);
 }
 
-void MainWindow::runPostman() {
-    auto res = ChinesePostmanOptimal::solve(canvas->model());
-    if (res.edgeOrder.empty()) {
+void MainWindow::finishPostman(int generation, const Graph &snapshot, const ComponentSolver::PostmanRoutes &res) {
+    if (!isCurrentSolve(generation, snapshot)) return;
+    if (res.cancelled) {
+        statusBar()->showMessage("Solve cancelled", 3000);
+        return;
+    }
+    if (res.routes.empty() && snapshot.hasOptionalEdges()) {
+        QMessageBox::information(this, "Postman", "No street is marked required.");
+        return;
+    }
+    // One route per disjoint sector, shown back to back
+    std::vector<int> edgeOrder, duplicateIds;
+    for (const auto &route : res.routes) {
+        if (route.edgeOrder.empty()) {
+            QMessageBox::warning(this, "Postman", snapshot.hasDirectedEdges() && snapshot.hasOptionalEdges()
+                ? QString("One-way streets cannot be combined with optional streets; "
+                          "use Require All Streets or make the streets two-way.")
+                : QString("Failed to compute route."));
+            return;
+        }
+        edgeOrder.insert(edgeOrder.end(), route.edgeOrder.begin(), route.edgeOrder.end());
+        duplicateIds.insert(duplicateIds.end(), route.duplicateEdgeIds.begin(), route.duplicateEdgeIds.end());
+    }
+    if (edgeOrder.empty()) {
         QMessageBox::warning(this, "Postman", "Failed to compute route.");
         return;
     }
-    int originalEdgeCount = static_cast<int>(canvas->model().getEdges().size());
-    canvas->setRouteWithDuplicates(res.edgeOrder,
-                                   res.duplicateEdgeIds,
-                                   originalEdgeCount);
-    statusBar()->showMessage("Postman route (optimal) computed", 3000);
+    int originalEdgeCount = static_cast<int>(snapshot.getEdges().size());
+    canvas->setRouteWithDuplicates(edgeOrder, duplicateIds, originalEdgeCount);
+    tourGraph = snapshot;
+    lastTours.clear();
+    for (const auto &route : res.routes) lastTours.push_back(route.edgeOrder);
+    splitShiftsAction->setEnabled(true);
+    // Only required streets: a good route, not a proven optimum
+    const QString kind = snapshot.hasOptionalEdges()
+        ? QString("required streets, %1 connectors").arg(res.stats.connectorEdges)
+        : QString("optimal");
+    QString text = res.routes.size() > 1
+        ? QString("Postman routes (%1) for %2 disjoint sectors computed: ").arg(kind).arg(res.routes.size())
+        : QString("Postman route (%1) computed: ").arg(kind);
+    statusBar()->showMessage(text + QString::fromStdString(res.stats.summary()), 8000);
+}
+
+void MainWindow::finishDistricts(int generation, const Graph &snapshot, const DistrictResult &res) {
+    if (!isCurrentSolve(generation, snapshot)) return;
+    if (res.route.cancelled) {
+        statusBar()->showMessage("Solve cancelled", 3000);
+        return;
+    }
+    if (res.route.edgeOrder.empty()) {
+        QMessageBox::warning(this, "Postman", snapshot.hasDirectedEdges()
+            ? QString("District mode does not support one-way streets.")
+            : QString("Failed to compute route (district mode needs a connected graph, or connected required streets)."));
+        return;
+    }
+    int originalEdgeCount = static_cast<int>(snapshot.getEdges().size());
+    canvas->setRouteWithDuplicates(res.route.edgeOrder, res.route.duplicateEdgeIds, originalEdgeCount);
+    tourGraph = snapshot;
+    lastTours.assign(1, res.route.edgeOrder);
+    splitShiftsAction->setEnabled(true);
+    statusBar()->showMessage(QString("Postman route by %1 districts: cost %2, within %3% of the lower bound | ")
+                                 .arg(res.partition.parts).arg(res.cost).arg(100.0 * res.gap, 0, 'f', 2)
+                             + QString::fromStdString(res.route.stats.summary()), 8000);
+}
+
+void MainWindow::finishPatrol(int generation, const Graph &snapshot, const MultiRouteResult &res) {
+    if (!isCurrentSolve(generation, snapshot)) return;
+    if (res.cancelled) {
+        statusBar()->showMessage("Solve cancelled", 3000);
+        return;
+    }
+    if (res.maxCost <= 0.0) {
+        QMessageBox::warning(this, "Patrol Routes", snapshot.hasDirectedEdges()
+            ? QString("Patrol routes do not support one-way streets.")
+            : QString("Failed to compute routes (needs a connected graph, or connected required streets, and a station on a street joined to them)."));
+        return;
+    }
+    patrolGraph = snapshot;
+    patrolRoutes.clear();
+    for (const PatrolRoute &route : res.routes) patrolRoutes.push_back(route.edgeOrder);
+    canvas->setRoutes(patrolRoutes);
+    animatePatrolAction->setEnabled(true);
+    statusBar()->showMessage(QString("%1 patrol routes: longest %2, total %3, within %4% of the lower bound | ")
+                                 .arg(res.routes.size()).arg(res.maxCost).arg(res.totalCost)
+                                 .arg(100.0 * res.gap, 0, 'f', 2)
+                             + QString::fromStdString(res.stats.summary()), 8000);
 }
 
 /* ============================================================
@@ -304,7 +646,7 @@ void MainWindow::onAttachFiles() {
     for (int i = 0; i < n; ++i) {
         double ang = (2 * M_PI * i) / n - M_PI / 2;
         QPointF pos(center.x() + radius * cos(ang), center.y() + radius * sin(ang));
-        g.addVertex(pos);
+        g.addVertex(toPoint2D(pos));
     }
     for (int i = 0; i < n; ++i)
         for (int j = i + 1; j < n; ++j)
@@ -332,23 +674,28 @@ void MainWindow::onShowSummary() {
     text += QString("📊 Graph Summary\n\nThis graph has %1 vertices and %2 edges:\n")
                 .arg(verts.size()).arg(edges.size());
     for (const auto &e : edges)
-        text += QString("• %1-%2 (Edge %3)\n")
-                    .arg(verts[e.u].name)
-                    .arg(verts[e.v].name)
-                    .arg(e.id + 1);
+        text += QString("• %1-%2 (Edge %3)%4\n")
+                    .arg(toQString(verts[e.u].name))
+                    .arg(toQString(verts[e.v].name))
+                    .arg(e.id + 1)
+                    .arg(e.required ? QString() : QString(" — optional"));
 
     std::vector<int> route;
     bool isPostman = false;
     std::vector<int> duplicateIds;
 
-    auto eulerRes = Algorithms::findEulerTourHierholzer(g);
+    SolverContext ctx;
+    auto eulerRes = Algorithms::findEulerTourHierholzer(ctx, g);
     if (eulerRes && !eulerRes->edgeOrder.empty() && g.getEdges().size() == route.size()) {
         route = eulerRes->edgeOrder;
         text += "\n🧭 Euler Route:\n";
     } else {
-        auto post = ChinesePostmanOptimal::solve(g);
-        route = post.edgeOrder;
-        duplicateIds = post.duplicateEdgeIds;
+        // Disjoint sectors: their routes back to back
+        auto post = ComponentSolver::postman(ctx, g);
+        for (const auto &sector : post.routes) {
+            route.insert(route.end(), sector.edgeOrder.begin(), sector.edgeOrder.end());
+            duplicateIds.insert(duplicateIds.end(), sector.duplicateEdgeIds.begin(), sector.duplicateEdgeIds.end());
+        }
         isPostman = true;
         text += "\n📦 Chinese Postman Route:\n";
     }
@@ -358,23 +705,17 @@ void MainWindow::onShowSummary() {
         return;
     }
 
-    std::unordered_map<int, int> dupIdToOriginalId;
-    int originalEdgeCount = static_cast<int>(edges.size());
-
-    for (size_t i = 0; i < duplicateIds.size(); ++i) {
-        int newId = originalEdgeCount + static_cast<int>(i);
-        int originalId = duplicateIds[i];
-        dupIdToOriginalId[newId] = originalId;
-    }
-
+    // Route ids are original edge ids; a repeat traversal is a duplicate
+    std::vector<bool> traversed(edges.size(), false);
     for (int eid : route) {
         int displayId = eid + 1;
-        if (isPostman && dupIdToOriginalId.count(eid)) {
-            int originalId = dupIdToOriginalId[eid];
-            text += QString("%1 (dup of %2) ").arg(displayId).arg(originalId + 1);
+        bool repeat = eid >= 0 && static_cast<size_t>(eid) < edges.size() && traversed[eid];
+        if (isPostman && repeat) {
+            text += QString("%1 (dup) ").arg(displayId);
         } else {
             text += QString::number(displayId) + " ";
         }
+        if (eid >= 0 && static_cast<size_t>(eid) < edges.size()) traversed[eid] = true;
     }
     text += "\n\nVertex Degrees:\n";
     QVector<int> deg(verts.size(), 0);
@@ -383,7 +724,7 @@ void MainWindow::onShowSummary() {
         if (e.v >= 0 && e.v < (int)verts.size()) deg[e.v]++;
     }
     for (int i = 0; i < deg.size(); ++i)
-        text += QString("• %1 = %2\n").arg(verts[i].name).arg(deg[i]);
+        text += QString("• %1 = %2\n").arg(toQString(verts[i].name)).arg(deg[i]);
 
     std::vector<int> odd;
     for (int i = 0; i < deg.size(); ++i)
@@ -394,7 +735,7 @@ void MainWindow::onShowSummary() {
         text += "✅ All vertices have even degree → Eulerian circuit exists.\n";
     else if (odd.size() == 2)
         text += QString("⚠️ Two vertices (%1, %2) are odd → Eulerian path exists.\n")
-                    .arg(verts[odd[0]].name, verts[odd[1]].name);
+                    .arg(toQString(verts[odd[0]].name), toQString(verts[odd[1]].name));
     else
         text += QString("❌ %1 vertices are odd → No Euler path.\n").arg(odd.size());
 
@@ -403,8 +744,8 @@ void MainWindow::onShowSummary() {
         for (int eid : duplicateIds) {
             if (eid >= 0 && static_cast<size_t>(eid) < edges.size()) {
                  text += QString("• %1-%2 (Edge %3)\n")
-                        .arg(verts[edges[eid].u].name)
-                        .arg(verts[edges[eid].v].name)
+                        .arg(toQString(verts[edges[eid].u].name))
+                        .arg(toQString(verts[edges[eid].v].name))
                         .arg(eid + 1);
             }
         }
@@ -487,47 +828,17 @@ void MainWindow::loadLocationFromPath(const QString &dirPath) {
     }
 
     Graph &g = canvas->model();
-    QString coordsPath = dir.filePath("coords.txt");
-    QFile coordsFile(coordsPath);
-    if (coordsFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&coordsFile);
-        while (!in.atEnd()) {
-            QString line = in.readLine().trimmed();
-            QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-            if (parts.size() == 2) {
-                g.addVertex(QPointF(parts[0].toDouble(), parts[1].toDouble()));
-            }
-        }
-        coordsFile.close();
-    } else {
+    const std::filesystem::path locationDir(dirPath.toStdU16String());
+    auto report = LocationIO::loadLocation(locationDir, g);
+    hierarchy.reset();
+    auto loadedHierarchy = std::make_shared<ContractionHierarchy>();
+    if (ContractionHierarchy::load(locationDir / ContractionHierarchy::kFileName, *loadedHierarchy)
+        && loadedHierarchy->matches(g))
+        hierarchy = loadedHierarchy;
+    if (!report.coordsFound) {
          statusBar()->showMessage("Warning: coords.txt not found.", 3000);
     }
-
-    QString matrixPath = dir.filePath("matrix.txt");
-    QFile matrixFile(matrixPath);
-    if (matrixFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&matrixFile);
-        QVector<QVector<int>> mat;
-        while (!in.atEnd()) {
-            QString line = in.readLine().trimmed();
-            QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-            QVector<int> row;
-            for (const QString &p : parts) row.push_back(p.toInt());
-            if (!row.isEmpty()) mat.push_back(row);
-        }
-        matrixFile.close();
-
-        if (!mat.isEmpty()) {
-            int n = g.getVertices().size();
-            for (int i = 0; i < n; ++i) {
-                for (int j = i + 1; j < n; ++j) {
-                    if (i < mat.size() && j < mat[i].size() && mat[i][j] != 0) {
-                        g.addEdge(i, j);
-                    }
-                }
-            }
-        }
-    } else {
+    if (!report.matrixFound) {
         statusBar()->showMessage("Warning: matrix.txt not found.", 3000);
     }
 
@@ -565,7 +876,7 @@ void MainWindow::saveLocation() {
     if (coordsFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
         QTextStream out(&coordsFile);
         for (const auto &vertex : g.getVertices()) {
-            out << vertex.position.x() << " " << vertex.position.y() << "\n";
+            out << vertex.position.x << " " << vertex.position.y << "\n";
         }
         coordsFile.close();
     } else {
@@ -593,5 +904,20 @@ void MainWindow::saveLocation() {
         QMessageBox::warning(this, "Warning", "Could not save matrix file.");
     }
 
+    const std::filesystem::path locationDir(targetPath.toStdU16String());
+    if (!LocationIO::writeRequired(locationDir, g))
+        QMessageBox::warning(this, "Warning", "Could not save required streets file.");
+
+    // Hierarchy of the graph exactly as loadLocation() will read it back
+    // (edge ids follow matrix order, not drawing order)
+    Graph reloaded;
+    LocationIO::loadLocation(locationDir, reloaded);
+    if (!reloaded.getEdges().empty()) {
+        auto built = std::make_shared<ContractionHierarchy>(ContractionHierarchy::build(reloaded));
+        if (!built->save(locationDir / ContractionHierarchy::kFileName))
+            QMessageBox::warning(this, "Warning", "Could not save hierarchy file.");
+        hierarchy = built;
+    }
+
     statusBar()->showMessage("Location '" + locName + "' saved successfully!", 3000);
 }
\ No newline at end of file
@@ -8,18 +8,26 @@
 #include "GraphCanvas.h"
 #include "Algorithms.h"
 #include "ChinesePostman.h"
+#include "Components.h"
+#include "DistrictPostman.h"
+#include "MultiRoutePostman.h"
+#include "ShiftSplitter.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QImageReader>
 #include <QTextStream>
 #include <QDir>         // <-- THÊM MỚI
 #include <QInputDialog> // <-- THÊM MỚI
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
 
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 public:
     explicit MainWindow(QWidget *parent = nullptr);
+    ~MainWindow() override;
 
 private slots:
     // === Graph Tools ===
@@ -27,10 +35,16 @@ private slots:
     void setAddEdge();
     void setMoveVertex();
     void setEraser();
+    void setToggleRequired();
 
     // === Algorithms ===
     void runEuler();
     void runPostman();
+    void runDistrictPostman();
+    void runPatrolRoutes();
+    void animatePatrolRoutes();
+    void splitIntoShifts();
+    void cancelSolve();
 
     // === File & Map Tools ===
     void exportImage();
@@ -53,6 +67,36 @@ private:
     void setupUi();
     void setupToolbar();
 
+    // === SOLVE NỀN (worker thread) ===
+    // Solves run on a one-thread pool against a snapshot of the graph;
+    // results come back through queued calls and are dropped if a newer
+    // solve started or the graph changed in the meantime.
+    QThreadPool solvePool;
+    SolverContext solverContext;  // chỉ dùng trên thread của solvePool
+    QAction *cancelAction{nullptr};
+    std::shared_ptr<std::atomic<bool>> solveCancel;
+    int solveGeneration{0};
+    // hierarchy.ch of the loaded location; solves use it only while it
+    // still matches the edited graph
+    std::shared_ptr<const ContractionHierarchy> hierarchy;
+
+    // Last k-route result and the graph it was solved on, for the animation
+    Graph patrolGraph;
+    std::vector<std::vector<int>> patrolRoutes;
+    QAction *animatePatrolAction{nullptr};
+    // Last postman tours (one per sector) and their graph, for the shift split
+    Graph tourGraph;
+    std::vector<std::vector<int>> lastTours;
+    QAction *splitShiftsAction{nullptr};
+
+    enum class SolveKind { Euler, Postman, Districts, Patrol };
+    void startSolve(SolveKind kind, int units = 0, int depot = 0);
+    void finishEuler(int generation, const Graph &snapshot, const ComponentSolver::EulerRoutes &res);
+    void finishPostman(int generation, const Graph &snapshot, const ComponentSolver::PostmanRoutes &res);
+    void finishDistricts(int generation, const Graph &snapshot, const DistrictResult &res);
+    void finishPatrol(int generation, const Graph &snapshot, const MultiRouteResult &res);
+    bool isCurrentSolve(int generation, const Graph &snapshot);
+
     // === HÀM HỖ TRỢ MỚI ===
     void loadLocationFromPath(const QString &dirPath);
 };
\ No newline at end of file
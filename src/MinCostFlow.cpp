@@ -0,0 +1,221 @@
+#include "MinCostFlow.h"
+#include <algorithm>
+
+void MinCostFlow::reset(int vertexCount) {
+    n = vertexCount;
+    tail.clear();
+    head.clear();
+    capacity.clear();
+    arcCost.clear();
+    excess.assign(n, 0);
+    totalCost = 0.0;
+    phaseCount = 0;
+    augmentCount = pushes = pops = scanned = 0;
+}
+
+int MinCostFlow::addArc(int from, int to, int cap, double cost) {
+    const int id = static_cast<int>(tail.size()) / 2;
+    tail.push_back(from);
+    head.push_back(to);
+    capacity.push_back(cap);
+    arcCost.push_back(cost);
+    tail.push_back(to);
+    head.push_back(from);
+    capacity.push_back(0);
+    arcCost.push_back(-cost);
+    return id;
+}
+
+void MinCostFlow::addSupply(int v, int amount) {
+    excess[v] += amount;
+}
+
+std::size_t MinCostFlow::bytes() const {
+    return (tail.capacity() + head.capacity() + capacity.capacity() + offsets.capacity() + slotOf.capacity()
+            + reverse.capacity() + spareInts.capacity()
+            + parentArc.capacity() + cursor.capacity() + pathArcs.capacity() + stack.capacity()
+            + sinks.capacity() + stamp.capacity()) * sizeof(int)
+         + (arcCost.capacity() + spareCosts.capacity() + potential.capacity() + dist.capacity()) * sizeof(double)
+         + excess.capacity() * sizeof(std::int64_t) + dead.capacity() + onStack.capacity() + queue.bytes();
+}
+
+void MinCostFlow::push(int a, std::int64_t amount) {
+    capacity[a] -= static_cast<int>(amount);
+    capacity[reverse[a]] += static_cast<int>(amount);
+    totalCost += static_cast<double>(amount) * arcCost[a];
+}
+
+/* ============================================================
+   Hàm solve() — mỗi pha: một Dijkstra, phục vụ các đỉnh cầu
+   ============================================================ */
+bool MinCostFlow::solve(const std::atomic<bool> *cancel) {
+    // --- B1. Sắp các cung dư theo đỉnh đầu (CSR) ---
+    const int arcs = static_cast<int>(tail.size());
+    offsets.assign(n + 1, 0);
+    for (int a = 0; a < arcs; ++a) ++offsets[tail[a] + 1];
+    for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+    slotOf.resize(arcs);
+    cursor.assign(offsets.begin(), offsets.end() - 1);
+    for (int a = 0; a < arcs; ++a) slotOf[a] = cursor[tail[a]]++;
+    auto permute = [this, arcs](auto &values, auto &spare) {
+        spare.resize(arcs);
+        for (int a = 0; a < arcs; ++a) spare[slotOf[a]] = values[a];
+        values.swap(spare);
+    };
+    permute(tail, spareInts);
+    permute(head, spareInts);
+    permute(capacity, spareInts);
+    permute(arcCost, spareCosts);
+    reverse.resize(arcs);
+    for (int a = 0; a < arcs; ++a) reverse[slotOf[a]] = slotOf[a ^ 1];
+
+    double maxCost = 0.0;
+    for (int a = 0; a < arcs; ++a) maxCost = std::max(maxCost, arcCost[a]);
+    // Reduced costs are sums of doubles; "zero" is anything this small
+    tolerance = 1e-9 * (1.0 + maxCost);
+    potential.assign(n, 0.0);
+    dist.resize(n);
+    parentArc.resize(n);
+    stamp.assign(n, 0);
+    stampCount = 0;
+    dead.assign(n, 0);
+    onStack.assign(n, 0);
+
+    // --- B2. Mỗi pha: Dijkstra, nâng thế vị, đẩy luồng ---
+    while (true) {
+        if (std::none_of(excess.begin(), excess.end(), [](std::int64_t e) { return e > 0; })) return true;
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+        if (!dijkstra()) return false;
+        ++phaseCount;
+        serveSinks();
+    }
+}
+
+// Multi-source Dijkstra from every vertex with excess; collects the
+// demands in the order they settle and lifts the potentials. False if
+// no demand is reachable.
+bool MinCostFlow::dijkstra() {
+    std::fill(dist.begin(), dist.end(), std::numeric_limits<double>::infinity());
+    std::fill(parentArc.begin(), parentArc.end(), -1);
+    queue.clear();
+    sinks.clear();
+    for (int v = 0; v < n; ++v)
+        if (excess[v] > 0) {
+            dist[v] = 0.0;
+            queue.push(0.0, v);
+            ++pushes;
+        }
+    double farthest = 0.0;
+    while (!queue.empty()) {
+        auto [d, u] = queue.pop();
+        ++pops;
+        if (d != dist[u]) continue;
+        farthest = d;
+        if (excess[u] < 0) sinks.push_back(u);
+        for (int a = offsets[u]; a < offsets[u + 1]; ++a) {
+            ++scanned;
+            if (capacity[a] <= 0) continue;
+            const int v = head[a];
+            // Rounding can leave a reduced cost a hair below zero
+            const double nd = d + std::max(0.0, reducedCost(a));
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parentArc[v] = a;
+                queue.push(nd, v);
+                ++pushes;
+            }
+        }
+    }
+    if (sinks.empty()) return false;
+    for (int v = 0; v < n; ++v) potential[v] += std::min(dist[v], farthest);
+    return true;
+}
+
+// Demands nearest first. With the super-sink at potential d(t), the
+// arcs into it from the demands still unserved must keep a reduced
+// cost ≥ 0, so serving t is only optimal while no nearer demand waits.
+void MinCostFlow::serveSinks() {
+    ++stampCount;
+    double unservedAt = std::numeric_limits<double>::infinity();
+    for (int t : sinks) {
+        if (dist[t] > unservedAt + tolerance) break;
+        augmentTreePath(t);
+        if (excess[t] < 0) drainSink(t);
+        if (excess[t] < 0) unservedAt = std::min(unservedAt, dist[t]);
+    }
+}
+
+// Flow along the Dijkstra tree path into sink while it is still open:
+// at least one unit per phase for the nearest demand
+void MinCostFlow::augmentTreePath(int sink) {
+    std::int64_t amount = -excess[sink];
+    int source = sink;
+    for (; parentArc[source] >= 0; source = tail[parentArc[source]])
+        amount = std::min<std::int64_t>(amount, capacity[parentArc[source]]);
+    amount = std::min(amount, excess[source]);
+    if (amount <= 0) return;
+    for (int v = sink; parentArc[v] >= 0; v = tail[parentArc[v]]) push(parentArc[v], amount);
+    excess[source] -= amount;
+    excess[sink] += amount;
+    ++augmentCount;
+}
+
+// Further paths into sink over arcs of zero reduced cost, found by a
+// DFS along the residual arcs entering each vertex (the partners of the
+// arcs leaving it). A vertex that reaches no excess is dead for the
+// rest of the phase and cursors are kept across its sinks; vertices on
+// the current path are skipped so zero-cost cycles cannot trap the
+// DFS. A path missed that way only leaves its sink to the next phase.
+// Per-vertex state is reset lazily by stamp.
+void MinCostFlow::drainSink(int sink) {
+    const int current = stampCount;
+    auto touch = [&](int v) {
+        if (stamp[v] == current) return;
+        stamp[v] = current;
+        cursor[v] = offsets[v];
+        dead[v] = 0;
+    };
+    touch(sink);
+    while (excess[sink] < 0 && !dead[sink]) {
+        stack.assign(1, sink);
+        pathArcs.clear();
+        onStack[sink] = 1;
+        int source = -1;
+        while (!stack.empty()) {
+            const int v = stack.back();
+            if (v != sink && excess[v] > 0) {
+                source = v;
+                break;
+            }
+            int &c = cursor[v];
+            for (; c < offsets[v + 1]; ++c) {
+                const int a = reverse[c];
+                ++scanned;
+                if (capacity[a] <= 0 || reducedCost(a) > tolerance) continue;
+                const int u = tail[a];
+                touch(u);
+                if (!dead[u] && !onStack[u]) break;
+            }
+            if (c == offsets[v + 1]) {
+                dead[v] = 1;
+                onStack[v] = 0;
+                stack.pop_back();
+                if (!pathArcs.empty()) pathArcs.pop_back();
+            } else {
+                const int a = reverse[c];
+                onStack[tail[a]] = 1;
+                stack.push_back(tail[a]);
+                pathArcs.push_back(a);
+            }
+        }
+        for (int v : stack) onStack[v] = 0;
+        if (source < 0) break;
+
+        std::int64_t amount = std::min(excess[source], -excess[sink]);
+        for (int a : pathArcs) amount = std::min<std::int64_t>(amount, capacity[a]);
+        for (int a : pathArcs) push(a, amount);
+        excess[source] -= amount;
+        excess[sink] += amount;
+        ++augmentCount;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "ShortestPaths.h"
+
+/* ============================================================
+   MinCostFlow — successive shortest paths with potentials
+   ------------------------------------------------------------
+   Transportation form: integer supplies (> 0) and demands (< 0)
+   summing to zero, arcs with an integer capacity and a non-
+   negative cost. Every phase:
+     - one Dijkstra on the reduced costs c(u, v) + π(u) − π(v) ≥ 0
+       from every vertex with excess over the whole residual graph;
+     - π(v) += d(v) (capped at the farthest distance reached), which
+       keeps every residual reduced cost ≥ 0 and gives every
+       shortest path reduced cost 0;
+     - the demand vertices are served nearest first: along the
+       Dijkstra tree path, then along further zero-reduced-cost
+       paths found by a DFS backwards from the demand (current-arc
+       pointers). The phase ends at the first demand farther than
+       one left unserved: a path to it would no longer be a
+       shortest augmenting path.
+   One Dijkstra thus serves demands at many distances, where
+   stopping at the nearest would repeat it per distinct length.
+   solve() stores the residual arcs sorted by tail (CSR), so a
+   scan of a vertex's arcs reads consecutive memory; buffers are
+   kept across reset().
+   ============================================================ */
+class MinCostFlow {
+public:
+    // Capacity of an arc that never limits the flow
+    static constexpr int kUnbounded = std::numeric_limits<int>::max() / 2;
+
+    void reset(int vertexCount);
+    // Returns the arc id (for flow(), valid after solve())
+    int addArc(int from, int to, int capacity, double cost);
+    // Negative = demand
+    void addSupply(int v, int amount);
+
+    // False if some supply cannot reach a demand, or on cancellation
+    // (polled once per phase)
+    bool solve(const std::atomic<bool> *cancel = nullptr);
+
+    int flow(int arc) const { return capacity[slotOf[2 * arc + 1]]; }
+    double cost() const { return totalCost; }
+    int phases() const { return phaseCount; }
+    std::int64_t augmentations() const { return augmentCount; }
+    std::int64_t heapPushes() const { return pushes; }
+    std::int64_t heapPops() const { return pops; }
+    std::int64_t arcsScanned() const { return scanned; }
+    std::size_t bytes() const;
+
+private:
+    int n{0};
+    // Residual arcs: 2i forward, 2i + 1 reverse as added; from solve()
+    // on in CSR order, arc 2i at slotOf[2i], its partner at reverse[]
+    std::vector<int> tail, head, capacity;
+    std::vector<double> arcCost;
+    std::vector<std::int64_t> excess;
+    std::vector<int> offsets, slotOf, reverse;
+    // CSR reordering targets, swapped with the arc arrays above
+    std::vector<int> spareInts;
+    std::vector<double> spareCosts;
+    // Phase scratch
+    std::vector<double> potential, dist;
+    std::vector<int> parentArc, cursor, pathArcs, stack;
+    std::vector<int> sinks;         // demands reached, nearest first
+    std::vector<int> stamp;         // per vertex: DFS that last reset it
+    std::vector<char> dead, onStack;
+    ShortestPaths::BinaryHeap<double> queue;
+
+    double totalCost{0.0};
+    double tolerance{0.0};
+    int phaseCount{0};
+    int stampCount{0};
+    std::int64_t augmentCount{0}, pushes{0}, pops{0}, scanned{0};
+
+    double reducedCost(int a) const { return arcCost[a] + potential[tail[a]] - potential[head[a]]; }
+    void push(int a, std::int64_t amount);
+    bool dijkstra();
+    void serveSinks();
+    void augmentTreePath(int sink);
+    void drainSink(int sink);
+};
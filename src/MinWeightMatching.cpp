@@ -0,0 +1,667 @@
+#include "MinWeightMatching.h"
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+struct WEdge { int u, v; double w; };
+
+/* ------------------------------------------------------------
+   Maximum-weight matching with the primal-dual blossom method.
+   Vertices are 0..n-1, blossoms n..2n-1. "Endpoints" p encode
+   edge k = p / 2 seen from vertex endpoint[p]; p ^ 1 is the
+   opposite end. Labels: 0 free, 1 = S, 2 = T (+4 while scanning).
+   ------------------------------------------------------------ */
+class BlossomMatcher {
+public:
+    // Starts a new problem on n vertices. Every buffer keeps its
+    // capacity, so a matcher reused across solves stops allocating
+    // once it has seen the largest instance.
+    void reset(int n, bool maxCard, const std::atomic<bool> *stop) {
+        nv = n;
+        maxCardinality = maxCard;
+        cancel = stop;
+        edges.clear();
+    }
+    void addEdge(int u, int v, double w) { edges.push_back({u, v, w}); }
+
+    // false if cancelled; otherwise matching()[v] is v's mate or -1
+    bool run();
+    const std::vector<int>& matching() const { return mate; }
+
+    // Reduced cost of a pair (i, j) with weight w under the final duals,
+    // including the duals of every blossom that contains both ends.
+    // A negative value means adding (i, j) could improve the matching.
+    double pairSlack(int i, int j, double w) const;
+
+private:
+    int nv{0};
+    std::vector<WEdge> edges;
+    bool maxCardinality{true};
+    const std::atomic<bool> *cancel{nullptr};
+
+    std::vector<int> endpoint;
+    std::vector<std::vector<int>> neighbend;
+    std::vector<int> mate, label, labelend, inblossom, blossomparent;
+    std::vector<std::vector<int>> blossomchilds, blossomendps, blossombestedges;
+    std::vector<bool> hasBestEdgeList;
+    std::vector<int> blossombase, bestedge, unusedblossoms;
+    std::vector<double> dualvar;
+    std::vector<char> allowedge;
+    std::vector<int> queue;
+    // Scratch of the blossom operations (uses never overlap)
+    std::vector<int> scanPath, leaves, subLeaves, leafStack, bestedgeto, nblist;
+    mutable std::vector<int> chainI, chainJ;
+
+    double slack(int k) const {
+        const WEdge &e = edges[k];
+        return dualvar[e.u] + dualvar[e.v] - 2 * e.w;
+    }
+
+    void blossomLeaves(int b, std::vector<int> &out) {
+        auto &stack = leafStack;
+        stack.clear();
+        stack.push_back(b);
+        while (!stack.empty()) {
+            int t = stack.back(); stack.pop_back();
+            if (t < nv) { out.push_back(t); continue; }
+            const auto &ch = blossomchilds[t];
+            for (auto it = ch.rbegin(); it != ch.rend(); ++it) stack.push_back(*it);
+        }
+    }
+
+    void assignLabel(int w, int t, int p);
+    int scanBlossom(int v, int w);
+    void addBlossom(int base, int k);
+    void expandBlossom(int b, bool endstage);
+    void augmentBlossom(int b, int v);
+    void augmentMatching(int k);
+};
+
+void BlossomMatcher::assignLabel(int w, int t, int p) {
+    // Iterative form of the T -> S label chain: a T-blossom always
+    // labels the mate of its base as S.
+    while (true) {
+        int b = inblossom[w];
+        label[w] = label[b] = t;
+        labelend[w] = labelend[b] = p;
+        bestedge[w] = bestedge[b] = -1;
+        if (t == 1) {
+            blossomLeaves(b, queue);
+            return;
+        }
+        int base = blossombase[b];
+        w = endpoint[mate[base]];
+        t = 1;
+        p = mate[base] ^ 1;
+    }
+}
+
+int BlossomMatcher::scanBlossom(int v, int w) {
+    auto &path = scanPath;
+    path.clear();
+    int base = -1;
+    while (v != -1 || w != -1) {
+        int b = inblossom[v];
+        if (label[b] & 4) { base = blossombase[b]; break; }
+        path.push_back(b);
+        label[b] = 5;
+        if (labelend[b] == -1) {
+            v = -1;
+        } else {
+            v = endpoint[labelend[b]];
+            b = inblossom[v];
+            v = endpoint[labelend[b]];
+        }
+        if (w != -1) std::swap(v, w);
+    }
+    for (int b : path) label[b] = 1;
+    return base;
+}
+
+void BlossomMatcher::addBlossom(int base, int k) {
+    int v = edges[k].u, w = edges[k].v;
+    int bb = inblossom[base], bv = inblossom[v], bw = inblossom[w];
+    int b = unusedblossoms.back(); unusedblossoms.pop_back();
+    blossombase[b] = base;
+    blossomparent[b] = -1;
+    blossomparent[bb] = b;
+    auto &path = blossomchilds[b];
+    auto &endps = blossomendps[b];
+    path.clear(); endps.clear();
+    while (bv != bb) {
+        blossomparent[bv] = b;
+        path.push_back(bv);
+        endps.push_back(labelend[bv]);
+        v = endpoint[labelend[bv]];
+        bv = inblossom[v];
+    }
+    path.push_back(bb);
+    std::reverse(path.begin(), path.end());
+    std::reverse(endps.begin(), endps.end());
+    endps.push_back(2 * k);
+    while (bw != bb) {
+        blossomparent[bw] = b;
+        path.push_back(bw);
+        endps.push_back(labelend[bw] ^ 1);
+        w = endpoint[labelend[bw]];
+        bw = inblossom[w];
+    }
+    label[b] = 1;
+    labelend[b] = labelend[bb];
+    dualvar[b] = 0;
+
+    leaves.clear();
+    blossomLeaves(b, leaves);
+    for (int x : leaves) {
+        if (label[inblossom[x]] == 2) queue.push_back(x);
+        inblossom[x] = b;
+    }
+
+    // Keep, per neighbouring S-blossom, the least-slack edge out of b.
+    bestedgeto.assign(2 * nv, -1);
+    for (int sub : path) {
+        nblist.clear();
+        if (!hasBestEdgeList[sub]) {
+            subLeaves.clear();
+            blossomLeaves(sub, subLeaves);
+            for (int x : subLeaves)
+                for (int p : neighbend[x]) nblist.push_back(p / 2);
+        } else {
+            nblist.assign(blossombestedges[sub].begin(), blossombestedges[sub].end());
+        }
+        for (int kk : nblist) {
+            int i = edges[kk].u, j = edges[kk].v;
+            if (inblossom[j] == b) std::swap(i, j);
+            int bj = inblossom[j];
+            if (bj != b && label[bj] == 1 &&
+                (bestedgeto[bj] == -1 || slack(kk) < slack(bestedgeto[bj])))
+                bestedgeto[bj] = kk;
+        }
+        blossombestedges[sub].clear();
+        hasBestEdgeList[sub] = false;
+        bestedge[sub] = -1;
+    }
+    blossombestedges[b].clear();
+    for (int kk : bestedgeto)
+        if (kk != -1) blossombestedges[b].push_back(kk);
+    hasBestEdgeList[b] = true;
+    bestedge[b] = -1;
+    for (int kk : blossombestedges[b])
+        if (bestedge[b] == -1 || slack(kk) < slack(bestedge[b]))
+            bestedge[b] = kk;
+}
+
+// The recursion below only reenters between uses of `leaves`, never
+// while a filled list is still being read, so one buffer serves all levels.
+void BlossomMatcher::expandBlossom(int b, bool endstage) {
+    for (int s : blossomchilds[b]) {
+        blossomparent[s] = -1;
+        if (s < nv) {
+            inblossom[s] = s;
+        } else if (endstage && dualvar[s] == 0) {
+            expandBlossom(s, endstage);
+        } else {
+            leaves.clear();
+            blossomLeaves(s, leaves);
+            for (int x : leaves) inblossom[x] = s;
+        }
+    }
+
+    if (!endstage && label[b] == 2) {
+        // Relabel the sub-blossoms on the even path from the entry
+        // child back to the base.
+        auto &childs = blossomchilds[b];
+        auto &endps = blossomendps[b];
+        const int len = static_cast<int>(childs.size());
+        int entrychild = inblossom[endpoint[labelend[b] ^ 1]];
+        int j = static_cast<int>(std::find(childs.begin(), childs.end(), entrychild) - childs.begin());
+        int jstep, endptrick;
+        if (j & 1) { j -= len; jstep = 1; endptrick = 0; }
+        else { jstep = -1; endptrick = 1; }
+        auto at = [len](const std::vector<int> &vec, int idx) {
+            return vec[(idx % len + len) % len];
+        };
+        int p = labelend[b];
+        while (j != 0) {
+            label[endpoint[p ^ 1]] = 0;
+            label[endpoint[at(endps, j - endptrick) ^ endptrick ^ 1]] = 0;
+            assignLabel(endpoint[p ^ 1], 2, p);
+            allowedge[at(endps, j - endptrick) / 2] = 1;
+            j += jstep;
+            p = at(endps, j - endptrick) ^ endptrick;
+            allowedge[p / 2] = 1;
+            j += jstep;
+        }
+        int bv = at(childs, j);
+        label[endpoint[p ^ 1]] = label[bv] = 2;
+        labelend[endpoint[p ^ 1]] = labelend[bv] = p;
+        bestedge[bv] = -1;
+        j += jstep;
+        while (at(childs, j) != entrychild) {
+            bv = at(childs, j);
+            if (label[bv] == 1) { j += jstep; continue; }
+            leaves.clear();
+            blossomLeaves(bv, leaves);
+            int labelled = -1;
+            for (int x : leaves)
+                if (label[x] != 0) { labelled = x; break; }
+            if (labelled != -1) {
+                label[labelled] = 0;
+                label[endpoint[mate[blossombase[bv]]]] = 0;
+                assignLabel(labelled, 2, labelend[labelled]);
+            }
+            j += jstep;
+        }
+    }
+
+    label[b] = labelend[b] = -1;
+    blossomchilds[b].clear();
+    blossomendps[b].clear();
+    blossombase[b] = -1;
+    blossombestedges[b].clear();
+    hasBestEdgeList[b] = false;
+    bestedge[b] = -1;
+    unusedblossoms.push_back(b);
+}
+
+void BlossomMatcher::augmentBlossom(int b, int v) {
+    int t = v;
+    while (blossomparent[t] != b) t = blossomparent[t];
+    if (t >= nv) augmentBlossom(t, v);
+
+    auto &childs = blossomchilds[b];
+    auto &endps = blossomendps[b];
+    const int len = static_cast<int>(childs.size());
+    auto at = [len](const std::vector<int> &vec, int idx) {
+        return vec[(idx % len + len) % len];
+    };
+    int i = static_cast<int>(std::find(childs.begin(), childs.end(), t) - childs.begin());
+    int j = i;
+    int jstep, endptrick;
+    if (i & 1) { j -= len; jstep = 1; endptrick = 0; }
+    else { jstep = -1; endptrick = 1; }
+    while (j != 0) {
+        j += jstep;
+        t = at(childs, j);
+        int p = at(endps, j - endptrick) ^ endptrick;
+        if (t >= nv) augmentBlossom(t, endpoint[p]);
+        j += jstep;
+        t = at(childs, j);
+        if (t >= nv) augmentBlossom(t, endpoint[p ^ 1]);
+        mate[endpoint[p]] = p ^ 1;
+        mate[endpoint[p ^ 1]] = p;
+    }
+    std::rotate(childs.begin(), childs.begin() + i, childs.end());
+    std::rotate(endps.begin(), endps.begin() + i, endps.end());
+    blossombase[b] = blossombase[childs[0]];
+}
+
+void BlossomMatcher::augmentMatching(int k) {
+    const int ends[2][2] = {{edges[k].u, 2 * k + 1}, {edges[k].v, 2 * k}};
+    for (const auto &sp : ends) {
+        int s = sp[0], p = sp[1];
+        while (true) {
+            int bs = inblossom[s];
+            if (bs >= nv) augmentBlossom(bs, s);
+            mate[s] = p;
+            if (labelend[bs] == -1) break;
+            int t = endpoint[labelend[bs]];
+            int bt = inblossom[t];
+            s = endpoint[labelend[bt]];
+            int j = endpoint[labelend[bt] ^ 1];
+            if (bt >= nv) augmentBlossom(bt, j);
+            mate[j] = labelend[bt];
+            p = labelend[bt] ^ 1;
+        }
+    }
+}
+
+bool BlossomMatcher::run() {
+    const int ne = static_cast<int>(edges.size());
+    mate.assign(nv, -1);
+    if (nv == 0) return true;
+
+    double maxweight = 0;
+    for (const auto &e : edges) maxweight = std::max(maxweight, e.w);
+
+    endpoint.resize(2 * ne);
+    // Nested lists only ever grow and are cleared rather than
+    // reassigned, so the inner vectors keep their capacity.
+    if (static_cast<int>(neighbend.size()) < nv) neighbend.resize(nv);
+    for (int v = 0; v < nv; ++v) neighbend[v].clear();
+    for (int k = 0; k < ne; ++k) {
+        endpoint[2 * k] = edges[k].u;
+        endpoint[2 * k + 1] = edges[k].v;
+        neighbend[edges[k].u].push_back(2 * k + 1);
+        neighbend[edges[k].v].push_back(2 * k);
+    }
+    label.assign(2 * nv, 0);
+    labelend.assign(2 * nv, -1);
+    inblossom.resize(nv);
+    for (int i = 0; i < nv; ++i) inblossom[i] = i;
+    blossomparent.assign(2 * nv, -1);
+    if (static_cast<int>(blossomchilds.size()) < 2 * nv) {
+        blossomchilds.resize(2 * nv);
+        blossomendps.resize(2 * nv);
+        blossombestedges.resize(2 * nv);
+    }
+    for (int b = 0; b < 2 * nv; ++b) {
+        blossomchilds[b].clear();
+        blossomendps[b].clear();
+        blossombestedges[b].clear();
+    }
+    hasBestEdgeList.assign(2 * nv, false);
+    blossombase.assign(2 * nv, -1);
+    for (int i = 0; i < nv; ++i) blossombase[i] = i;
+    bestedge.assign(2 * nv, -1);
+    unusedblossoms.clear();
+    for (int b = 2 * nv - 1; b >= nv; --b) unusedblossoms.push_back(b);
+    dualvar.assign(2 * nv, 0);
+    for (int i = 0; i < nv; ++i) dualvar[i] = maxweight;
+    allowedge.assign(ne, 0);
+
+    for (int stage = 0; stage < nv; ++stage) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+        std::fill(label.begin(), label.end(), 0);
+        std::fill(bestedge.begin(), bestedge.end(), -1);
+        for (int b = nv; b < 2 * nv; ++b) {
+            blossombestedges[b].clear();
+            hasBestEdgeList[b] = false;
+        }
+        std::fill(allowedge.begin(), allowedge.end(), 0);
+        queue.clear();
+
+        for (int v = 0; v < nv; ++v)
+            if (mate[v] == -1 && label[inblossom[v]] == 0)
+                assignLabel(v, 1, -1);
+
+        bool augmented = false;
+        while (true) {
+            // --- Grow alternating trees from S-vertices ---
+            while (!queue.empty() && !augmented) {
+                int v = queue.back(); queue.pop_back();
+                for (int p : neighbend[v]) {
+                    int k = p / 2;
+                    int w = endpoint[p];
+                    if (inblossom[v] == inblossom[w]) continue;
+                    double kslack = 0;
+                    if (!allowedge[k]) {
+                        kslack = slack(k);
+                        if (kslack <= 0) allowedge[k] = 1;
+                    }
+                    if (allowedge[k]) {
+                        if (label[inblossom[w]] == 0) {
+                            assignLabel(w, 2, p ^ 1);
+                        } else if (label[inblossom[w]] == 1) {
+                            int base = scanBlossom(v, w);
+                            if (base >= 0) {
+                                addBlossom(base, k);
+                            } else {
+                                augmentMatching(k);
+                                augmented = true;
+                                break;
+                            }
+                        } else if (label[w] == 0) {
+                            label[w] = 2;
+                            labelend[w] = p ^ 1;
+                        }
+                    } else if (label[inblossom[w]] == 1) {
+                        int b = inblossom[v];
+                        if (bestedge[b] == -1 || kslack < slack(bestedge[b]))
+                            bestedge[b] = k;
+                    } else if (label[w] == 0) {
+                        if (bestedge[w] == -1 || kslack < slack(bestedge[w]))
+                            bestedge[w] = k;
+                    }
+                }
+            }
+            if (augmented) break;
+
+            // --- Dual adjustment ---
+            int deltatype = -1;
+            double delta = 0;
+            int deltaedge = -1, deltablossom = -1;
+            if (!maxCardinality) {
+                deltatype = 1;
+                delta = *std::min_element(dualvar.begin(), dualvar.begin() + nv);
+            }
+            for (int v = 0; v < nv; ++v) {
+                if (label[inblossom[v]] == 0 && bestedge[v] != -1) {
+                    double d = slack(bestedge[v]);
+                    if (deltatype == -1 || d < delta) {
+                        delta = d; deltatype = 2; deltaedge = bestedge[v];
+                    }
+                }
+            }
+            for (int b = 0; b < 2 * nv; ++b) {
+                if (blossomparent[b] == -1 && label[b] == 1 && bestedge[b] != -1) {
+                    double d = slack(bestedge[b]) / 2;
+                    if (deltatype == -1 || d < delta) {
+                        delta = d; deltatype = 3; deltaedge = bestedge[b];
+                    }
+                }
+            }
+            for (int b = nv; b < 2 * nv; ++b) {
+                if (blossombase[b] >= 0 && blossomparent[b] == -1 && label[b] == 2 &&
+                    (deltatype == -1 || dualvar[b] < delta)) {
+                    delta = dualvar[b]; deltatype = 4; deltablossom = b;
+                }
+            }
+            if (deltatype == -1) {
+                // No further improvement possible (max-cardinality mode).
+                deltatype = 1;
+                delta = std::max(0.0, *std::min_element(dualvar.begin(), dualvar.begin() + nv));
+            }
+
+            for (int v = 0; v < nv; ++v) {
+                if (label[inblossom[v]] == 1) dualvar[v] -= delta;
+                else if (label[inblossom[v]] == 2) dualvar[v] += delta;
+            }
+            for (int b = nv; b < 2 * nv; ++b) {
+                if (blossombase[b] >= 0 && blossomparent[b] == -1) {
+                    if (label[b] == 1) dualvar[b] += delta;
+                    else if (label[b] == 2) dualvar[b] -= delta;
+                }
+            }
+
+            if (deltatype == 1) {
+                break;
+            } else if (deltatype == 2) {
+                allowedge[deltaedge] = 1;
+                int i = edges[deltaedge].u, j = edges[deltaedge].v;
+                if (label[inblossom[i]] == 0) std::swap(i, j);
+                queue.push_back(i);
+            } else if (deltatype == 3) {
+                allowedge[deltaedge] = 1;
+                queue.push_back(edges[deltaedge].u);
+            } else {
+                expandBlossom(deltablossom, false);
+            }
+        }
+        if (!augmented) break;
+
+        // End of stage: expand S-blossoms whose dual dropped to zero.
+        for (int b = nv; b < 2 * nv; ++b)
+            if (blossomparent[b] == -1 && blossombase[b] >= 0 &&
+                label[b] == 1 && dualvar[b] == 0)
+                expandBlossom(b, true);
+    }
+
+    for (int v = 0; v < nv; ++v)
+        if (mate[v] >= 0) mate[v] = endpoint[mate[v]];
+    return true;
+}
+
+double BlossomMatcher::pairSlack(int i, int j, double w) const {
+    double s = dualvar[i] + dualvar[j] - 2 * w;
+    if (inblossom[i] != inblossom[j]) return s;
+    // Both ends share the same top-level blossom: add 2·z_B for every
+    // blossom on the common part of their ancestor chains.
+    auto &ci = chainI, &cj = chainJ;
+    ci.clear(); cj.clear();
+    for (int b = blossomparent[i]; b != -1; b = blossomparent[b]) ci.push_back(b);
+    for (int b = blossomparent[j]; b != -1; b = blossomparent[b]) cj.push_back(b);
+    auto a = ci.rbegin(), c = cj.rbegin();
+    for (; a != ci.rend() && c != cj.rend() && *a == *c; ++a, ++c)
+        s += 2 * dualvar[*a];
+    return s;
+}
+
+constexpr int kDenseLimit = 64;      // below this the complete graph is cheap enough
+constexpr int kCandidatesPerVertex = 10;
+
+} // namespace
+
+// Everything a solve needs, kept between calls
+struct MinWeightMatching::Workspace::Impl {
+    BlossomMatcher matcher;
+    std::vector<std::pair<int, int>> pairs;
+    std::vector<int> order;
+    std::vector<char> used;
+    std::vector<char> inSet;    // n×n, row-major
+};
+
+MinWeightMatching::Workspace::Workspace() : impl(std::make_unique<Impl>()) {}
+MinWeightMatching::Workspace::~Workspace() = default;
+MinWeightMatching::Workspace::Workspace(Workspace &&) noexcept = default;
+MinWeightMatching::Workspace& MinWeightMatching::Workspace::operator=(Workspace &&) noexcept = default;
+
+namespace {
+// Candidate pairs for the sparse first pass: the k cheapest partners of
+// every vertex plus a greedy perfect matching, so the candidate graph
+// always has a perfect matching when the full one does.
+template <typename Cost>
+void candidatePairs(const Cost &cost, int n, double unreachable, int k,
+                    MinWeightMatching::Workspace::Impl &ws) {
+    auto &pairs = ws.pairs;
+    auto &order = ws.order;
+    pairs.clear();
+    for (int i = 0; i < n; ++i) {
+        order.clear();
+        for (int j = 0; j < n; ++j)
+            if (j != i && cost(i, j) < unreachable) order.push_back(j);
+        int take = std::min<int>(k, static_cast<int>(order.size()));
+        std::partial_sort(order.begin(), order.begin() + take, order.end(),
+                          [&](int a, int b) { return cost(i, a) < cost(i, b); });
+        for (int t = 0; t < take; ++t)
+            pairs.push_back({std::min(i, order[t]), std::max(i, order[t])});
+    }
+    auto &used = ws.used;
+    used.assign(n, 0);
+    for (int i = 0; i < n; ++i) {
+        if (used[i]) continue;
+        int best = -1;
+        for (int j = i + 1; j < n; ++j)
+            if (!used[j] && cost(i, j) < unreachable && (best == -1 || cost(i, j) < cost(i, best)))
+                best = j;
+        if (best == -1) break;
+        used[i] = used[best] = 1;
+        pairs.push_back({i, best});
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
+
+// cost(i, j) is any symmetric accessor; the answer goes to `mate`
+template <typename Cost>
+bool solveWith(const Cost &cost, int n, double unreachable, const std::atomic<bool> *cancel,
+               MinWeightMatching::Workspace::Impl &ws, std::vector<int> &mate) {
+    mate.clear();
+    if (n == 0) return true;
+    if (n % 2 != 0) return false;
+
+    // Min-weight perfect = max-weight max-cardinality with w' = C - w.
+    double maxCost = 0;
+    for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j)
+            if (cost(i, j) < unreachable) maxCost = std::max(maxCost, cost(i, j));
+
+    const double offset = maxCost + 1;
+    BlossomMatcher &matcher = ws.matcher;
+    auto finish = [&matcher, &mate]() {
+        const auto &m = matcher.matching();
+        for (int x : m)
+            if (x < 0) return false;
+        mate.assign(m.begin(), m.end());
+        return true;
+    };
+
+    if (n <= kDenseLimit) {
+        matcher.reset(n, true, cancel);
+        for (int i = 0; i < n; ++i)
+            for (int j = i + 1; j < n; ++j)
+                if (cost(i, j) < unreachable)
+                    matcher.addEdge(i, j, offset - cost(i, j));
+        return matcher.run() && finish();
+    }
+
+    // Large instances: solve on a sparse candidate set, then price every
+    // remaining pair against the final duals. Pairs with negative reduced
+    // cost join the candidate set and the matching is re-solved; when
+    // none is left the duals certify optimality on the complete graph.
+    candidatePairs(cost, n, unreachable, kCandidatesPerVertex, ws);
+    auto &pairs = ws.pairs;
+    auto &inSet = ws.inSet;
+    inSet.assign(static_cast<size_t>(n) * n, 0);
+    for (auto [i, j] : pairs) inSet[static_cast<size_t>(i) * n + j] = 1;
+
+    const double eps = 1e-9 * offset;
+    while (true) {
+        matcher.reset(n, true, cancel);
+        for (auto [i, j] : pairs) matcher.addEdge(i, j, offset - cost(i, j));
+        if (!matcher.run()) return false;
+        for (int x : matcher.matching())
+            if (x < 0) return false;
+
+        bool added = false;
+        for (int i = 0; i < n; ++i)
+            for (int j = i + 1; j < n; ++j) {
+                char &seen = inSet[static_cast<size_t>(i) * n + j];
+                if (!seen && cost(i, j) < unreachable &&
+                    matcher.pairSlack(i, j, offset - cost(i, j)) < -eps) {
+                    seen = 1;
+                    pairs.push_back({i, j});
+                    added = true;
+                }
+            }
+        if (!added) return finish();
+    }
+}
+}
+
+std::vector<int> MinWeightMatching::solve(const std::vector<std::vector<double>> &cost,
+                                          double unreachable,
+                                          const std::atomic<bool> *cancel) {
+    Workspace ws;
+    std::vector<int> mate;
+    auto at = [&cost](int i, int j) { return cost[i][j]; };
+    if (!solveWith(at, static_cast<int>(cost.size()), unreachable, cancel, *ws.impl, mate))
+        return {};
+    return mate;
+}
+
+bool MinWeightMatching::solve(const std::vector<double> &cost, int n, std::vector<int> &mate,
+                              Workspace &ws, double unreachable,
+                              const std::atomic<bool> *cancel) {
+    auto at = [&cost, n](int i, int j) { return cost[static_cast<size_t>(i) * n + j]; };
+    if (solveWith(at, n, unreachable, cancel, *ws.impl, mate)) return true;
+    mate.clear();
+    return false;
+}
+
+double MinWeightMatching::matchingCost(const std::vector<std::vector<double>> &cost,
+                                       const std::vector<int> &mate) {
+    double total = 0;
+    for (size_t i = 0; i < mate.size(); ++i)
+        if (mate[i] > static_cast<int>(i)) total += cost[i][mate[i]];
+    return total;
+}
+
+double MinWeightMatching::matchingCost(const std::vector<double> &cost, int n,
+                                       const std::vector<int> &mate) {
+    double total = 0;
+    for (size_t i = 0; i < mate.size(); ++i)
+        if (mate[i] > static_cast<int>(i)) total += cost[i * n + mate[i]];
+    return total;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/* ============================================================
+   Minimum-weight perfect matching (Edmonds' weighted blossom)
+   ------------------------------------------------------------
+   Primal-dual blossom algorithm, O(n^3) on a complete graph.
+   Used by the Chinese Postman solver to pair odd-degree
+   vertices on their shortest-path distance matrix.
+   ============================================================ */
+class MinWeightMatching {
+public:
+    // cost is an n×n symmetric matrix; entries >= `unreachable`
+    // are treated as missing edges. Returns mate[i] for every row,
+    // or an empty vector if no perfect matching exists. `cancel`
+    // is polled once per augmentation stage; when it is set the
+    // solve stops early and also returns an empty vector.
+    static std::vector<int> solve(const std::vector<std::vector<double>> &cost,
+                                  double unreachable = 1e9,
+                                  const std::atomic<bool> *cancel = nullptr);
+
+    // Reusable solver state (blossom structures, candidate lists).
+    // Keeping one across solves makes repeated matchings allocation
+    // free once it has seen the largest instance.
+    class Workspace {
+    public:
+        Workspace();
+        ~Workspace();
+        Workspace(Workspace &&) noexcept;
+        Workspace& operator=(Workspace &&) noexcept;
+
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+    // Same on a flat row-major n×n matrix, writing into `mate` and
+    // reusing `ws`. Returns false (and clears mate) when there is no
+    // perfect matching or the solve was cancelled.
+    static bool solve(const std::vector<double> &cost, int n, std::vector<int> &mate,
+                      Workspace &ws, double unreachable = 1e9,
+                      const std::atomic<bool> *cancel = nullptr);
+
+    // Total cost of a mate vector returned by solve().
+    static double matchingCost(const std::vector<std::vector<double>> &cost,
+                               const std::vector<int> &mate);
+    static double matchingCost(const std::vector<double> &cost, int n,
+                               const std::vector<int> &mate);
+};
@@ -0,0 +1,248 @@
+#include "MixedPostman.h"
+#include "Algorithms.h"
+#include "Components.h"
+#include <atomic>
+#include <chrono>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double ms(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+template <typename T>
+std::size_t bytesOf(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
+
+struct FlowSummary {
+    double lowerBound{0.0};
+    int orientedEdges{0};
+    int parityEdges{0};
+};
+
+// Vertices of a walk given as undirected edge ids, from the start
+// Algorithms::walkStart finds
+bool walkVertices(const std::vector<Edge> &edges, const std::vector<int> &order, std::vector<int> &walk) {
+    int v = Algorithms::walkStart(edges, order);
+    if (v < 0) return false;
+    walk.assign(1, v);
+    for (int eid : order) {
+        const Edge &e = edges[eid];
+        v = e.u == v ? e.v : e.u;
+        walk.push_back(v);
+    }
+    return true;
+}
+
+// B1..B4 into result (route and stats). Without duplicates no street
+// may repeat: the flow only orients two-way streets and the parity step
+// must not add anything, so a route is an Euler circuit.
+void run(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options, bool duplicates,
+         ChinesePostmanResult &result, FlowSummary &summary) {
+    MixedWorkspace &ws = ctx.postman.mixed;
+    const auto &edges = g.getEdges();
+    const int n = static_cast<int>(g.getVertices().size());
+    if (edges.empty()) return;
+
+    auto report = [&options](const char *phase, int done, int total) {
+        if (options.progress) options.progress(phase, done, total);
+    };
+    auto cancelled = [&options, &result]() {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed))
+            result.cancelled = true;
+        return result.cancelled;
+    };
+    const auto start = Clock::now();
+    auto last = start;
+    auto mark = [&](const char *name) -> PhaseStats & {
+        const auto now = Clock::now();
+        PhaseStats p;
+        p.name = name;
+        p.startMs = ms(start, last);
+        p.wallMs = ms(last, now);
+        result.stats.phases.push_back(p);
+        result.stats.totalMs = ms(start, now);
+        last = now;
+        return result.stats.phases.back();
+    };
+
+    // --- B1. Luồng chi phí nhỏ nhất: cân bằng bậc vào / ra ---
+    report("flow", 0, 1);
+    ctx.postman.csr.assign(edges, n);
+    if (!ctx.postman.csr.isConnected(ctx.euler.visited, ctx.euler.bfsQueue)) return;
+    std::vector<int> &balance = ws.balance;
+    balance.assign(n, 0);
+    double totalWeight = 0.0;
+    for (const Edge &e : edges) {
+        totalWeight += e.weight;
+        if (e.directed) {
+            ++balance[e.v];
+            --balance[e.u];
+        }
+    }
+    MinCostFlow &flow = ws.flow;
+    flow.reset(n);
+    for (int v = 0; v < n; ++v)
+        if (balance[v] != 0) flow.addSupply(v, balance[v]);
+    // Arcs of edge i are consecutive from firstArc[i]: a one-way street
+    // has its repeat arc, a two-way one its two orientation arcs then
+    // its two repeat arcs. Self-loops never unbalance anything.
+    std::vector<int> &firstArc = ws.firstArc;
+    firstArc.assign(edges.size(), -1);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const Edge &e = edges[i];
+        if (e.u == e.v) continue;
+        if (e.directed) {
+            if (duplicates) firstArc[i] = flow.addArc(e.u, e.v, MinCostFlow::kUnbounded, e.weight);
+            continue;
+        }
+        firstArc[i] = flow.addArc(e.u, e.v, 1, 0.0);
+        flow.addArc(e.v, e.u, 1, 0.0);
+        if (duplicates) {
+            flow.addArc(e.u, e.v, MinCostFlow::kUnbounded, e.weight);
+            flow.addArc(e.v, e.u, MinCostFlow::kUnbounded, e.weight);
+        }
+    }
+    const bool balanced = flow.solve(options.cancel);
+    PhaseStats &fp = mark("flow");
+    fp.heapPushes = flow.heapPushes();
+    fp.heapPops = flow.heapPops();
+    fp.edgesRelaxed = flow.arcsScanned();
+    fp.peakBytes = flow.bytes() + bytesOf(balance) + bytesOf(firstArc);
+    if (cancelled() || !balanced) return;  // hoặc có đường một chiều không quay lại được
+    summary.lowerBound = totalWeight + flow.cost();
+
+    // --- B2. Các lượt đi theo hướng đã chọn ---
+    ws.arcFrom.clear();
+    ws.arcTo.clear();
+    ws.arcEdge.clear();
+    ws.parityEdges.clear();
+    auto traverse = [&ws](int from, int to, int eid, int times) {
+        for (; times > 0; --times) {
+            ws.arcFrom.push_back(from);
+            ws.arcTo.push_back(to);
+            ws.arcEdge.push_back(eid);
+        }
+    };
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const Edge &e = edges[i];
+        const int eid = static_cast<int>(i);
+        const int a = firstArc[i];
+        if (e.directed || e.u == e.v) {
+            traverse(e.u, e.v, eid, 1 + (a >= 0 ? flow.flow(a) : 0));
+            continue;
+        }
+        // Flow both ways is a zero-cost cycle: no direction after all
+        const int forward = flow.flow(a), backward = flow.flow(a + 1);
+        if (forward != backward) {
+            ++summary.orientedEdges;
+            if (forward) traverse(e.u, e.v, eid, 1);
+            else traverse(e.v, e.u, eid, 1);
+        } else {
+            ws.parityEdges.push_back(eid);
+        }
+        if (duplicates) {
+            traverse(e.u, e.v, eid, flow.flow(a + 2));
+            traverse(e.v, e.u, eid, flow.flow(a + 3));
+        }
+    }
+    summary.parityEdges = static_cast<int>(ws.parityEdges.size());
+
+    // --- B3. Chẵn lẻ: các cạnh hai chiều còn lại, đi theo chu trình ---
+    // Everything so far is balanced at every vertex, and a closed walk
+    // over the remaining streets keeps it so. Their undirected postman
+    // (one per component) gives the walks with the fewest repeats.
+    if (!ws.parityEdges.empty()) {
+        report("parity", 0, 1);
+        Graph &pg = ws.parityGraph;
+        pg.clear();
+        for (const Vertex &v : g.getVertices()) pg.addVertex(v.position, v.name);
+        for (int eid : ws.parityEdges) pg.addEdge(edges[eid].u, edges[eid].v, edges[eid].weight);
+        if (ws.parity.empty()) ws.parity.resize(1);
+        ChinesePostmanOptions inner;
+        inner.threads = options.threads;
+        inner.cancel = options.cancel;
+        inner.contractChains = options.contractChains;
+        const ComponentSolver::PostmanRoutes parity = ComponentSolver::postman(ws.parity[0], pg, inner);
+        PhaseStats &pp = mark("parity");
+        pp.peakBytes = parity.stats.peakBytes();
+        result.stats.oddVertices = parity.stats.oddVertices;
+        result.stats.threads = parity.stats.threads;
+        if (parity.cancelled) {
+            result.cancelled = true;
+            return;
+        }
+        for (const ChinesePostmanResult &walk : parity.routes) {
+            if (walk.edgeOrder.empty() || (!duplicates && !walk.duplicateEdgeIds.empty())) return;
+            if (!walkVertices(pg.getEdges(), walk.edgeOrder, ws.walk)) return;
+            for (size_t k = 0; k < walk.edgeOrder.size(); ++k)
+                traverse(ws.walk[k], ws.walk[k + 1], ws.parityEdges[walk.edgeOrder[k]], 1);
+        }
+    }
+    if (cancelled()) return;
+
+    // --- B4. Hierholzer có hướng trên mọi lượt đi ---
+    report("euler", 0, 1);
+    if (!Algorithms::findEulerTourDirected(ctx, n, ws.arcFrom, ws.arcTo, ws.arcEdge, result.edgeOrder,
+                                           result.isCycle)
+        || !result.isCycle) {
+        result.edgeOrder.clear();
+    } else {
+        // Every traversal after the first of an edge is a repeat
+        std::vector<char> &served = ctx.euler.visited;
+        served.assign(edges.size(), 0);
+        double cost = 0.0;
+        for (int eid : result.edgeOrder) {
+            cost += edges[eid].weight;
+            if (served[eid]) result.duplicateEdgeIds.push_back(eid);
+            served[eid] = 1;
+        }
+        result.stats.matchingCost = cost - totalWeight;
+    }
+    mark("euler").peakBytes = bytesOf(ws.arcFrom) + bytesOf(ws.arcTo) + bytesOf(ws.arcEdge)
+        + bytesOf(ctx.euler.arcOffsets) + bytesOf(ctx.euler.arcSlots) + bytesOf(result.edgeOrder);
+}
+}
+
+/* ============================================================
+   Hàm solve() — Chinese Postman cho đồ thị có hướng / hỗn hợp
+   ============================================================ */
+MixedPostmanResult MixedPostman::solve(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options) {
+    MixedPostmanResult out;
+    if (!g.hasDirectedEdges()) {
+        // Plain postman: optimal, so the bound is the cost itself
+        ChinesePostmanOptimal::solveInto(ctx, g, options, out.route);
+    } else if (!g.hasOptionalEdges()) {
+        FlowSummary summary;
+        run(ctx, g, options, true, out.route, summary);
+        out.lowerBound = summary.lowerBound;
+        out.orientedEdges = summary.orientedEdges;
+        out.parityEdges = summary.parityEdges;
+    }
+    const auto &edges = g.getEdges();
+    for (int eid : out.route.edgeOrder) out.cost += edges[eid].weight;
+    if (!g.hasDirectedEdges() && g.hasOptionalEdges()) {
+        // RuralPostman's heuristic: only the required streets bound it
+        for (const Edge &e : edges)
+            if (e.required) out.lowerBound += e.weight;
+    } else if (!g.hasDirectedEdges()) {
+        out.lowerBound = out.cost;
+    }
+    if (out.lowerBound > 0.0 && !out.route.edgeOrder.empty()) out.gap = out.cost / out.lowerBound - 1.0;
+    return out;
+}
+
+void MixedPostman::solveInto(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                             ChinesePostmanResult &result) {
+    if (g.hasOptionalEdges()) return;
+    FlowSummary summary;
+    run(ctx, g, options, true, result, summary);
+}
+
+bool MixedPostman::eulerCircuit(SolverContext &ctx, const Graph &g, std::vector<int> &edgeOrder) {
+    ChinesePostmanResult route;
+    FlowSummary summary;
+    run(ctx, g, {}, false, route, summary);
+    edgeOrder.swap(route.edgeOrder);
+    return !edgeOrder.empty();
+}
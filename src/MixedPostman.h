@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "Graph.h"
+#include "ChinesePostman.h"
+#include "SolverContext.h"
+#include "SolverStats.h"
+
+/* ============================================================
+   MixedPostman — postman tours that respect one-way streets
+   ------------------------------------------------------------
+   A closed walk may only take a directed edge u → v, so a tour
+   exists only if in-degree = out-degree everywhere once the
+   repeated streets are counted. Instead of matching odd vertices:
+     B1. Min-cost flow (MinCostFlow.h): every vertex with more
+         one-way streets in than out supplies the difference,
+         every vertex with more out demands it. Arcs: a one-way
+         street repeated (u → v, cost w, unbounded); a two-way
+         street given a direction (u → v or v → u, capacity 1,
+         cost 0) or repeated either way (cost w, unbounded).
+     B2. Every traversal the flow chose becomes an arc; a two-way
+         street with flow on exactly one orientation arc is
+         driven that way.
+     B3. Parity: the two-way streets left without a direction are
+         walked as closed walks (undirected postman per component,
+         ComponentSolver), which keeps every vertex balanced.
+     B4. Directed Hierholzer over all the arcs.
+   With only one-way streets this is optimal (B3 is empty). The
+   mixed problem is NP-hard; there B3 is Frederickson-style and
+   the route is reported with a lower bound: total weight + flow
+   cost (the flow relaxes "every two-way street is driven once").
+   A graph without one-way streets goes to ChinesePostmanOptimal.
+   The flow has no notion of optional streets (Edge::required), so
+   a graph with both one-way and optional streets is rejected:
+   an empty route, rather than a tour over every street.
+   ============================================================ */
+
+struct MixedPostmanResult {
+    // Empty when the graph is not connected, some one-way street has
+    // no way back to its tail, or some street is optional as well
+    ChinesePostmanResult route;
+    double cost{0.0};
+    double lowerBound{0.0};
+    double gap{0.0};              // cost / lowerBound − 1
+    int orientedEdges{0};         // two-way streets given a direction by the flow
+    int parityEdges{0};           // two-way streets left to B3
+};
+
+class MixedPostman {
+public:
+    // Phases "flow", "parity", "euler" (progress and route.stats);
+    // options.threads and contractChains apply to B3.
+    static MixedPostmanResult solve(SolverContext &ctx, const Graph &g,
+                                    const ChinesePostmanOptions &options = {});
+    // Route only, into a result the caller has reset; what
+    // ChinesePostmanOptimal::solveInto runs for a graph with one-way
+    // streets
+    static void solveInto(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                          ChinesePostmanResult &result);
+    // Euler circuit driving every street exactly once in an allowed
+    // direction (B1–B4 without repeats); false if there is none
+    static bool eulerCircuit(SolverContext &ctx, const Graph &g, std::vector<int> &edgeOrder);
+};
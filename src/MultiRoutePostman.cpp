@@ -0,0 +1,288 @@
+#include "MultiRoutePostman.h"
+#include "Algorithms.h"
+#include "ParallelExecutor.h"
+#include "ShortestPaths.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double ms(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Greedy split of the tour (doubled, so any start offset reads m
+// consecutive positions) for a bound on the closed route cost
+struct TourSplit {
+    const std::vector<double> &prefix;   // cost of tour positions [0, i)
+    const std::vector<double> &home;     // depot distance of the vertex at position i
+    int m;                               // tour length
+    int k;                               // pieces allowed
+
+    // Pieces [cuts[i], cuts[i+1]) from `offset`, each the longest whose
+    // closed route stays ≤ bound; false when more than k are needed
+    bool cut(int offset, double bound, std::vector<int> *cuts) const {
+        if (cuts) cuts->assign(1, offset);
+        const int end = offset + m;
+        int pieces = 0;
+        for (int p = offset; p < end;) {
+            if (++pieces > k) return false;
+            int best = -1;
+            // Past the first q whose way out + piece exceeds the bound no
+            // way back can fit
+            for (int q = p + 1; q <= end && home[p] + prefix[q] - prefix[p] <= bound; ++q)
+                if (home[p] + prefix[q] - prefix[p] + home[q] <= bound) best = q;
+            if (best < 0) return false;
+            p = best;
+            if (cuts) cuts->push_back(p);
+        }
+        return true;
+    }
+};
+
+// Vertices of a closed walk given as edge ids, from the start
+// Algorithms::walkStart finds; false when the edges do not close up
+bool closedWalk(const std::vector<Edge> &edges, const std::vector<int> &order, std::vector<int> &walk) {
+    int v = Algorithms::walkStart(edges, order);
+    if (v < 0) return false;
+    walk.assign(1, v);
+    for (int eid : order) {
+        v = edges[eid].u == v ? edges[eid].v : edges[eid].u;
+        walk.push_back(v);
+    }
+    return walk.back() == walk.front();
+}
+}
+
+/* ============================================================
+   Hàm solve() — k tuyến tuần tra xuất phát từ trạm
+   ============================================================ */
+MultiRouteResult MultiRoutePostman::solve(SolverContext &ctx, const Graph &g, const MultiRouteOptions &options) {
+    MultiRouteResult out;
+    const auto &verts = g.getVertices();
+    const auto &edges = g.getEdges();
+    const int n = static_cast<int>(verts.size());
+    const int k = std::max(1, options.routes);
+    const int depot = options.depot;
+    out.routes.resize(k);
+    out.servicedBy.assign(edges.size(), -1);
+    // With optional streets only the required ones need to be connected
+    // (RuralPostman checks), and to the depot (checked after B2)
+    if (edges.empty() || depot < 0 || depot >= n || g.hasDirectedEdges()
+        || (!g.hasOptionalEdges() && !g.isConnectedUndirected()))
+        return out;
+    if (std::none_of(edges.begin(), edges.end(), [depot](const Edge &e) { return e.u == depot || e.v == depot; }))
+        return out;
+
+    const auto start = Clock::now();
+    auto last = start;
+    auto mark = [&](const char *name) -> PhaseStats & {
+        const auto now = Clock::now();
+        PhaseStats p;
+        p.name = name;
+        p.startMs = ms(start, last);
+        p.wallMs = ms(last, now);
+        out.stats.phases.push_back(p);
+        last = now;
+        return out.stats.phases.back();
+    };
+    auto report = [&options](const char *phase, int done, int total) {
+        if (options.progress) options.progress(phase, done, total);
+    };
+    auto cancelled = [&options, &out]() {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed)) out.cancelled = true;
+        return out.cancelled;
+    };
+    auto other = [&edges](int eid, int v) { return edges[eid].u == v ? edges[eid].v : edges[eid].u; };
+
+    // --- B1. Tour tối ưu của toàn đồ thị, quay về bắt đầu tại trạm ---
+    report("tour", 0, 1);
+    ChinesePostmanOptions tourOptions;
+    tourOptions.threads = options.threads;
+    tourOptions.cancel = options.cancel;
+    tourOptions.contractChains = options.contractChains;
+    ChinesePostmanResult giant;
+    ChinesePostmanOptimal::solveInto(ctx, g, tourOptions, giant);
+    PhaseStats &tourPhase = mark("tour");
+    for (const PhaseStats &p : giant.stats.phases) {
+        tourPhase.heapPushes += p.heapPushes;
+        tourPhase.heapPops += p.heapPops;
+        tourPhase.edgesRelaxed += p.edgesRelaxed;
+        tourPhase.peakBytes = std::max(tourPhase.peakBytes, p.peakBytes);
+    }
+    if (giant.cancelled || cancelled()) {
+        out.cancelled = true;
+        return out;
+    }
+    if (giant.edgeOrder.empty() || !giant.isCycle) return out;
+
+    const int m = static_cast<int>(giant.edgeOrder.size());
+    std::vector<int> walk;
+    if (!closedWalk(edges, giant.edgeOrder, walk)) return out;
+    const int shift = static_cast<int>(std::find(walk.begin(), walk.end() - 1, depot) - walk.begin());
+    std::vector<int> tour(2 * m), tourVertex(2 * m + 1);
+    for (int i = 0; i <= 2 * m; ++i) {
+        if (i < 2 * m) tour[i] = giant.edgeOrder[(shift + i) % m];
+        tourVertex[i] = walk[(shift + i) % m];
+    }
+    // The rural tour is a heuristic: only the required streets bound it
+    const bool rural = g.hasOptionalEdges();
+    double coverCost = 0.0;
+    if (rural) {
+        for (const Edge &e : edges)
+            if (e.required) coverCost += e.weight;
+    } else {
+        for (int eid : giant.edgeOrder) coverCost += edges[eid].weight;
+    }
+
+    // --- B2. Đường chạy không từ trạm (một Dijkstra) ---
+    report("deadhead", 0, 1);
+    PostmanWorkspace &ws = ctx.postman;
+    ws.csr.assign(edges, n);
+    if (ctx.dijkstra.empty()) ctx.dijkstra.resize(1);
+    DijkstraScratch &fromDepot = ctx.dijkstra[0];
+    const std::int64_t pushes = fromDepot.pushes, pops = fromDepot.pops, relaxed = fromDepot.relaxed;
+    ShortestPaths::dijkstra(ws.csr, depot, fromDepot);
+    const std::vector<double> &dist = fromDepot.dist;
+    const std::vector<int> &parentEdge = fromDepot.parentEdge;
+    if (dist[tourVertex[0]] == ShortestPaths::unreachable<double>()) return out;
+    double roundTrip = 0.0;
+    for (const Edge &e : edges)
+        if (e.required) roundTrip = std::max(roundTrip, dist[e.u] + e.weight + dist[e.v]);
+    out.lowerBound = std::max(coverCost / k, roundTrip);
+    PhaseStats &deadheadPhase = mark("deadhead");
+    deadheadPhase.heapPushes = fromDepot.pushes - pushes;
+    deadheadPhase.heapPops = fromDepot.pops - pops;
+    deadheadPhase.edgesRelaxed = fromDepot.relaxed - relaxed;
+    deadheadPhase.peakBytes = fromDepot.bytes();
+    if (cancelled()) return out;
+
+    // --- B3. Cắt tour thành ≤ k đoạn, thử song song nhiều điểm bắt đầu ---
+    report("split", 0, 1);
+    std::vector<double> prefix(2 * m + 1, 0.0), home(2 * m + 1);
+    for (int i = 0; i < 2 * m; ++i) prefix[i + 1] = prefix[i] + edges[tour[i]].weight;
+    for (int i = 0; i <= 2 * m; ++i) home[i] = dist[tourVertex[i]];
+    const TourSplit split{prefix, home, m, k};
+    ParallelExecutor executor(options.threads);
+    const int candidates = std::min(m, options.splitCandidates > 0 ? options.splitCandidates
+                                                                   : 2 * static_cast<int>(executor.workerCount()));
+    std::vector<double> candidateBound(candidates, std::numeric_limits<double>::infinity());
+    executor.parallelFor(candidates, [&](int c, unsigned) {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed)) return;
+        const int offset = static_cast<int>(static_cast<std::int64_t>(c) * m / candidates);
+        // One piece (the whole tour) always fits; nothing fits under the bound
+        double hi = home[offset] + prefix[offset + m] - prefix[offset] + home[offset + m];
+        double lo = out.lowerBound;
+        for (int it = 0; it < 64 && hi - lo > 1e-9 * hi; ++it) {
+            const double mid = 0.5 * (lo + hi);
+            if (split.cut(offset, mid, nullptr)) hi = mid;
+            else lo = mid;
+        }
+        candidateBound[c] = hi;
+    });
+    if (cancelled()) return out;
+    const int bestCandidate = static_cast<int>(
+        std::min_element(candidateBound.begin(), candidateBound.end()) - candidateBound.begin());
+    const int offset = static_cast<int>(static_cast<std::int64_t>(bestCandidate) * m / candidates);
+    std::vector<int> cuts;
+    split.cut(offset, candidateBound[bestCandidate], &cuts);
+
+    const int used = static_cast<int>(cuts.size()) - 1;
+    std::vector<int> outbound;
+    for (int r = 0; r < used; ++r) {
+        std::vector<int> &route = out.routes[r].edgeOrder;
+        outbound.clear();
+        for (int v = tourVertex[cuts[r]]; v != depot; v = other(parentEdge[v], v)) outbound.push_back(parentEdge[v]);
+        route.assign(outbound.rbegin(), outbound.rend());
+        for (int i = cuts[r]; i < cuts[r + 1]; ++i) {
+            route.push_back(tour[i]);
+            if (out.servicedBy[tour[i]] < 0) out.servicedBy[tour[i]] = r;
+        }
+        for (int v = tourVertex[cuts[r + 1]]; v != depot; v = other(parentEdge[v], v)) route.push_back(parentEdge[v]);
+        for (int eid : route) out.routes[r].cost += edges[eid].weight;
+    }
+    mark("split");
+
+    // --- B4. Cải thiện: giải lại từng tuyến trên chính các cạnh nó đi qua ---
+    report("improve", 0, used);
+    const unsigned workers = std::min<unsigned>(executor.workerCount(), static_cast<unsigned>(std::max(used, 1)));
+    if (ctx.workerContexts.size() + 1 < workers) ctx.workerContexts.resize(workers - 1);
+    std::vector<Graph> subgraphs(workers);
+    std::vector<std::vector<int>> localIndex(workers, std::vector<int>(n, -1));
+    ChinesePostmanOptions routeOptions;
+    routeOptions.threads = 1;
+    routeOptions.cancel = options.cancel;
+    routeOptions.contractChains = options.contractChains;
+    std::vector<SolverStats> routeStats(used);
+    std::atomic<int> improved{0};
+    executor.parallelFor(used, [&](int r, unsigned worker) {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed)) return;
+        PatrolRoute &route = out.routes[r];
+        std::vector<int> streets = route.edgeOrder;
+        std::sort(streets.begin(), streets.end());
+        streets.erase(std::unique(streets.begin(), streets.end()), streets.end());
+        Graph &sub = subgraphs[worker];
+        std::vector<int> &local = localIndex[worker];
+        std::vector<int> touched;
+        sub.clear();
+        for (int eid : streets)
+            for (int v : {edges[eid].u, edges[eid].v})
+                if (local[v] < 0) {
+                    local[v] = sub.addVertex(verts[v].position, verts[v].name);
+                    touched.push_back(v);
+                }
+        for (int eid : streets) sub.addEdge(local[edges[eid].u], local[edges[eid].v], edges[eid].weight);
+
+        SolverContext &solverCtx = worker == 0 ? ctx : ctx.workerContexts[worker - 1];
+        ChinesePostmanResult result;
+        ChinesePostmanOptimal::solveInto(solverCtx, sub, routeOptions, result);
+        routeStats[r] = result.stats;
+        double cost = 0.0;
+        for (int eid : result.edgeOrder) cost += edges[streets[eid]].weight;
+        std::vector<int> seq;
+        if (!result.edgeOrder.empty() && result.isCycle && cost < route.cost
+            && closedWalk(sub.getEdges(), result.edgeOrder, seq)) {
+            // Same closed walk, started at the depot
+            const int len = static_cast<int>(result.edgeOrder.size());
+            const int at = static_cast<int>(std::find(seq.begin(), seq.end() - 1, local[depot]) - seq.begin());
+            route.edgeOrder.resize(len);
+            for (int i = 0; i < len; ++i) route.edgeOrder[i] = streets[result.edgeOrder[(at + i) % len]];
+            route.cost = cost;
+        }
+        for (int v : touched) local[v] = -1;
+        report("improve", ++improved, used);
+    });
+    PhaseStats &improvePhase = mark("improve");
+    for (const SolverStats &s : routeStats)
+        for (const PhaseStats &p : s.phases) {
+            improvePhase.heapPushes += p.heapPushes;
+            improvePhase.heapPops += p.heapPops;
+            improvePhase.edgesRelaxed += p.edgesRelaxed;
+            improvePhase.peakBytes = std::max(improvePhase.peakBytes, p.peakBytes);
+        }
+    if (cancelled()) return out;
+
+    for (const PatrolRoute &route : out.routes) {
+        out.maxCost = std::max(out.maxCost, route.cost);
+        out.totalCost += route.cost;
+    }
+    out.gap = out.lowerBound > 0.0 ? out.maxCost / out.lowerBound - 1.0 : 0.0;
+    out.stats.oddVertices = giant.stats.oddVertices;
+    out.stats.chainVertices = giant.stats.chainVertices;
+    out.stats.matchingCost = giant.stats.matchingCost;
+    out.stats.integerWeights = giant.stats.integerWeights;
+    out.stats.dense = giant.stats.dense;
+    out.stats.threads = executor.workerCount();
+    out.stats.totalMs = ms(start, Clock::now());
+    ctx.stats = out.stats;
+    // ctx.lastPostman keeps the first unit's route
+    if (!ctx.lastPostman) ctx.lastPostman.emplace();
+    ctx.lastPostman->edgeOrder = out.routes[0].edgeOrder;
+    ctx.lastPostman->isCycle = true;
+    ctx.lastPostman->vertexOrder.clear();
+    return out;
+}
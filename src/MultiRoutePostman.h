@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "Graph.h"
+#include "ChinesePostman.h"
+#include "SolverContext.h"
+#include "SolverStats.h"
+
+/* ============================================================
+   MultiRoutePostman — k patrol units from one station
+   ------------------------------------------------------------
+   Min-max k-Chinese-Postman: k closed routes from the depot that
+   together cover every street, the longest as short as possible;
+   with optional streets (Edge::required) only the required ones,
+   the giant tour then being RuralPostman's.
+   Route first, split second (Frederickson, Hecht & Kim):
+     B1. One optimal postman tour of the whole graph, rotated to
+         start at the depot.
+     B2. One Dijkstra from the depot: the deadhead paths out to a
+         piece of the tour and back.
+     B3. Split: the tour is cut into at most k consecutive pieces,
+         each closed by depot → first vertex and last vertex →
+         depot. For a bound T the pieces grow greedily while the
+         closed route stays ≤ T, and a bisection finds the least
+         T that needs ≤ k pieces. The tour is a cycle, so several
+         start offsets are tried concurrently; the best is kept.
+     B4. Improvement, one route per worker: every route is
+         re-solved as an optimal postman tour of the streets it
+         already uses. It still covers the same streets, minus the
+         repeats that the giant tour and the deadhead paths stacked
+         on top of each other.
+   Lower bound: max(postman cost / k, longest depot → street →
+   depot round trip), over the required streets and with their
+   weight for the cost when some are optional; gap = longest
+   route / bound − 1.
+   ============================================================ */
+
+struct MultiRouteOptions {
+    int routes{2};                // patrol units (k)
+    int depot{0};                 // station every route starts and ends at
+    // Start offsets tried by the split (B3); 0 = two per worker
+    int splitCandidates{0};
+    // Worker threads for B3/B4 (0 = all cores)
+    unsigned threads{0};
+    const std::atomic<bool> *cancel{nullptr};
+    // progress(phase, done, total); "improve" once per re-solved route
+    std::function<void(const char *phase, int done, int total)> progress;
+    // Passed to the giant tour and the route re-solves
+    bool contractChains{false};
+};
+
+struct PatrolRoute {
+    std::vector<int> edgeOrder;   // closed walk from the depot (original edge ids)
+    double cost{0.0};
+};
+
+struct MultiRouteResult {
+    // options.routes entries; a unit left without work has an empty walk
+    std::vector<PatrolRoute> routes;
+    // Per edge: the route servicing it (its first traversal in the split)
+    std::vector<int> servicedBy;
+    double maxCost{0.0};
+    double totalCost{0.0};
+    double lowerBound{0.0};
+    double gap{0.0};              // maxCost / lowerBound − 1
+    bool cancelled{false};
+    SolverStats stats;
+};
+
+class MultiRoutePostman {
+public:
+    // The routes are empty when the graph is disconnected (with optional
+    // streets: the required ones, or the depot from them), has one-way
+    // streets (the deadhead paths and re-solves treat every street as
+    // two-way) or the depot has no street.
+    static MultiRouteResult solve(SolverContext &ctx, const Graph &g, const MultiRouteOptions &options = {});
+};
@@ -0,0 +1,76 @@
+#include "ParallelExecutor.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<int> items;
+
+    bool popBack(int &out) {
+        std::lock_guard<std::mutex> g(lock);
+        if (items.empty()) return false;
+        out = items.back();
+        items.pop_back();
+        return true;
+    }
+
+    bool stealFront(int &out) {
+        std::lock_guard<std::mutex> g(lock);
+        if (items.empty()) return false;
+        out = items.front();
+        items.pop_front();
+        return true;
+    }
+};
+}
+
+ParallelExecutor::ParallelExecutor(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    workers = std::max(1u, threads);
+}
+
+void ParallelExecutor::run(int count, const std::function<void(int, unsigned)> &body) const {
+    const unsigned n = std::min<unsigned>(workers, static_cast<unsigned>(count));
+
+    // Tasks never spawn new tasks, so all queues are filled up front
+    // and a worker may exit as soon as every queue is empty.
+    std::vector<WorkQueue> queues(n);
+    for (int i = 0; i < count; ++i)
+        queues[i % n].items.push_back(i);
+
+    std::exception_ptr firstError;
+    std::mutex errorLock;
+    std::atomic<bool> failed{false};
+
+    auto worker = [&](unsigned id) {
+        int index;
+        while (!failed.load(std::memory_order_relaxed)) {
+            bool found = queues[id].popBack(index);
+            for (unsigned k = 1; !found && k < n; ++k)
+                found = queues[(id + k) % n].stealFront(index);
+            if (!found) return;
+            try {
+                body(index, id);
+            } catch (...) {
+                std::lock_guard<std::mutex> g(errorLock);
+                if (!firstError) firstError = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1);
+    for (unsigned id = 1; id < n; ++id)
+        threads.emplace_back(worker, id);
+    worker(0);
+    for (auto &t : threads) t.join();
+
+    if (firstError) std::rethrow_exception(firstError);
+}
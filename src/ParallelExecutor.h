@@ -0,0 +1,38 @@
+#pragma once
+#include <functional>
+
+/* ============================================================
+   ParallelExecutor — work-stealing parallel-for
+   ------------------------------------------------------------
+   Indices are dealt round-robin into one deque per worker.
+   A worker pops from the back of its own deque and, once it
+   runs dry, steals from the front of the others. Each call to
+   body() receives the worker id so callers can keep reusable
+   per-worker scratch buffers.
+   ============================================================ */
+class ParallelExecutor {
+public:
+    // threads == 0 → std::thread::hardware_concurrency()
+    explicit ParallelExecutor(unsigned threads = 0);
+
+    unsigned workerCount() const { return workers; }
+
+    // Runs body(index, workerId) for every index in [0, count) and
+    // blocks until all of them finished. The first exception thrown
+    // by body() is rethrown on the calling thread. With one worker
+    // the loop runs inline and nothing is allocated.
+    template <typename Body>
+    void parallelFor(int count, const Body &body) const {
+        if (workers == 1 || count <= 1) {
+            for (int i = 0; i < count; ++i) body(i, 0u);
+            return;
+        }
+        // std::cref keeps std::function from copying body to the heap
+        run(count, std::function<void(int, unsigned)>(std::cref(body)));
+    }
+
+private:
+    unsigned workers{1};
+
+    void run(int count, const std::function<void(int, unsigned)> &body) const;
+};
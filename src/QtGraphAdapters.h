@@ -0,0 +1,22 @@
+#pragma once
+#include <QColor>
+#include <QPointF>
+#include <QString>
+#include "Graph.h"
+
+// Conversions between the Qt-free Graph types and Qt's geometry/strings
+inline QPointF toQPointF(const Point2D &p) { return QPointF(p.x, p.y); }
+inline Point2D toPoint2D(const QPointF &p) { return Point2D{p.x(), p.y()}; }
+inline QString toQString(const std::string &s) { return QString::fromStdString(s); }
+
+// Distinct colour per patrol route; red and grey stay reserved for
+// duplicated and untraversed streets
+inline QColor routeColor(int index) {
+    static const QColor palette[] = {
+        QColor(0, 120, 255), QColor(0, 160, 80), QColor(255, 140, 0), QColor(150, 60, 200),
+        QColor(0, 170, 170), QColor(140, 90, 40), QColor(220, 40, 150), QColor(120, 130, 0),
+    };
+    constexpr int size = static_cast<int>(sizeof(palette) / sizeof(palette[0]));
+    if (index < size) return palette[index];
+    return QColor::fromHsv((index * 137) % 360, 200, 220);
+}
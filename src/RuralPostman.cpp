@@ -0,0 +1,364 @@
+#include "RuralPostman.h"
+#include "Algorithms.h"
+#include "Components.h"
+#include "MinWeightMatching.h"
+#include "ParallelExecutor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+double ms(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+template <typename T>
+std::size_t bytesOf(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
+
+// B1: labels every vertex of a required street with its piece
+// (ws.cell); returns the number of pieces
+int findPieces(SolverContext &ctx, const Graph &g) {
+    RuralWorkspace &ws = ctx.postman.rural;
+    const auto &edges = g.getEdges();
+    const CsrAdjacency &csr = ctx.postman.csr;
+    const int n = csr.vertexCount();
+
+    // --- B1. Các mảnh: thành phần liên thông của các cạnh bắt buộc ---
+    std::vector<int> &cell = ws.cell;
+    cell.assign(n, -1);
+    int pieces = 0;
+    for (const Edge &e : edges) {
+        if (!e.required || cell[e.u] >= 0) continue;
+        cell[e.u] = pieces;
+        ws.queue.assign(1, e.u);
+        for (size_t head = 0; head < ws.queue.size(); ++head) {
+            const int u = ws.queue[head];
+            for (int s = csr.begin(u); s < csr.end(u); ++s) {
+                const int w = csr.neighbors[s];
+                if (!edges[csr.edgeIds[s]].required || cell[w] >= 0) continue;
+                cell[w] = pieces;
+                ws.queue.push_back(w);
+            }
+        }
+        ++pieces;
+    }
+    return pieces;
+}
+
+// B2 into ws.inStructure; false when some piece cannot reach the others
+bool connectPieces(SolverContext &ctx, const Graph &g, int pieces, PhaseStats &phase) {
+    RuralWorkspace &ws = ctx.postman.rural;
+    const auto &edges = g.getEdges();
+    const CsrAdjacency &csr = ctx.postman.csr;
+    const int n = csr.vertexCount();
+    std::vector<int> &cell = ws.cell;
+    ws.inStructure.assign(edges.size(), 0);
+    if (pieces <= 1) return true;
+
+    // --- B2. Dijkstra đa nguồn: mỗi đỉnh thuộc ô của mảnh gần nhất ---
+    DijkstraScratch &sp = ws.search;
+    sp.dist.assign(n, kInfinity);
+    sp.parentEdge.assign(n, -1);
+    sp.queue.clear();
+    sp.pushes = sp.pops = sp.relaxed = 0;
+    for (int v = 0; v < n; ++v)
+        if (cell[v] >= 0) {
+            sp.dist[v] = 0.0;
+            sp.queue.push(0.0, v);
+            ++sp.pushes;
+        }
+    while (!sp.queue.empty()) {
+        auto [d, u] = sp.queue.pop();
+        ++sp.pops;
+        if (d != sp.dist[u]) continue;
+        for (int s = csr.begin(u); s < csr.end(u); ++s) {
+            ++sp.relaxed;
+            const int w = csr.neighbors[s];
+            const double nd = d + csr.weights[s];
+            if (nd < sp.dist[w]) {
+                sp.dist[w] = nd;
+                sp.parentEdge[w] = csr.edgeIds[s];
+                cell[w] = cell[u];
+                sp.queue.push(nd, w);
+                ++sp.pushes;
+            }
+        }
+    }
+
+    // Kruskal over the links between cells; each chosen link brings
+    // its path back to the two pieces (shared tails are added once)
+    ws.links.clear();
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const Edge &e = edges[i];
+        if (cell[e.u] < 0 || cell[e.v] < 0 || cell[e.u] == cell[e.v]) continue;
+        ws.links.push_back({sp.dist[e.u] + e.weight + sp.dist[e.v], static_cast<int>(i)});
+    }
+    std::sort(ws.links.begin(), ws.links.end());
+    UnionFind joined(pieces);
+    int merges = 0;
+    for (const auto &[cost, eid] : ws.links) {
+        const Edge &link = edges[eid];
+        if (!joined.unite(cell[link.u], cell[link.v])) continue;
+        ws.inStructure[eid] = 1;
+        for (int v : {link.u, link.v}) {
+            for (int pe = sp.parentEdge[v]; pe >= 0 && !ws.inStructure[pe]; pe = sp.parentEdge[v]) {
+                ws.inStructure[pe] = 1;
+                v = edges[pe].u == v ? edges[pe].v : edges[pe].u;
+            }
+        }
+        if (++merges == pieces - 1) break;
+    }
+    phase.heapPushes = sp.pushes;
+    phase.heapPops = sp.pops;
+    phase.edgesRelaxed = sp.relaxed;
+    phase.peakBytes = sp.bytes() + bytesOf(cell) + bytesOf(ws.links) + bytesOf(ws.inStructure);
+    return merges == pieces - 1;
+}
+// Dijkstra from source over every street until settle(v, d) returns
+// true; only the vertices it touched are reset by the next call
+template <typename Settle>
+void boundedSearch(const CsrAdjacency &csr, int source, RuralSearch &s, Settle settle) {
+    DijkstraScratch &p = s.paths;
+    const int n = csr.vertexCount();
+    if (static_cast<int>(p.dist.size()) != n) {
+        p.dist.assign(n, kInfinity);
+        p.parentEdge.assign(n, -1);
+    } else {
+        for (int v : s.touched) {
+            p.dist[v] = kInfinity;
+            p.parentEdge[v] = -1;
+        }
+    }
+    s.touched.assign(1, source);
+    p.queue.clear();
+    p.dist[source] = 0.0;
+    p.queue.push(0.0, source);
+    ++p.pushes;
+    while (!p.queue.empty()) {
+        auto [d, u] = p.queue.pop();
+        ++p.pops;
+        if (d != p.dist[u]) continue;
+        if (settle(u, d)) return;
+        for (int k = csr.begin(u); k < csr.end(u); ++k) {
+            ++p.relaxed;
+            const int w = csr.neighbors[k];
+            const double nd = d + csr.weights[k];
+            if (nd < p.dist[w]) {
+                if (p.dist[w] == kInfinity) s.touched.push_back(w);
+                p.dist[w] = nd;
+                p.parentEdge[w] = csr.edgeIds[k];
+                p.queue.push(nd, w);
+                ++p.pushes;
+            }
+        }
+    }
+}
+}
+
+/* ============================================================
+   Hàm solve() — Rural Postman: chỉ phủ các cạnh bắt buộc
+   ============================================================ */
+RuralPostmanResult RuralPostman::solve(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options) {
+    RuralPostmanResult out;
+    ChinesePostmanOptimal::solveInto(ctx, g, options, out.route);
+    const auto &edges = g.getEdges();
+    for (const Edge &e : edges)
+        if (e.required) out.requiredCost += e.weight;
+    for (int eid : out.route.edgeOrder) out.cost += edges[eid].weight;
+    if (out.requiredCost > 0.0 && !out.route.edgeOrder.empty()) out.gap = out.cost / out.requiredCost - 1.0;
+    return out;
+}
+
+void RuralPostman::solveInto(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                             ChinesePostmanResult &result) {
+    RuralWorkspace &ws = ctx.postman.rural;
+    const auto &edges = g.getEdges();
+    const int n = static_cast<int>(g.getVertices().size());
+    if (edges.empty()) return;
+
+    auto report = [&options](const char *phase, int done, int total) {
+        if (options.progress) options.progress(phase, done, total);
+    };
+    auto cancelled = [&options, &result]() {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed))
+            result.cancelled = true;
+        return result.cancelled;
+    };
+    const auto start = Clock::now();
+    auto last = start;
+    auto mark = [&](const char *name) -> PhaseStats & {
+        const auto now = Clock::now();
+        PhaseStats p;
+        p.name = name;
+        p.startMs = ms(start, last);
+        p.wallMs = ms(last, now);
+        result.stats.phases.push_back(p);
+        result.stats.totalMs = ms(start, now);
+        last = now;
+        return result.stats.phases.back();
+    };
+
+    // --- B1 + B2. Các mảnh bắt buộc, nối bằng đường ngắn nhất ---
+    report("required", 0, 1);
+    CsrAdjacency &csr = ctx.postman.csr;
+    csr.assign(edges, n);
+    const int pieces = findPieces(ctx, g);
+    mark("required").peakBytes = bytesOf(ws.cell) + bytesOf(ws.queue);
+    if (pieces == 0) return;  // không có cạnh nào bắt buộc
+    report("connect", 0, 1);
+    PhaseStats connect;
+    const bool joined = connectPieces(ctx, g, pieces, connect);
+    PhaseStats &cp = mark("connect");
+    cp.heapPushes = connect.heapPushes;
+    cp.heapPops = connect.heapPops;
+    cp.edgesRelaxed = connect.edgesRelaxed;
+    cp.peakBytes = connect.peakBytes;
+    if (!joined) return;  // các cạnh bắt buộc không cùng một vùng liên thông
+    result.stats.requiredParts = pieces;
+    for (std::size_t i = 0; i < edges.size(); ++i)
+        result.stats.connectorEdges += ws.inStructure[i] && !edges[i].required;
+    if (cancelled()) return;
+
+    // --- B3. Đỉnh bậc lẻ của cấu trúc (cạnh bắt buộc + cạnh nối) ---
+    report("odd_vertices", 0, 1);
+    std::vector<int> &oddIndex = ws.oddIndex;
+    oddIndex.assign(n, 0);
+    for (std::size_t i = 0; i < edges.size(); ++i)
+        if (edges[i].required || ws.inStructure[i]) {
+            oddIndex[edges[i].u] ^= 1;
+            oddIndex[edges[i].v] ^= 1;
+        }
+    std::vector<int> &odd = ws.oddVertices;
+    odd.clear();
+    for (int v = 0; v < n; ++v) {
+        if (oddIndex[v]) {
+            oddIndex[v] = static_cast<int>(odd.size());
+            odd.push_back(v);
+        } else {
+            oddIndex[v] = -1;
+        }
+    }
+    const int k = static_cast<int>(odd.size());
+    result.stats.oddVertices = k;
+    mark("odd_vertices").peakBytes = bytesOf(oddIndex) + bytesOf(odd);
+
+    // --- B4. Khoảng cách (trên toàn mạng đường) và ghép đôi ---
+    // Each odd vertex searches outward only until it has settled its
+    // kNearest nearest odd vertices: the matching almost always pairs
+    // neighbours, so the rows stay sparse and every search stays local.
+    // Should that leave no perfect matching, the searches run again
+    // unbounded.
+    constexpr int kNearest = 16;
+    ParallelExecutor executor(options.threads);
+    result.stats.threads = executor.workerCount();
+    if (ws.searches.size() < executor.workerCount()) ws.searches.resize(executor.workerCount());
+    std::vector<double> &dist = ws.distances;
+    std::vector<int> &mate = ws.mate;
+    mate.clear();
+    for (int nearest = std::min(kNearest, k - 1); k > 0;) {
+        report("shortest_paths", 0, k);
+        dist.assign(static_cast<std::size_t>(k) * k, kInfinity);
+        for (RuralSearch &s : ws.searches) s.paths.pushes = s.paths.pops = s.paths.relaxed = 0;
+        std::atomic<int> sourcesDone{0};
+        executor.parallelFor(k, [&](int i, unsigned worker) {
+            if (options.cancel && options.cancel->load(std::memory_order_relaxed)) return;
+            double *row = &dist[static_cast<std::size_t>(i) * k];
+            int found = 0;
+            boundedSearch(csr, odd[i], ws.searches[worker], [&](int v, double d) {
+                const int j = oddIndex[v];
+                if (j < 0 || j == i) return false;
+                row[j] = d;
+                return ++found >= nearest;
+            });
+            const int done = ++sourcesDone;
+            if (done * 20 / k != (done - 1) * 20 / k) report("shortest_paths", done, k);
+        });
+        // A pair found from one side only is still a pair
+        for (int i = 0; i < k; ++i)
+            for (int j = i + 1; j < k; ++j) {
+                double &a = dist[static_cast<std::size_t>(i) * k + j];
+                double &b = dist[static_cast<std::size_t>(j) * k + i];
+                a = b = std::min(a, b);
+            }
+        PhaseStats &sp = mark("shortest_paths");
+        for (const RuralSearch &s : ws.searches) {
+            sp.heapPushes += s.paths.pushes;
+            sp.heapPops += s.paths.pops;
+            sp.edgesRelaxed += s.paths.relaxed;
+            sp.peakBytes += s.paths.bytes() + bytesOf(s.touched);
+        }
+        sp.peakBytes += bytesOf(dist);
+        if (cancelled()) return;
+
+        report("matching", 0, 1);
+        const bool matched = MinWeightMatching::solve(dist, k, mate, ws.matching, kInfinity, options.cancel);
+        mark("matching").peakBytes = bytesOf(dist) + bytesOf(mate);
+        if (cancelled()) return;
+        if (matched) {
+            result.stats.matchingCost = MinWeightMatching::matchingCost(dist, k, mate);
+            break;
+        }
+        if (nearest >= k - 1) return;
+        nearest = k - 1;
+    }
+
+    // --- B5. Mở rộng các đường ghép thành lượt đi thêm ---
+    report("augment", 0, 1);
+    ws.pathEdges.clear();
+    RuralSearch &path = ws.searches[0];
+    for (int i = 0; i < k; ++i) {
+        const int target = odd[mate[i]];
+        if (mate[i] < i) continue;
+        boundedSearch(csr, odd[i], path, [target](int v, double) { return v == target; });
+        for (int v = target; v != odd[i];) {
+            const int eid = path.paths.parentEdge[v];
+            ws.pathEdges.push_back(eid);
+            v = edges[eid].u == v ? edges[eid].v : edges[eid].u;
+        }
+    }
+    mark("augment").peakBytes = path.paths.bytes() + bytesOf(ws.pathEdges);
+
+    // --- B6. Euler trên các cạnh được đi (đồ thị gọn + overlay) ---
+    report("euler", 0, 1);
+    Graph &tour = ws.tour;
+    tour.clear();
+    ws.tourVertex.assign(n, -1);
+    ws.tourEdge.assign(edges.size(), -1);
+    ws.originalEdge.clear();
+    auto local = [&](int v) {
+        if (ws.tourVertex[v] < 0) ws.tourVertex[v] = tour.addVertex(g.getVertices()[v].position);
+        return ws.tourVertex[v];
+    };
+    auto drive = [&](int eid) {
+        if (ws.tourEdge[eid] >= 0) return;
+        const int u = local(edges[eid].u);
+        ws.tourEdge[eid] = tour.addEdge(u, local(edges[eid].v), edges[eid].weight);
+        ws.originalEdge.push_back(eid);
+    };
+    for (std::size_t i = 0; i < edges.size(); ++i)
+        if (edges[i].required || ws.inStructure[i]) drive(static_cast<int>(i));
+    for (int eid : ws.pathEdges) drive(eid);
+    // A matched path over a street already driven repeats it
+    AugmentedGraph &augmented = ctx.postman.augmented;
+    augmented.reset(tour);
+    for (int eid : ws.pathEdges) {
+        char &driven = ws.inStructure[eid];
+        if (driven || edges[eid].required) {
+            augmented.duplicate(ws.tourEdge[eid]);
+            result.duplicateEdgeIds.push_back(eid);
+        }
+        driven = 1;
+    }
+    csr.assign(tour.getEdges(), static_cast<int>(tour.getVertices().size()));
+    if (!Algorithms::findEulerTourHierholzer(ctx, augmented, csr, result.edgeOrder, result.isCycle)) {
+        result.edgeOrder.clear();
+        result.duplicateEdgeIds.clear();
+    }
+    for (int &eid : result.edgeOrder) eid = ws.originalEdge[eid];
+    mark("euler").peakBytes = bytesOf(ws.tourVertex) + bytesOf(ws.tourEdge) + bytesOf(ws.originalEdge)
+        + bytesOf(csr.offsets) + bytesOf(csr.neighbors) + bytesOf(csr.edgeIds) + bytesOf(result.edgeOrder);
+}
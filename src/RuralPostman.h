@@ -0,0 +1,64 @@
+#pragma once
+#include "Graph.h"
+#include "ChinesePostman.h"
+#include "SolverContext.h"
+#include "SolverStats.h"
+
+/* ============================================================
+   RuralPostman — cover only the required streets
+   ------------------------------------------------------------
+   A shift often has to inspect a few streets (Edge::required)
+   and may drive any other street to get between them. Finding
+   the cheapest such tour is NP-hard; this is the Frederickson
+   construction, with the street network kept sparse:
+     B1. Pieces: the connected components of the required
+         streets alone (BFS over them).
+     B2. Connect: one Dijkstra from every vertex of a required
+         street at once splits the city into cells, each vertex
+         labelled with its nearest piece. A street joining two
+         cells is a link of cost d(u) + w + d(v); Kruskal over
+         the links joins all pieces, every chosen link adding
+         its shortest path (the connectors) — a spanning
+         structure over shortest paths in O((V + E) log V),
+         without the all-pairs table between pieces.
+     B3. Odd vertices of that structure (required streets +
+         connectors) only — not of the whole city.
+     B4. Their pairwise distances over all streets, each from a
+         Dijkstra that stops once it has settled its 16 nearest
+         odd vertices (unbounded again only if that leaves no
+         perfect matching), then the blossom matching on them.
+     B5. Each matched pair's path is driven once more.
+     B6. Hierholzer over the streets driven (a compact graph
+         with the repeats as an AugmentedGraph overlay).
+   The route is reported in the ids of g. Its cost is at least
+   the weight of the required streets, the bound reported by
+   solve(). DistrictPostman (one district) and MultiRoutePostman
+   (the giant tour) cover the required streets the same way, and
+   ShiftSplitter cuts whatever tour it is given.
+   ============================================================ */
+
+struct RuralPostmanResult {
+    // Empty when the required streets are not all in one connected
+    // part of the city, when no street is required, or when some
+    // street is one-way (not supported together, see MixedPostman)
+    ChinesePostmanResult route;
+    double cost{0.0};
+    double requiredCost{0.0};     // weight of the required streets: no tour is cheaper
+    double gap{0.0};              // cost / requiredCost − 1 (the deadheading)
+};
+
+class RuralPostman {
+public:
+    // Phases "required", "connect", "odd_vertices", "shortest_paths",
+    // "matching", "augment", "euler" (progress and route.stats);
+    // route.stats also counts the pieces joined and the connectors.
+    // options.threads applies to B4; hierarchy, dense and
+    // contractChains do not apply.
+    static RuralPostmanResult solve(SolverContext &ctx, const Graph &g,
+                                    const ChinesePostmanOptions &options = {});
+    // Route only, into a result the caller has reset; what
+    // ChinesePostmanOptimal::solveInto runs for a graph with optional
+    // streets
+    static void solveInto(SolverContext &ctx, const Graph &g, const ChinesePostmanOptions &options,
+                          ChinesePostmanResult &result);
+};
@@ -0,0 +1,104 @@
+#include "ShiftSplitter.h"
+#include "Algorithms.h"
+#include "ShortestPaths.h"
+#include <algorithm>
+#include <limits>
+
+/* ============================================================
+   Hàm split() — cắt tour thành các ca trực
+   ============================================================ */
+ShiftPlan ShiftSplitter::split(SolverContext &ctx, const Graph &g, const std::vector<int> &edgeOrder,
+                               const ShiftOptions &options) {
+    ShiftPlan plan;
+    const auto &edges = g.getEdges();
+    const int n = static_cast<int>(g.getVertices().size());
+    const int depot = options.depot;
+    const int m = static_cast<int>(edgeOrder.size());
+    if (depot < 0 || depot >= n || g.hasDirectedEdges()) return plan;
+    if (m == 0) {
+        plan.feasible = true;
+        return plan;
+    }
+
+    // --- B1. Khoảng cách và đường về trạm (một Dijkstra) ---
+    PostmanWorkspace &ws = ctx.postman;
+    ws.csr.assign(edges, n);
+    if (ctx.dijkstra.empty()) ctx.dijkstra.resize(1);
+    DijkstraScratch &fromDepot = ctx.dijkstra[0];
+    ShortestPaths::dijkstra(ws.csr, depot, fromDepot);
+    const std::vector<double> &dist = fromDepot.dist;
+    const std::vector<int> &parentEdge = fromDepot.parentEdge;
+
+    // --- B2. Dãy đỉnh, tổng tiền tố, kiểm tra từng cạnh ---
+    const int first = Algorithms::walkStart(edges, edgeOrder);
+    if (first < 0) return plan;
+    std::vector<int> walk(m + 1, first);
+    for (int i = 0; i < m; ++i) {
+        const Edge &e = edges[edgeOrder[i]];
+        walk[i + 1] = e.u == walk[i] ? e.v : e.u;
+    }
+    const double inf = std::numeric_limits<double>::infinity();
+    const double limit = options.maxShiftCost;
+    // Distances come out of a Dijkstra, so d(i) − pre[i] may creep up by
+    // rounding; the window test allows for that much
+    const double slack = 1e-9 * std::max(1.0, limit);
+    std::vector<double> pre(m + 1, 0.0), home(m + 1);
+    for (int i = 0; i <= m; ++i) {
+        home[i] = dist[walk[i]] == ShortestPaths::unreachable<double>() ? inf : dist[walk[i]];
+        if (i < m) pre[i + 1] = pre[i] + edges[edgeOrder[i]].weight;
+    }
+    for (int i = 0; i < m; ++i)
+        if (home[i] + edges[edgeOrder[i]].weight + home[i + 1] > limit + slack) {
+            plan.blockingPosition = i;
+            return plan;
+        }
+
+    // --- B3. Split tối ưu: cửa sổ trượt + hàng đợi đơn điệu ---
+    std::vector<double> best(m + 1, inf);
+    std::vector<int> from(m + 1, -1);
+    std::vector<int> window(m + 1);   // deque of candidate i, A(i) increasing
+    int head = 0, tail = 0, lo = 0;
+    auto cost = [&](int i) { return best[i] + home[i] - pre[i]; };
+    best[0] = 0.0;
+    for (int j = 1; j <= m; ++j) {
+        // i = j − 1 enters the window
+        const int enter = j - 1;
+        if (best[enter] < inf) {
+            while (tail > head && cost(window[tail - 1]) >= cost(enter)) --tail;
+            window[tail++] = enter;
+        }
+        // Drop the i whose way out + piece + way back exceeds the limit
+        const double room = limit - pre[j] - home[j] + slack;
+        while (lo < j && home[lo] - pre[lo] > room) ++lo;
+        while (tail > head && window[head] < lo) ++head;
+        if (tail > head) {
+            from[j] = window[head];
+            best[j] = cost(window[head]) + pre[j] + home[j];
+        }
+    }
+    if (best[m] == inf) return plan;
+
+    // --- B4. Dựng các ca từ cuối về đầu ---
+    std::vector<int> cuts{m};
+    for (int j = m; j > 0; j = from[j]) cuts.push_back(from[j]);
+    std::reverse(cuts.begin(), cuts.end());
+    auto other = [&edges](int eid, int v) { return edges[eid].u == v ? edges[eid].v : edges[eid].u; };
+    plan.shifts.resize(cuts.size() - 1);
+    for (size_t s = 0; s + 1 < cuts.size(); ++s) {
+        Shift &shift = plan.shifts[s];
+        shift.begin = cuts[s];
+        shift.end = cuts[s + 1];
+        for (int v = walk[shift.begin]; v != depot; v = other(parentEdge[v], v))
+            shift.edgeOrder.push_back(parentEdge[v]);
+        std::reverse(shift.edgeOrder.begin(), shift.edgeOrder.end());
+        shift.edgeOrder.insert(shift.edgeOrder.end(), edgeOrder.begin() + shift.begin, edgeOrder.begin() + shift.end);
+        for (int v = walk[shift.end]; v != depot; v = other(parentEdge[v], v))
+            shift.edgeOrder.push_back(parentEdge[v]);
+        shift.deadhead = home[shift.begin] + home[shift.end];
+        shift.cost = shift.deadhead + pre[shift.end] - pre[shift.begin];
+        plan.totalCost += shift.cost;
+        plan.deadheadCost += shift.deadhead;
+    }
+    plan.feasible = true;
+    return plan;
+}
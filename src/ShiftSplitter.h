@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include "Graph.h"
+#include "SolverContext.h"
+
+/* ============================================================
+   ShiftSplitter — one tour, cut into shift-length patrols
+   ------------------------------------------------------------
+   A postman tour (ChinesePostmanOptimal, approximateChinese-
+   Postman, ...) is one walk however long the district. Officers
+   work shifts of bounded cost, each leaving from and returning
+   to the station. Every shift serves a consecutive piece
+   [i, j) of the tour and deadheads depot → vertex i and
+   vertex j → depot along shortest paths:
+       cost(i, j) = d(i) + (pre[j] − pre[i]) + d(j) ≤ maxShiftCost
+   Optimal split (Beasley's route-first, cluster-second DP),
+   minimising the total cost (service + deadhead) over all cuts:
+       P[j] = min over feasible i of P[i] + cost(i, j)
+   In linear time: cost(i, j) = A(i) + pre[j] + d(j) with
+   A(i) = P[i] + d(i) − pre[i], and by the triangle inequality
+   d(i) − pre[i] never grows along the tour, so the feasible i
+   for j form a window [lo(j), j) whose left end only moves
+   right. A monotone deque keeps the window's minimum A(i)
+   (Vidal's O(n) Split), so the tour is read once, plus one
+   Dijkstra from the depot for the deadhead distances and paths.
+   No re-solve of the postman itself.
+   ============================================================ */
+
+struct ShiftOptions {
+    double maxShiftCost{0.0};
+    int depot{0};                 // station every shift leaves from and returns to
+};
+
+struct Shift {
+    int begin{0};                 // tour positions [begin, end) served by this shift
+    int end{0};
+    std::vector<int> edgeOrder;   // depot → begin, the piece, end → depot (edge ids)
+    double cost{0.0};
+    double deadhead{0.0};         // of which to and from the depot
+};
+
+struct ShiftPlan {
+    std::vector<Shift> shifts;
+    // False when a single street of the tour cannot be served within
+    // maxShiftCost (its round trip from the depot is longer), the
+    // depot is not connected to the tour, or edgeOrder is not a walk;
+    // always for a graph with one-way streets (the deadhead paths would
+    // drive them backwards)
+    bool feasible{false};
+    int blockingPosition{-1};     // first such tour position
+    double totalCost{0.0};
+    double deadheadCost{0.0};
+};
+
+class ShiftSplitter {
+public:
+    // edgeOrder is a walk of g (edge ids); it does not need to start at
+    // the depot. Scratch (CSR, the depot Dijkstra) comes from ctx.
+    static ShiftPlan split(SolverContext &ctx, const Graph &g, const std::vector<int> &edgeOrder,
+                           const ShiftOptions &options);
+};
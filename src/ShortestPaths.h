@@ -0,0 +1,281 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+/* ============================================================
+   ShortestPaths — single-source Dijkstra templated on weight
+   ------------------------------------------------------------
+   The queue is picked at compile time from the weight type:
+     - floating point W: binary heap of (dist, vertex), lazy
+       deletion (16-byte entries for double);
+     - unsigned integral W: monotone radix heap. Dijkstra only
+       ever pops keys >= the last popped key, so entries live in
+       log2(C) + 1 buckets by the highest bit that differs from
+       that key; each entry moves to a lower bucket at most
+       log2(C) times. 8-byte entries for std::uint32_t.
+   Street weights are usually whole meters or seconds; callers
+   check hasIntegerWeights() and then run on a CSR with
+   IntegerWeight weights, falling back to double otherwise.
+   ============================================================ */
+namespace ShortestPaths {
+
+// Whole-number weights whose grand total fits in IntegerWeight, so
+// no path length (and no d[u] + w) can overflow
+using IntegerWeight = std::uint32_t;
+
+inline bool hasIntegerWeights(const std::vector<Edge> &edges) {
+    const double limit = static_cast<double>(std::numeric_limits<IntegerWeight>::max() - 1);
+    double total = 0.0;
+    for (const auto &e : edges) {
+        if (!(e.weight >= 0.0) || e.weight != std::floor(e.weight)) return false;
+        total += e.weight;
+        if (total > limit) return false;
+    }
+    return true;
+}
+
+// Distance of vertices the search did not reach
+template <typename W>
+constexpr W unreachable() {
+    return std::numeric_limits<W>::has_infinity ? std::numeric_limits<W>::infinity()
+                                                : std::numeric_limits<W>::max();
+}
+
+inline int bitWidth(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? 64 - __builtin_clzll(x) : 0;
+#else
+    int width = 0;
+    for (; x; x >>= 1) ++width;
+    return width;
+#endif
+}
+
+// -----------------------------
+// BINARY HEAP (any weight)
+// -----------------------------
+template <typename W>
+class BinaryHeap {
+public:
+    using Entry = std::pair<W, int>;
+
+    void clear() { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    void push(W key, int v) {
+        heap.push_back({key, v});
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+    Entry pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        Entry top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+    std::size_t bytes() const { return heap.capacity() * sizeof(Entry); }
+
+private:
+    std::vector<Entry> heap;
+};
+
+// -----------------------------
+// RADIX HEAP (unsigned integral weight, monotone pops)
+// -----------------------------
+template <typename W>
+class RadixHeap {
+    static_assert(std::is_unsigned<W>::value, "RadixHeap keys must be unsigned");
+
+public:
+    using Entry = std::pair<W, int>;
+
+    void clear() {
+        for (auto &bucket : buckets) bucket.clear();
+        last = 0;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    // key must be >= the last popped key
+    void push(W key, int v) {
+        buckets[bucketOf(key)].push_back({key, v});
+        ++count;
+    }
+    Entry pop() {
+        if (buckets[0].empty()) {
+            // Smallest non-empty bucket: its minimum becomes the new
+            // reference key and every entry drops to a lower bucket
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            auto &from = buckets[i];
+            W minKey = from[0].first;
+            for (const auto &e : from) minKey = std::min(minKey, e.first);
+            last = minKey;
+            for (const auto &e : from) buckets[bucketOf(e.first)].push_back(e);
+            from.clear();
+        }
+        Entry top = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return top;
+    }
+    std::size_t bytes() const {
+        std::size_t total = 0;
+        for (const auto &bucket : buckets) total += bucket.capacity() * sizeof(Entry);
+        return total;
+    }
+
+private:
+    int bucketOf(W key) const { return bitWidth(static_cast<std::uint64_t>(key ^ last)); }
+
+    std::array<std::vector<Entry>, std::numeric_limits<W>::digits + 1> buckets;
+    W last{0};
+    std::size_t count{0};
+};
+
+template <typename W>
+using Queue = typename std::conditional<std::is_integral<W>::value, RadixHeap<W>, BinaryHeap<W>>::type;
+
+}
+
+// Scratch of one Dijkstra worker, reused across sources and solves
+template <typename W>
+struct BasicDijkstraScratch {
+    std::vector<W> dist;
+    std::vector<int> parentEdge;   // edge id of the tree edge into v, -1 at the root
+    ShortestPaths::Queue<W> queue;
+    // Instrumentation, summed into SolverStats after the phase
+    std::int64_t pushes{0}, pops{0}, relaxed{0};
+
+    std::size_t bytes() const {
+        return dist.capacity() * sizeof(W) + parentEdge.capacity() * sizeof(int) + queue.bytes();
+    }
+};
+
+using DijkstraScratch = BasicDijkstraScratch<double>;
+using IntegerDijkstraScratch = BasicDijkstraScratch<ShortestPaths::IntegerWeight>;
+
+namespace ShortestPaths {
+
+// Dijkstra from `source` over `csr`; fills buf.dist and buf.parentEdge
+// for every vertex. With target >= 0 the search stops once target is
+// settled (only its path is then final).
+template <typename W>
+void dijkstra(const BasicCsrAdjacency<W> &csr, int source, BasicDijkstraScratch<W> &buf, int target = -1) {
+    buf.dist.assign(csr.vertexCount(), unreachable<W>());
+    buf.parentEdge.assign(csr.vertexCount(), -1);
+    buf.queue.clear();
+    auto &d = buf.dist;
+    auto &queue = buf.queue;
+    std::int64_t pushes = 1, pops = 0, relaxed = 0;
+
+    d[source] = 0;
+    queue.push(0, source);
+    while (!queue.empty()) {
+        auto [du, u] = queue.pop();
+        ++pops;
+        if (du != d[u]) continue;
+        if (u == target) break;
+        relaxed += csr.end(u) - csr.begin(u);
+        for (int s = csr.begin(u); s < csr.end(u); ++s) {
+            int v = csr.neighbors[s];
+            W nd = du + csr.weights[s];
+            if (nd < d[v]) {
+                d[v] = nd;
+                buf.parentEdge[v] = csr.edgeIds[s];
+                queue.push(nd, v);
+                ++pushes;
+            }
+        }
+    }
+    buf.pushes += pushes;
+    buf.pops += pops;
+    buf.relaxed += relaxed;
+}
+
+// -----------------------------
+// VERSION-STAMPED SEARCH STATE
+// -----------------------------
+// For many searches on one graph: a vertex's dist/parentEdge are only
+// valid when stamp[v] == version, so starting a search is O(1) (bump
+// the version) instead of refilling V entries. Stamps are cleared
+// only when the version counter wraps.
+template <typename W>
+struct StampedSearch {
+    std::vector<W> dist;
+    std::vector<int> parentEdge;
+    std::vector<std::uint32_t> stamp;
+    std::uint32_t version{0};
+    Queue<W> queue;
+    std::int64_t pushes{0}, pops{0}, relaxed{0}, settled{0};
+
+    void begin(int vertexCount) {
+        if (static_cast<int>(stamp.size()) != vertexCount) {
+            dist.resize(vertexCount);
+            parentEdge.resize(vertexCount);
+            stamp.assign(vertexCount, 0);
+            version = 0;
+        }
+        if (++version == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            version = 1;
+        }
+        queue.clear();
+    }
+    bool reached(int v) const { return stamp[v] == version; }
+    W distance(int v) const { return reached(v) ? dist[v] : unreachable<W>(); }
+    int parent(int v) const { return reached(v) ? parentEdge[v] : -1; }
+
+    std::size_t bytes() const {
+        return dist.capacity() * sizeof(W) + parentEdge.capacity() * sizeof(int)
+             + stamp.capacity() * sizeof(std::uint32_t) + queue.bytes();
+    }
+};
+
+// Dijkstra from `source` that stops once `targetCount` distinct vertices
+// with isTarget(v) have been settled (targetCount <= 0: full search).
+// Paths to settled targets are final in search.parentEdge.
+template <typename W, typename IsTarget>
+void dijkstra(const BasicCsrAdjacency<W> &csr, int source, StampedSearch<W> &search,
+              int targetCount, const IsTarget &isTarget) {
+    search.begin(csr.vertexCount());
+    auto &queue = search.queue;
+    std::int64_t pushes = 1, pops = 0, relaxed = 0, settled = 0;
+    int remaining = targetCount;
+
+    search.stamp[source] = search.version;
+    search.dist[source] = 0;
+    search.parentEdge[source] = -1;
+    queue.push(0, source);
+    while (!queue.empty()) {
+        auto [du, u] = queue.pop();
+        ++pops;
+        if (du != search.dist[u]) continue;
+        ++settled;
+        if (isTarget(u) && --remaining == 0) break;
+        relaxed += csr.end(u) - csr.begin(u);
+        for (int s = csr.begin(u); s < csr.end(u); ++s) {
+            int v = csr.neighbors[s];
+            W nd = du + csr.weights[s];
+            if (!search.reached(v) || nd < search.dist[v]) {
+                search.stamp[v] = search.version;
+                search.dist[v] = nd;
+                search.parentEdge[v] = csr.edgeIds[s];
+                queue.push(nd, v);
+                ++pushes;
+            }
+        }
+    }
+    search.pushes += pushes;
+    search.pops += pops;
+    search.relaxed += relaxed;
+    search.settled += settled;
+}
+
+}
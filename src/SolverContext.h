@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "AugmentedGraph.h"
+#include "ChainContraction.h"
+#include "ContractionHierarchy.h"
+#include "DenseGraph.h"
+#include "Graph.h"
+#include "MinCostFlow.h"
+#include "MinWeightMatching.h"
+#include "ShortestPaths.h"
+#include "SolverStats.h"
+
+struct EulerResult {
+    std::vector<int> edgeOrder;
+    bool isCycle{false};
+    std::vector<int> vertexOrder;  // Thêm để lưu thứ tự đỉnh
+};
+
+// Scratch of the iterative Hierholzer walk
+struct EulerScratch {
+    std::vector<int> degree;
+    std::vector<int> copies;       // traversals left per edge id
+    std::vector<int> cursor;       // next CSR slot to try per vertex
+    std::vector<int> vertexStack;
+    std::vector<int> edgeStack;
+    std::vector<char> visited;     // connectivity BFS
+    std::vector<int> bfsQueue;
+    // Directed walk: CSR of the arcs by tail
+    std::vector<int> arcOffsets;
+    std::vector<int> arcSlots;
+};
+
+struct SolverContext;
+
+// Buffers of the directed / mixed postman (MixedPostman.h)
+struct MixedWorkspace {
+    MinCostFlow flow;
+    std::vector<int> balance;       // in − out over the one-way streets
+    std::vector<int> firstArc;      // per edge, its first flow arc (-1: none)
+    std::vector<int> parityEdges;   // two-way streets the flow left unoriented
+    Graph parityGraph;
+    // Private context of the undirected solve of parityGraph (a vector
+    // because SolverContext is incomplete here)
+    std::vector<SolverContext> parity;
+    std::vector<int> walk;
+    // One entry per traversal, for the directed Euler walk
+    std::vector<int> arcFrom, arcTo, arcEdge;
+};
+
+// One bounded Dijkstra of the rural postman; dist is +inf and
+// parentEdge -1 everywhere except on `touched`
+struct RuralSearch {
+    DijkstraScratch paths;
+    std::vector<int> touched;
+};
+
+// Buffers of the rural postman (RuralPostman.h)
+struct RuralWorkspace {
+    std::vector<int> cell;          // per vertex: nearest piece of required streets (-1: none)
+    std::vector<int> queue;         // BFS over the required streets
+    DijkstraScratch search;         // from every vertex of a required street at once
+    std::vector<std::pair<double, int>> links;  // (cost, edge) joining two cells
+    std::vector<char> inStructure;  // per edge: connector
+    std::vector<int> oddVertices;   // odd in the structure
+    std::vector<int> oddIndex;      // per vertex: position in oddVertices (-1: even)
+    std::vector<double> distances;  // odd × odd, row-major, +inf where not searched
+    std::vector<RuralSearch> searches;  // one per executor worker
+    std::vector<int> mate;
+    MinWeightMatching::Workspace matching;
+    std::vector<int> pathEdges;     // traversals of the matched paths
+    // Every street driven, compact, with the ids back to g
+    Graph tour;
+    std::vector<int> tourVertex, tourEdge, originalEdge;
+};
+
+// Buffers of the postman pipeline (B1..B6), sized by the largest
+// district solved so far and never shrunk
+struct PostmanWorkspace {
+    CsrAdjacency csr;
+    // Used instead of csr when every weight is a whole number
+    BasicCsrAdjacency<ShortestPaths::IntegerWeight> integerCsr;
+    std::vector<int> oddVertices;
+    std::vector<double> distances;              // odd × odd, row-major
+    std::vector<std::vector<int>> parentEdge;   // one tree per odd source
+    std::vector<int> pathEdges;                 // one unpacked hierarchy / dense path (B5)
+    DenseGraph::Workspace dense;                // all-pairs of the dense mode
+    std::vector<int> mate;
+    MinWeightMatching::Workspace matching;
+    AugmentedGraph augmented;
+    // Chain contraction (ChinesePostmanOptions::contractChains)
+    ChainContraction chains;
+    std::vector<int> expanded;
+    MixedWorkspace mixed;
+    RuralWorkspace rural;
+};
+
+/* ============================================================
+   SolverContext — everything one solve mutates
+   ------------------------------------------------------------
+   Results, statistics and scratch buffers live here instead of
+   in process-wide globals, and every stateful Algorithms /
+   ChinesePostmanOptimal call takes the context explicitly. A
+   context must not be shared by two solves running at the same
+   time; give each thread (or each batch worker) its own, and
+   any number of solves can run in parallel.
+
+   Scratch is only ever cleared, never released, so a context
+   reused for repeated solves (what-if loops) stops touching the
+   heap after the first solve of the largest instance when the
+   solve is single-threaded (ChinesePostmanOptimal::solveInto
+   with threads = 1).
+   ============================================================ */
+struct SolverContext {
+    // Last results produced through this context
+    std::optional<EulerResult> lastEuler;
+    std::optional<EulerResult> lastPostman;
+    std::vector<int> highlightedEdges;  // Lưu các cạnh được tô màu
+    SolverStats stats;                  // stats of the last postman solve
+
+    // Scratch, kept between solves
+    EulerScratch euler;
+    std::vector<DijkstraScratch> dijkstra;  // one per executor worker
+    std::vector<IntegerDijkstraScratch> integerDijkstra;
+    std::vector<HierarchyScratch> hierarchy;  // one per executor worker
+    PostmanWorkspace postman;
+    // Contexts of the extra workers when several subproblems are solved
+    // at once (ComponentSolver, DistrictPostman); worker 0 uses this one
+    std::vector<SolverContext> workerContexts;
+
+    void clearResults() {
+        lastEuler.reset();
+        lastPostman.reset();
+    }
+};
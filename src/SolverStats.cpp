@@ -0,0 +1,69 @@
+#include "SolverStats.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+
+const PhaseStats* SolverStats::phase(const std::string &name) const {
+    for (const auto &p : phases)
+        if (p.name == name) return &p;
+    return nullptr;
+}
+
+std::size_t SolverStats::peakBytes() const {
+    std::size_t peak = 0;
+    for (const auto &p : phases) peak = std::max(peak, p.peakBytes);
+    return peak;
+}
+
+std::string SolverStats::summary() const {
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "%.1f ms | %d odd | matching %g", totalMs, oddVertices, matchingCost);
+    std::string text = buf;
+
+    // Name the slowest phase: that is where to look first
+    const PhaseStats *slowest = nullptr;
+    for (const auto &p : phases)
+        if (!slowest || p.wallMs > slowest->wallMs) slowest = &p;
+    if (slowest) {
+        std::snprintf(buf, sizeof(buf), " | %s %.1f ms", slowest->name.c_str(), slowest->wallMs);
+        text += buf;
+    }
+    return text;
+}
+
+void SolverStats::writeChromeTrace(std::ostream &out) const {
+    char num[64];
+    auto us = [&num](double ms) {
+        std::snprintf(num, sizeof(num), "%.3f", ms * 1000.0);
+        return std::string(num);
+    };
+
+    out << "{\"displayTimeUnit\": \"ms\",\n \"otherData\": {\"oddVertices\": " << oddVertices
+        << ", \"matchingCost\": " << matchingCost << ", \"threads\": " << threads
+        << ", \"integerWeights\": " << (integerWeights ? "true" : "false")
+        << ", \"hierarchy\": " << (hierarchy ? "true" : "false")
+        << ", \"dense\": " << (dense ? "true" : "false")
+        << ", \"chainVertices\": " << chainVertices
+        << ", \"requiredParts\": " << requiredParts
+        << ", \"connectorEdges\": " << connectorEdges << "},\n"
+        << " \"traceEvents\": [\n"
+        << "  {\"name\": \"solve\", \"cat\": \"postman\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1,"
+        << " \"ts\": 0, \"dur\": " << us(totalMs) << "}";
+    for (const auto &p : phases) {
+        out << ",\n  {\"name\": \"" << p.name << "\", \"cat\": \"postman\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1,"
+            << " \"ts\": " << us(p.startMs) << ", \"dur\": " << us(p.wallMs)
+            << ", \"args\": {\"heapPushes\": " << p.heapPushes
+            << ", \"heapPops\": " << p.heapPops
+            << ", \"edgesRelaxed\": " << p.edgesRelaxed
+            << ", \"peakBytes\": " << p.peakBytes << "}}";
+    }
+    out << "\n ]}\n";
+}
+
+bool SolverStats::writeChromeTrace(const std::string &filePath) const {
+    std::ofstream out(filePath);
+    if (!out) return false;
+    writeChromeTrace(out);
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/* ============================================================
+   SolverStats — per-phase instrumentation of one solve
+   ------------------------------------------------------------
+   Filled on every ChinesePostmanOptimal::solve() call. Counters
+   are plain integers kept in the per-worker scratch buffers and
+   summed once per phase, so the hot loops pay one increment and
+   no synchronisation. peakBytes is the largest footprint of the
+   solver's own working buffers (by capacity) during the phase.
+   ============================================================ */
+struct PhaseStats {
+    std::string name;
+    double startMs{0.0};        // offset from the start of the solve
+    double wallMs{0.0};
+    std::int64_t heapPushes{0};
+    std::int64_t heapPops{0};
+    std::int64_t edgesRelaxed{0};
+    std::size_t peakBytes{0};
+};
+
+struct SolverStats {
+    std::vector<PhaseStats> phases;
+    int oddVertices{0};
+    double matchingCost{0.0};
+    double totalMs{0.0};
+    unsigned threads{1};
+    bool integerWeights{false};  // shortest paths ran on the integer (radix heap) path
+    bool hierarchy{false};       // shortest paths were answered by a ContractionHierarchy
+    bool dense{false};           // shortest paths came from the dense-mode Floyd–Warshall
+    int chainVertices{0};        // degree-2 vertices removed by chain contraction
+    int requiredParts{0};        // rural postman: pieces of required streets joined
+    int connectorEdges{0};       // rural postman: optional streets added to join them
+
+    // nullptr when the phase did not run
+    const PhaseStats* phase(const std::string &name) const;
+    std::size_t peakBytes() const;
+
+    // One line for status bars, e.g.
+    // "12.4 ms | 38 odd | matching 412 | shortest_paths 9.1 ms"
+    std::string summary() const;
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto): one
+    // complete event per phase with the counters as args.
+    void writeChromeTrace(std::ostream &out) const;
+    bool writeChromeTrace(const std::string &filePath) const;
+};
@@ -0,0 +1,186 @@
+#include "SyntheticNetworks.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace {
+// splitmix64: tiny, fast and identical on every standard library
+class Rng {
+public:
+    explicit Rng(std::uint64_t seed) : state(seed) {}
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+    int below(int n) { return static_cast<int>(next() % static_cast<std::uint64_t>(n)); }
+private:
+    std::uint64_t state;
+};
+
+struct DisjointSets {
+    std::vector<int> parent;
+    explicit DisjointSets(int n) : parent(n) { std::iota(parent.begin(), parent.end(), 0); }
+    int find(int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    }
+    bool unite(int a, int b) {
+        a = find(a); b = find(b);
+        if (a == b) return false;
+        parent[a] = b;
+        return true;
+    }
+};
+
+double streetLength(const Graph &g, int u, int v) {
+    const Point2D &a = g.getVertices()[u].position;
+    const Point2D &b = g.getVertices()[v].position;
+    return std::max(1.0, std::ceil(std::hypot(a.x - b.x, a.y - b.y)));
+}
+
+void addStreet(Graph &g, int u, int v) {
+    g.addEdge(u, v, streetLength(g, u, v));
+}
+
+// Shuffled Kruskal picks the two-way tree; the streets it rejects are
+// the one-way candidates
+void makeOneWay(Graph &g, double rate, std::uint64_t seed) {
+    if (rate <= 0.0) return;
+    Rng rng(seed ^ 0x6F6E65776179ull);
+    auto &edges = g.getEdges();
+    std::vector<int> order(edges.size());
+    std::iota(order.begin(), order.end(), 0);
+    for (int i = static_cast<int>(order.size()) - 1; i > 0; --i)
+        std::swap(order[i], order[rng.below(i + 1)]);
+    DisjointSets sets(static_cast<int>(g.getVertices().size()));
+    for (int i : order) {
+        Edge &e = edges[i];
+        if (sets.unite(e.u, e.v) || rng.uniform() >= rate) continue;
+        if (rng.below(2)) std::swap(e.u, e.v);
+        e.directed = true;
+    }
+}
+
+void makeOptional(Graph &g, double requiredRate, std::uint64_t seed) {
+    if (requiredRate >= 1.0) return;
+    Rng rng(seed ^ 0x7265717569726564ull);
+    for (Edge &e : g.getEdges()) e.required = rng.uniform() < requiredRate;
+}
+}
+
+Graph SyntheticNetworks::grid(const Params &p) {
+    Rng rng(p.seed);
+    Graph g;
+    // k x k junctions give 2k(k-1) streets
+    const int k = std::max(2, static_cast<int>(std::ceil(std::sqrt(p.targetEdges / 2.0))) + 1);
+    const double spacing = 100.0;
+    for (int r = 0; r < k; ++r)
+        for (int c = 0; c < k; ++c)
+            g.addVertex(Point2D{c * spacing + (rng.uniform() - 0.5) * 20.0,
+                                r * spacing + (rng.uniform() - 0.5) * 20.0});
+
+    std::vector<std::pair<int, int>> streets;
+    for (int r = 0; r < k; ++r)
+        for (int c = 0; c < k; ++c) {
+            int v = r * k + c;
+            if (c + 1 < k) streets.push_back({v, v + 1});
+            if (r + 1 < k) streets.push_back({v, v + k});
+        }
+    for (int i = static_cast<int>(streets.size()) - 1; i > 0; --i)
+        std::swap(streets[i], streets[rng.below(i + 1)]);
+
+    // Random spanning tree first (shuffled Kruskal), then close a share
+    // of the remaining streets.
+    DisjointSets sets(k * k);
+    std::vector<bool> open(streets.size(), true);
+    for (size_t i = 0; i < streets.size(); ++i)
+        if (!sets.unite(streets[i].first, streets[i].second) && rng.uniform() < p.closureRate)
+            open[i] = false;
+
+    // Emit in row-major order so edge ids follow the street layout
+    std::vector<size_t> order(streets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return streets[a] < streets[b]; });
+    for (size_t i : order)
+        if (open[i]) addStreet(g, streets[i].first, streets[i].second);
+    return g;
+}
+
+Graph SyntheticNetworks::radial(const Params &p) {
+    Rng rng(p.seed);
+    Graph g;
+    const int spokes = 6;
+    // R rings hold 3R(R+1) junctions with ~2 streets each: ~6R^2 streets
+    const int rings = std::max(1, static_cast<int>(std::ceil(std::sqrt(p.targetEdges / 6.0))));
+    const double ringGap = 150.0;
+    const double pi = std::acos(-1.0);
+
+    g.addVertex(Point2D{0.0, 0.0});
+    int prevFirst = 0, prevCount = 1;
+    for (int r = 1; r <= rings; ++r) {
+        const int count = spokes * r;
+        const int first = static_cast<int>(g.getVertices().size());
+        const double phase = rng.uniform() * 2.0 * pi / count;
+        for (int i = 0; i < count; ++i) {
+            double angle = phase + 2.0 * pi * i / count;
+            double radius = r * ringGap + (rng.uniform() - 0.5) * 30.0;
+            g.addVertex(Point2D{radius * std::cos(angle), radius * std::sin(angle)});
+        }
+        for (int i = 0; i < count; ++i) {
+            // Link inward to the matching junction of the previous ring
+            addStreet(g, first + i, prevFirst + static_cast<int>(static_cast<long long>(i) * prevCount / count));
+            if (rng.uniform() >= p.closureRate)
+                addStreet(g, first + i, first + (i + 1) % count);
+        }
+        prevFirst = first;
+        prevCount = count;
+    }
+    return g;
+}
+
+Graph SyntheticNetworks::powerLaw(const Params &p) {
+    Rng rng(p.seed);
+    Graph g;
+    const int links = 2;
+    const int n = std::max(3, p.targetEdges / links + 1);
+    const double side = std::sqrt(static_cast<double>(n)) * 100.0;
+    for (int i = 0; i < n; ++i)
+        g.addVertex(Point2D{rng.uniform() * side, rng.uniform() * side});
+
+    // Each edge contributes both endpoints, so a uniform pick from this
+    // list is a degree-proportional pick.
+    std::vector<int> endpoints;
+    endpoints.reserve(static_cast<size_t>(n) * links * 2);
+    addStreet(g, 0, 1); addStreet(g, 1, 2); addStreet(g, 2, 0);
+    endpoints.insert(endpoints.end(), {0, 1, 1, 2, 2, 0});
+    for (int v = 3; v < n; ++v) {
+        int targets[links];
+        for (int l = 0; l < links; ++l) {
+            int t;
+            do { t = endpoints[rng.below(static_cast<int>(endpoints.size()))]; }
+            while (l > 0 && t == targets[0]);
+            targets[l] = t;
+        }
+        for (int t : targets) {
+            addStreet(g, v, t);
+            endpoints.push_back(v);
+            endpoints.push_back(t);
+        }
+    }
+    return g;
+}
+
+bool SyntheticNetworks::generate(const std::string &family, const Params &p, Graph &out) {
+    if (family == "grid") out = grid(p);
+    else if (family == "radial") out = radial(p);
+    else if (family == "powerlaw") out = powerLaw(p);
+    else return false;
+    makeOneWay(out, p.oneWayRate, p.seed);
+    makeOptional(out, p.requiredRate, p.seed);
+    return true;
+}
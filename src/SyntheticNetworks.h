@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Graph.h"
+
+/* ============================================================
+   Synthetic street networks for benchmarking
+   ------------------------------------------------------------
+   Deterministic for a given (family, targetEdges, seed) on every
+   platform: the generators use their own 64-bit PRNG instead of
+   <random> distributions, whose output is implementation
+   defined. Positions are in metres; each weight is the rounded
+   up length of its segment, so weights are whole numbers and
+   never shorter than the straight-line distance. Every network
+   is connected.
+   ============================================================ */
+namespace SyntheticNetworks {
+
+struct Params {
+    int targetEdges{1000};
+    double closureRate{0.02};   // share of closable streets removed
+    // Share of the streets off a random spanning tree made one-way (in
+    // a random direction); the tree stays two-way, so every one-way
+    // street has a way back and a postman tour always exists
+    double oneWayRate{0.0};
+    // Share of the streets marked required (Edge::required), picked
+    // at random; the others may be driven but need not be
+    double requiredRate{1.0};
+    std::uint64_t seed{1};
+};
+
+// Manhattan grid; closures only remove edges outside a random
+// spanning tree so the network stays connected.
+Graph grid(const Params &p);
+
+// Concentric rings around a centre (ring r has 6r junctions), each
+// junction linked to the ring inside it; closures hit ring arcs only.
+Graph radial(const Params &p);
+
+// Barabási–Albert preferential attachment (2 links per new vertex)
+// on random positions: a few hubs, many dead-ends, ~half odd degree.
+Graph powerLaw(const Params &p);
+
+// "grid" | "radial" | "powerlaw"; returns false for an unknown family.
+// Applies oneWayRate and requiredRate to the generated network.
+bool generate(const std::string &family, const Params &p, Graph &out);
+
+}